@@ -71,6 +71,11 @@ bool ProcessMemoryProvider::read(uint64_t addr, void* buf, int len) const
     return bytesRead > 0;
 }
 
+bool ProcessMemoryProvider::isReadable(uint64_t, int len) const
+{
+    return m_handle && len >= 0;
+}
+
 bool ProcessMemoryProvider::write(uint64_t addr, const void* buf, int len)
 {
     if (!m_handle || !m_writable || len <= 0) return false;
@@ -81,21 +86,6 @@ bool ProcessMemoryProvider::write(uint64_t addr, const void* buf, int len)
     return false;
 }
 
-QString ProcessMemoryProvider::getSymbol(uint64_t addr) const
-{
-    for (const auto& mod : m_modules)
-    {
-        if (addr >= mod.base && addr < mod.base + mod.size)
-        {
-            uint64_t offset = addr - mod.base;
-            return QStringLiteral("%1+0x%2")
-                .arg(mod.name)
-                .arg(offset, 0, 16, QChar('0'));
-        }
-    }
-    return {};
-}
-
 void ProcessMemoryProvider::cacheModules()
 {
     HMODULE mods[1024];
@@ -104,7 +94,8 @@ void ProcessMemoryProvider::cacheModules()
                               &needed, LIST_MODULES_ALL))
         return;
     int count = qMin((int)(needed / sizeof(HMODULE)), 1024);
-    m_modules.reserve(count);
+    QVector<rcx::SymbolIndex::Module> modules;
+    modules.reserve(count);
     for (int i = 0; i < count; ++i)
     {
         MODULEINFO mi{};
@@ -115,13 +106,15 @@ void ProcessMemoryProvider::cacheModules()
             if ( i == 0 )
                 m_base = (uint64_t)mi.lpBaseOfDll;
 
-            m_modules.append({
+            modules.append({
                 QString::fromWCharArray(modName),
                 (uint64_t)mi.lpBaseOfDll,
-                (uint64_t)mi.SizeOfImage
+                (uint64_t)mi.SizeOfImage,
+                {}      // PE images: module names only
             });
         }
     }
+    m_symbols = rcx::SymbolIndex::shared(m_pid, modules);
 }
 
 #elif defined(__linux__)
@@ -152,28 +145,146 @@ ProcessMemoryProvider::ProcessMemoryProvider(uint32_t pid, const QString& proces
 
 }
 
-bool ProcessMemoryProvider::read(uint64_t addr, void* buf, int len) const
+// Unmapped addresses fail here, without a syscall. Any mapping counts:
+// /proc/<pid>/mem reads pages the target itself may not. Without a region
+// map (maps unreadable) every address is tried.
+bool ProcessMemoryProvider::isReadable(uint64_t addr, int len) const
 {
-    if (m_fd < 0 || len <= 0) return false;
+    if (m_fd < 0 || len < 0) return false;
+    return mapped(addr, len, 0);
+}
 
-    // Try process_vm_readv first (faster, no fd seek contention)
-    struct iovec local;
-    local.iov_base = buf;
-    local.iov_len = static_cast<size_t>(len);
+bool ProcessMemoryProvider::mapped(uint64_t addr, int len, uint32_t perms) const
+{
+    auto map = regionMap();
+    if (map->isEmpty() || map->covers(addr, len, perms)) return true;
+    // The map may predate the mapping: look again with a fresher one
+    map = regionMap(kRegionMissRefreshMs);
+    return map->isEmpty() || map->covers(addr, len, perms);
+}
 
-    struct iovec remote;
-    remote.iov_base = reinterpret_cast<void*>(addr);
-    remote.iov_len = static_cast<size_t>(len);
+QVector<rcx::Provider::Region> ProcessMemoryProvider::regions() const
+{
+    return regionMap()->regions();
+}
 
-    ssize_t nread = process_vm_readv(m_pid, &local, 1, &remote, 1, 0);
-    if (nread == static_cast<ssize_t>(len))
-        return true;
+std::shared_ptr<const rcx::RegionMap> ProcessMemoryProvider::regionMap(int maxAgeMs) const
+{
+    QMutexLocker lock(&m_regionMutex);
+    if (m_regionMap && m_regionAge.isValid() && m_regionAge.elapsed() < maxAgeMs)
+        return m_regionMap;
+    m_regionAge.start();
+
+    QByteArray text;
+    QByteArray path = QStringLiteral("/proc/%1/maps").arg(m_pid).toUtf8();
+    int fd = ::open(path.constData(), O_RDONLY);
+    if (fd >= 0) {
+        char chunk[16384];
+        ssize_t n;
+        while ((n = ::read(fd, chunk, sizeof(chunk))) > 0)
+            text.append(chunk, static_cast<int>(n));
+        ::close(fd);
+    }
+    // Most refreshes find the same mappings: keep the parsed map
+    if (!m_regionMap || text != m_mapsText) {
+        m_regionMap = std::make_shared<const rcx::RegionMap>(rcx::RegionMap::parseProcMaps(text));
+        m_mapsText = std::move(text);
+    }
+    return m_regionMap;
+}
+
+bool ProcessMemoryProvider::read(uint64_t addr, void* buf, int len) const
+{
+    if (m_fd < 0 || len <= 0) return false;
+
+    // The map only picks the route, it never refuses a read: process_vm_readv
+    // (faster, no fd seek contention) where the target can read the pages
+    // itself, else straight to /proc/<pid>/mem, which can read the rest
+    auto map = regionMap();
+    if (map->isEmpty() || map->covers(addr, len)) {
+        struct iovec local;
+        local.iov_base = buf;
+        local.iov_len = static_cast<size_t>(len);
+
+        struct iovec remote;
+        remote.iov_base = reinterpret_cast<void*>(addr);
+        remote.iov_len = static_cast<size_t>(len);
+
+        ssize_t nread = process_vm_readv(m_pid, &local, 1, &remote, 1, 0);
+        if (nread == static_cast<ssize_t>(len))
+            return true;
+    }
 
     // Fallback: pread on /proc/<pid>/mem
-    nread = ::pread(m_fd, buf, static_cast<size_t>(len), static_cast<off_t>(addr));
+    ssize_t nread = ::pread(m_fd, buf, static_cast<size_t>(len), static_cast<off_t>(addr));
     return nread == static_cast<ssize_t>(len);
 }
 
+bool ProcessMemoryProvider::readBatch(ReadRequest* reqs, int count) const
+{
+    if (m_fd < 0) return Provider::readBatch(reqs, count);
+
+    // Ranges the map shows readable go to the kernel together; the rest
+    // (unmapped as far as the map knows, or not readable by the target)
+    // are tried one by one through read(), so a stale map costs a syscall,
+    // never a read
+    auto map = regionMap();
+    bool all = true;
+    QVector<int> pending;
+    pending.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        ReadRequest& r = reqs[i];
+        if (r.len > 0 && (map->isEmpty() || map->covers(r.addr, r.len))) {
+            pending.append(i);
+            continue;
+        }
+        r.ok = r.len == 0 || (r.len > 0 && read(r.addr, r.buf, r.len));
+        if (!r.ok && r.len > 0)
+            std::memset(r.buf, 0, static_cast<size_t>(r.len));
+        all = all && r.ok;
+    }
+
+    // One process_vm_readv per IOV_MAX ranges. The kernel stops at the first
+    // remote range it can't read, so the short count tells us where: that
+    // range goes through read() (pread fallback) and the batch resumes
+    // after it.
+    static constexpr int kMaxIov = IOV_MAX;
+    QVector<struct iovec> local, remote;
+    local.reserve(qMin(pending.size(), kMaxIov));
+    remote.reserve(qMin(pending.size(), kMaxIov));
+
+    int k = 0;
+    while (k < pending.size()) {
+        local.clear();
+        remote.clear();
+        for (int j = k; j < pending.size() && local.size() < kMaxIov; ++j) {
+            const ReadRequest& r = reqs[pending[j]];
+            local.append({r.buf, static_cast<size_t>(r.len)});
+            remote.append({reinterpret_cast<void*>(r.addr), static_cast<size_t>(r.len)});
+        }
+
+        ssize_t nread = process_vm_readv(m_pid, local.constData(), static_cast<unsigned long>(local.size()),
+                                         remote.constData(), static_cast<unsigned long>(remote.size()), 0);
+        size_t done = nread > 0 ? static_cast<size_t>(nread) : 0;
+
+        // Mark the ranges that were transferred in full
+        const int chunkEnd = k + local.size();
+        while (k < chunkEnd && done >= static_cast<size_t>(reqs[pending[k]].len)) {
+            done -= static_cast<size_t>(reqs[pending[k]].len);
+            reqs[pending[k++]].ok = true;
+        }
+        if (k == chunkEnd) continue;
+
+        // First range the kernel stopped at
+        ReadRequest& r = reqs[pending[k++]];
+        r.ok = read(r.addr, r.buf, r.len);
+        if (!r.ok)
+            std::memset(r.buf, 0, static_cast<size_t>(r.len));
+        all = all && r.ok;
+    }
+    return all;
+}
+
 bool ProcessMemoryProvider::write(uint64_t addr, const void* buf, int len)
 {
     if (m_fd < 0 || !m_writable || len <= 0) return false;
@@ -196,21 +307,6 @@ bool ProcessMemoryProvider::write(uint64_t addr, const void* buf, int len)
     return nwritten == static_cast<ssize_t>(len);
 }
 
-QString ProcessMemoryProvider::getSymbol(uint64_t addr) const
-{
-    for (const auto& mod : m_modules)
-    {
-        if (addr >= mod.base && addr < mod.base + mod.size)
-        {
-            uint64_t offset = addr - mod.base;
-            return QStringLiteral("%1+0x%2")
-                .arg(mod.name)
-                .arg(offset, 0, 16, QChar('0'));
-        }
-    }
-    return {};
-}
-
 void ProcessMemoryProvider::cacheModules()
 {
     // Parse /proc/<pid>/maps to discover loaded modules
@@ -270,27 +366,33 @@ void ProcessMemoryProvider::cacheModules()
         }
     }
 
-    m_modules.reserve(moduleRanges.size());
+    QVector<rcx::SymbolIndex::Module> modules;
+    modules.reserve(moduleRanges.size());
     for (auto it = moduleRanges.begin(); it != moduleRanges.end(); ++it)
     {
+        // Images are opened through the process's root, so libraries in
+        // other mount namespaces (containers) resolve too
         QFileInfo fi(it.key());
-        m_modules.append({
+        modules.append({
             fi.fileName(),
             it->base,
-            it->end - it->base
+            it->end - it->base,
+            QStringLiteral("/proc/%1/root%2").arg(m_pid).arg(it.key())
         });
     }
+    m_symbols = rcx::SymbolIndex::shared(m_pid, modules);
 }
 
 #endif // platform
 
+QString ProcessMemoryProvider::getSymbol(uint64_t addr) const
+{
+    return m_symbols ? m_symbols->symbolize(addr) : QString();
+}
+
 uint64_t ProcessMemoryProvider::symbolToAddress(const QString& name) const
 {
-    for (const auto& mod : m_modules) {
-        if (mod.name.compare(name, Qt::CaseInsensitive) == 0)
-            return mod.base;
-    }
-    return 0;
+    return m_symbols ? m_symbols->moduleBase(name) : 0;
 }
 
 ProcessMemoryProvider::~ProcessMemoryProvider()
@@ -1,8 +1,14 @@
 #pragma once
 #include "../../src/iplugin.h"
 #include "../../src/core.h"
+#include "../../src/providers/region_map.h"
+#include "../../src/providers/symbol_index.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
 
 #include <cstdint>
+#include <memory>
 
 /**
  * Process memory provider
@@ -20,6 +26,9 @@ public:
 
     // Optional overrides
     bool write(uint64_t addr, const void* buf, int len) override;
+#ifdef __linux__
+    bool readBatch(ReadRequest* reqs, int count) const override;
+#endif
     bool isWritable() const override { return m_writable; }
     QString name() const override { return m_processName; }
     QString kind() const override { return QStringLiteral("LocalProcess"); }
@@ -28,20 +37,27 @@ public:
 
     bool isLive() const override { return true; }
     uint64_t base() const override { return m_base; }
-    bool isReadable(uint64_t, int len) const override {
-#ifdef _WIN32
-        return m_handle && len >= 0;
-#elif defined(__linux__)
-        return m_fd >= 0 && len >= 0;
+    bool isReadable(uint64_t addr, int len) const override;
+#ifdef __linux__
+    QVector<Region> regions() const override;
 #endif
-    }
 
     // Process-specific helpers
     uint32_t pid() const { return m_pid; }
-    void refreshModules() { m_modules.clear(); cacheModules(); }
+    void refreshModules() { cacheModules(); }
 
 private:
     void cacheModules();
+#ifdef __linux__
+    // /proc/<pid>/maps, parsed; re-read once older than maxAgeMs and
+    // re-parsed only when its text changed. A lookup that misses asks again
+    // with kRegionMissRefreshMs, so a new mapping is seen within that.
+    static constexpr int kRegionRefreshMs = 500;
+    static constexpr int kRegionMissRefreshMs = 50;
+    std::shared_ptr<const rcx::RegionMap> regionMap(int maxAgeMs = kRegionRefreshMs) const;
+    // Whether [addr, addr + len) lies in mappings carrying `perms`
+    bool mapped(uint64_t addr, int len, uint32_t perms) const;
+#endif
 
 private:
 #ifdef _WIN32
@@ -54,12 +70,15 @@ private:
     bool m_writable;
     uint64_t m_base;
 
-    struct ModuleInfo {
-        QString  name;
-        uint64_t base;
-        uint64_t size;
-    };
-    QVector<ModuleInfo> m_modules;
+    // Loaded modules; shared with other documents on the same process
+    std::shared_ptr<rcx::SymbolIndex> m_symbols;
+
+#ifdef __linux__
+    mutable QMutex                                m_regionMutex;
+    mutable std::shared_ptr<const rcx::RegionMap> m_regionMap;
+    mutable QByteArray                            m_mapsText;
+    mutable QElapsedTimer                         m_regionAge;
+#endif
 };
 
 /**
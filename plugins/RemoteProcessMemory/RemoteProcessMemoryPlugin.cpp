@@ -188,6 +188,64 @@ struct IpcClient {
         return true;
     }
 
+    /* Serve as many requests as fit in one READ_BATCH round-trip (entry
+       table first, then the data); loop until all are done. Requests that
+       can never fit the data region fail without a round-trip. */
+    bool readBatch(rcx::Provider::ReadRequest* reqs, int count)
+    {
+        QMutexLocker lock(&mutex);
+        if (!connected) return false;
+
+        auto* hdr  = static_cast<RcxRpcHeader*>(mappedView);
+        auto* data = static_cast<uint8_t*>(mappedView) + RCX_RPC_DATA_OFFSET;
+
+        bool all = true;
+        int i = 0;
+        while (i < count) {
+            /* pick the batch: entries are laid out up front, data after */
+            int n = 0;
+            uint64_t dataUsed = 0;
+            while (i + n < count && n < RCX_RPC_MAX_BATCH) {
+                uint64_t len = (uint64_t)qMax(reqs[i + n].len, 0);
+                uint64_t need = (uint64_t)(n + 1) * sizeof(RcxRpcReadEntry) + dataUsed + len;
+                if (need > RCX_RPC_DATA_SIZE) break;
+                dataUsed += len;
+                ++n;
+            }
+            if (n == 0) {  /* a single request larger than the data region */
+                auto& r = reqs[i++];
+                memset(r.buf, 0, (size_t)qMax(r.len, 0));
+                r.ok = false;
+                all = false;
+                continue;
+            }
+
+            uint32_t dataOff = (uint32_t)(n * sizeof(RcxRpcReadEntry));
+            auto* entries = reinterpret_cast<RcxRpcReadEntry*>(data);
+            for (int k = 0; k < n; ++k) {
+                entries[k].address    = reqs[i + k].addr;
+                entries[k].length     = (uint32_t)qMax(reqs[i + k].len, 0);
+                entries[k].dataOffset = dataOff;
+                dataOff += entries[k].length;
+            }
+            hdr->command      = RPC_CMD_READ_BATCH;
+            hdr->requestCount = (uint32_t)n;
+            hdr->status       = RCX_RPC_STATUS_OK;
+            memset(hdr->readFailed, 0, sizeof(hdr->readFailed));
+
+            if (!signalAndWait()) { connected = false; return false; }
+
+            for (int k = 0; k < n; ++k) {
+                auto& r = reqs[i + k];
+                memcpy(r.buf, data + entries[k].dataOffset, entries[k].length);
+                r.ok = !hdr->readFailed[k];
+                all = all && r.ok;
+            }
+            i += n;
+        }
+        return all;
+    }
+
     bool writeSingle(uint64_t addr, const void* buf, int len)
     {
         QMutexLocker lock(&mutex);
@@ -303,6 +361,19 @@ bool RemoteProcessProvider::read(uint64_t addr, void* buf, int len) const
     return ok;
 }
 
+bool RemoteProcessProvider::readBatch(ReadRequest* reqs, int count) const
+{
+    if (!m_connected) return Provider::readBatch(reqs, count);
+    if (m_ipc->readBatch(reqs, count)) return true;
+    if (!m_ipc->connected) {
+        for (int i = 0; i < count; ++i) {
+            if (!reqs[i].ok) memset(reqs[i].buf, 0, (size_t)qMax(reqs[i].len, 0));
+        }
+        const_cast<RemoteProcessProvider*>(this)->m_connected = false;
+    }
+    return false;
+}
+
 int RemoteProcessProvider::size() const
 {
     return m_connected ? 0x10000 : 0;
@@ -318,31 +389,27 @@ bool RemoteProcessProvider::write(uint64_t addr, const void* buf, int len)
 
 QString RemoteProcessProvider::getSymbol(uint64_t addr) const
 {
-    for (const auto& mod : m_modules) {
-        if (addr >= mod.base && addr < mod.base + mod.size) {
-            uint64_t off = addr - mod.base;
-            return QStringLiteral("%1+0x%2")
-                .arg(mod.name)
-                .arg(off, 0, 16, QChar('0'));
-        }
-    }
-    return {};
+    return m_symbols ? m_symbols->symbolize(addr) : QString();
 }
 
 uint64_t RemoteProcessProvider::symbolToAddress(const QString& n) const
 {
-    for (const auto& mod : m_modules) {
-        if (mod.name.compare(n, Qt::CaseInsensitive) == 0)
-            return mod.base;
-    }
-    return 0;
+    return m_symbols ? m_symbols->moduleBase(n) : 0;
 }
 
 void RemoteProcessProvider::cacheModules()
 {
-    m_modules = m_ipc->enumerateModules();
-    if (!m_modules.isEmpty())
-        m_base = m_modules.first().base;
+    /* The payload reports base names only: module intervals, no ELF
+     * symbol tables */
+    QVector<ModuleInfo> mods = m_ipc->enumerateModules();
+    if (!mods.isEmpty())
+        m_base = mods.first().base;
+
+    QVector<rcx::SymbolIndex::Module> modules;
+    modules.reserve(mods.size());
+    for (const ModuleInfo& m : mods)
+        modules.append({m.name, m.base, m.size, {}});
+    m_symbols = rcx::SymbolIndex::shared(m_pid, modules);
 }
 
 /* ══════════════════════════════════════════════════════════════════════
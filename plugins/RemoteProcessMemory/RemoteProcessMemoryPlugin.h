@@ -1,6 +1,7 @@
 #pragma once
 #include "../../src/iplugin.h"
 #include "../../src/providers/provider.h"
+#include "../../src/providers/symbol_index.h"
 
 #include <cstdint>
 #include <memory>
@@ -27,6 +28,7 @@ public:
 
     /* optional */
     bool     write(uint64_t addr, const void* buf, int len) override;
+    bool     readBatch(ReadRequest* reqs, int count) const override;
     bool     isWritable() const override { return m_connected; }
     QString  name() const override { return m_processName; }
     QString  kind() const override { return QStringLiteral("RemoteProcess"); }
@@ -46,7 +48,7 @@ private:
     bool     m_connected;
     uint64_t m_base;
     mutable std::shared_ptr<IpcClient> m_ipc;
-    QVector<ModuleInfo> m_modules;
+    std::shared_ptr<rcx::SymbolIndex> m_symbols;   /* shared per pid */
 };
 
 /* ── Plugin ───────────────────────────────────────────────────────── */
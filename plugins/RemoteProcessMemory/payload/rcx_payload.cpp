@@ -97,6 +97,7 @@ static void handle_read_batch(RcxRpcHeader* hdr, uint8_t* data)
         } else {
             memset(dest, 0, entries[i].length);
             hdr->status = RCX_RPC_STATUS_PARTIAL;
+            if (i < RCX_RPC_MAX_BATCH) hdr->readFailed[i] = 1;
         }
         /* SEH fallback (commented out, kept for reference):
         __try {
@@ -367,7 +368,12 @@ static void handle_read_batch(RcxRpcHeader* hdr, uint8_t* data)
     auto* entries = reinterpret_cast<RcxRpcReadEntry*>(data);
     for (uint32_t i = 0; i < hdr->requestCount; ++i) {
         uint8_t* dest = data + entries[i].dataOffset;
-        safe_read(entries[i].address, dest, entries[i].length, &hdr->status);
+        uint32_t status = RCX_RPC_STATUS_OK;
+        safe_read(entries[i].address, dest, entries[i].length, &status);
+        if (status != RCX_RPC_STATUS_OK) {
+            hdr->status = status;
+            if (i < RCX_RPC_MAX_BATCH) hdr->readFailed[i] = 1;
+        }
     }
     hdr->responseCount = hdr->requestCount;
 }
@@ -66,7 +66,8 @@ struct RcxRpcModuleEntry {
  *    32     responseCount    (4)
  *    36     totalDataUsed    (4)
  *    40     imageBase        (8)  -- main module base from PEB / procfs
- *    48     _pad[4048]
+ *    48     readFailed[256]  (256) -- READ_BATCH: 1 = entry i was zero-filled
+ *   304     _pad[3792]
  */
 struct RcxRpcHeader {
     uint32_t version;
@@ -79,7 +80,8 @@ struct RcxRpcHeader {
     uint32_t responseCount;
     uint32_t totalDataUsed;
     uint64_t imageBase;        /* main module base (PEB on Win, /proc on Linux) */
-    uint8_t  _pad[RCX_RPC_HEADER_SIZE - 48];
+    uint8_t  readFailed[RCX_RPC_MAX_BATCH];  /* cleared by the client per batch */
+    uint8_t  _pad[RCX_RPC_HEADER_SIZE - 48 - RCX_RPC_MAX_BATCH];
 };
 
 /* ── name formatting helpers (PID-only, no nonce) ─────────────────── */
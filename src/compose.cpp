@@ -1,5 +1,10 @@
 #include "core.h"
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
 #include <algorithm>
+#include <functional>
 #include <numeric>
 
 namespace rcx {
@@ -10,6 +15,9 @@ namespace {
 constexpr int SC_FOLDLEVELBASE       = 0x400;
 constexpr int SC_FOLDLEVELHEADERFLAG = 0x2000;
 constexpr uint64_t kGoldenRatio      = 0x9E3779B97F4A7C15ULL;
+constexpr int      kEstLineChars     = 96;  // output reserve per line (indent + columns)
+
+using TypeAliases = QHash<NodeKind, QString>;
 
 struct ComposeState {
     QString            text;
@@ -24,24 +32,47 @@ struct ComposeState {
     bool               baseEmitted = false;     // only first root struct shows base address
     bool               compactColumns = false;  // compact column mode: cap type width, overflow long types
     uint64_t           currentPtrBase = 0;      // absolute addr of current pointer expansion target
+    ComposeWindow      window;                  // lines to materialize (empty = all)
+    const ComposeCache* cache = nullptr;        // fragment cache (null = compose everything)
+    int                placeholderLines = 0;    // lines emitted outside the window so far
+    const TypeAliases* typeAliases = nullptr;   // per-document kind display names
+
+    // Fragments being recorded, innermost last. text/meta positions mark
+    // where the fragment's next own piece starts.
+    struct Recorder {
+        uint64_t        id = 0;
+        ComposeFragment frag;
+        int             textPos = 0;
+        int             metaPos = 0;
+    };
+    QVector<Recorder>  recorders;
+    QHash<uint64_t, ComposeFragment> recorded;  // new fragments, stored into the cache at the end
+    int                replayed = 0;            // cached fragments reused
 
     // Precomputed for O(1) lookups
     QHash<uint64_t, QVector<int>> childMap;
     QVector<int64_t>              absOffsets;  // indexed by node index
 
-    // Per-scope column widths (containerId -> width for direct children)
-    QHash<uint64_t, int> scopeTypeW;
-    QHash<uint64_t, int> scopeNameW;
+    // Per-scope column widths (the cache's, or measured for this compose)
+    ColumnWidths         ownWidths;
+    const ColumnWidths*  widths  = &ownWidths;
+    int                  typeCap = kMaxTypeW;
 
     int effectiveTypeW(uint64_t scopeId) const {
-        return scopeTypeW.value(scopeId, typeW);
+        auto it = widths->scopes.constFind(scopeId);
+        if (it == widths->scopes.constEnd()) return typeW;
+        return qBound(kMinTypeW, qMax(it->typeLen, it->elemTypeLen), typeCap);
     }
     int effectiveNameW(uint64_t scopeId) const {
-        return scopeNameW.value(scopeId, nameW);
+        auto it = widths->scopes.constFind(scopeId);
+        if (it == widths->scopes.constEnd()) return nameW;
+        return qBound(kMinNameW, it->nameLen, kMaxNameW);
     }
 
-    void emitLine(const QString& lineText, LineMeta lm) {
-        if (currentLine > 0) text += '\n';
+    // Line building: beginLine() writes the separator and fold column, the
+    // caller appends the line body straight into `text`, endLine() commits.
+    void beginLine(const LineMeta& lm) {
+        if (currentLine > 0) text += QLatin1Char('\n');
         // 3-char fold indicator column: " - " expanded, " + " collapsed, "   " other
         // CommandRow has no fold prefix (flush left)
         if (lm.lineKind == LineKind::CommandRow
@@ -50,11 +81,38 @@ struct ComposeState {
         } else if (lm.foldHead)
             text += lm.foldCollapsed ? QStringLiteral(" \u25B8 ") : QStringLiteral(" \u25BE ");
         else
-            text += QStringLiteral("   ");
-        text += lineText;
+            text += QLatin1String("   ");
+    }
+
+    void endLine(const LineMeta& lm) {
         meta.append(lm);
         currentLine++;
     }
+
+    void emitLine(const QString& lineText, const LineMeta& lm) {
+        beginLine(lm);
+        text += lineText;
+        endLine(lm);
+    }
+
+    // Lines outside the window keep their meta for line/node mapping and fold
+    // structure, but get no text; the editor requests them once scrolled in.
+    bool materializeNext() const { return window.contains(currentLine); }
+
+    void emitPlaceholder(LineMeta lm) {
+        placeholderLines++;
+        lm.materialized = false;
+        lm.offsetStyle = OffsetStyle::None;
+        emitLine(QString(), lm);
+    }
+
+    // A struct referenced by the output being recorded (pointer target,
+    // struct-array element or embedded ref); renaming or editing it must
+    // invalidate the fragment.
+    void noteRef(uint64_t refId) {
+        if (refId != 0 && !recorders.isEmpty())
+            recorders.last().frag.refs.insert(refId);
+    }
 };
 
 int computeFoldLevel(int depth, bool isHead) {
@@ -79,6 +137,76 @@ static QString resolvePointerTarget(const NodeTree& tree, uint64_t refId) {
     return ref.structTypeName.isEmpty() ? ref.name : ref.structTypeName;
 }
 
+// Display name of a kind: the document's alias if it has one
+static QString kindTypeName(NodeKind kind, const TypeAliases* aliases) {
+    if (aliases) {
+        auto it = aliases->constFind(kind);
+        if (it != aliases->constEnd() && !it.value().isEmpty())
+            return it.value();
+    }
+    return fmt::typeNameRaw(kind);
+}
+
+// Type column text for a leaf line: pointers show their target ("Foo*",
+// "int32**"), aliased kinds their alias, everything else the kind's own
+// name (empty override).
+static QString leafTypeOverride(const NodeTree& tree, const Node& node,
+                                const TypeAliases* aliases,
+                                QString* ptrTargetName = nullptr) {
+    if (node.kind != NodeKind::Pointer32 && node.kind != NodeKind::Pointer64) {
+        if (aliases && aliases->contains(node.kind))
+            return kindTypeName(node.kind, aliases);
+        return {};
+    }
+    if (node.ptrDepth > 0 && isValidPrimitivePtrTarget(node.elementKind)) {
+        // Primitive pointer: e.g. "int32*" or "f64**"
+        const auto* meta = kindMeta(node.elementKind);
+        QString baseName = meta ? QString::fromLatin1(meta->typeName)
+                                : QStringLiteral("void");
+        QString stars = (node.ptrDepth >= 2) ? QStringLiteral("**") : QStringLiteral("*");
+        return baseName + stars;
+    }
+    QString target = resolvePointerTarget(tree, node.refId);
+    if (ptrTargetName) *ptrTargetName = target;
+    return fmt::pointerTypeName(node.kind, target);
+}
+
+// Rewrite the "[i]" tail of an element type string ("uint32_t[" + i + "]")
+// in place, keeping the buffer's capacity between elements.
+static void setElementIndex(QString& typeStr, int baseLen, int idx) {
+    QChar buf[12];
+    QChar* end = buf + 12;
+    QChar* p = end;
+    unsigned v = (unsigned)idx;
+    do { *--p = QLatin1Char(char('0' + v % 10)); v /= 10; } while (v);
+    typeStr.truncate(baseLen);
+    typeStr.append(p, int(end - p));
+    typeStr += QLatin1Char(']');
+}
+
+// Stands in for the provider below unreadable pointer targets (shows zeros)
+static const Provider& nullProvider() {
+    static NullProvider s_nullProv;
+    return s_nullProv;
+}
+
+// Address an expanded pointer's children are laid out at: the pointer value,
+// or 0 when it is null, a sentinel, or not readable.
+static uint64_t readPointerTarget(const Node& node, const Provider& prov, uint64_t addr) {
+    int sz = node.byteSize();
+    uint64_t ptrVal = 0;
+    if (prov.isValid() && sz > 0 && prov.isReadable(addr, sz)) {
+        ptrVal = (node.kind == NodeKind::Pointer32)
+            ? (uint64_t)prov.readU32(addr) : prov.readU64(addr);
+        // Treat sentinel values as invalid pointers
+        if (ptrVal == UINT64_MAX || (node.kind == NodeKind::Pointer32 && ptrVal == 0xFFFFFFFF))
+            ptrVal = 0;
+    }
+    if (ptrVal == 0 || !prov.isReadable(ptrVal, 1))
+        return 0;
+    return ptrVal;
+}
+
 static int64_t relOffsetFromRoot(const NodeTree& tree, int idx, uint64_t rootId) {
     int64_t total = 0;
     QSet<uint64_t> visited;
@@ -123,23 +251,36 @@ void composeLeaf(ComposeState& state, const NodeTree& tree,
 
     int numLines = linesForKind(node.kind);
 
-    // Resolve pointer target name for display
-    QString ptrTypeOverride;
-    QString ptrTargetName;
-    if (node.kind == NodeKind::Pointer32 || node.kind == NodeKind::Pointer64) {
-        if (node.ptrDepth > 0 && isValidPrimitivePtrTarget(node.elementKind)) {
-            // Primitive pointer: e.g. "int32*" or "f64**"
-            const auto* meta = kindMeta(node.elementKind);
-            QString baseName = meta ? QString::fromLatin1(meta->typeName)
-                                    : QStringLiteral("void");
-            QString stars = (node.ptrDepth >= 2) ? QStringLiteral("**") : QStringLiteral("*");
-            ptrTypeOverride = baseName + stars;
-        } else {
-            ptrTargetName = resolvePointerTarget(tree, node.refId);
-            ptrTypeOverride = fmt::pointerTypeName(node.kind, ptrTargetName);
+    // Entirely outside the window: emit mapping-only lines, skip all formatting
+    bool anyVisible = false;
+    for (int sub = 0; sub < numLines && !anyVisible; sub++)
+        anyVisible = state.window.contains(state.currentLine + sub);
+    if (!anyVisible) {
+        for (int sub = 0; sub < numLines; sub++) {
+            LineMeta lm;
+            lm.nodeIdx        = nodeIdx;
+            lm.nodeId         = node.id;
+            lm.subLine        = sub;
+            lm.depth          = depth;
+            lm.isContinuation = (sub > 0);
+            lm.lineKind       = lm.isContinuation ? LineKind::Continuation : LineKind::Field;
+            lm.nodeKind       = node.kind;
+            lm.offsetAddr     = absAddr;
+            lm.ptrBase        = state.currentPtrBase;
+            lm.foldLevel      = computeFoldLevel(depth, false);
+            lm.effectiveTypeW = typeW;
+            lm.effectiveNameW = nameW;
+            if (isHexPreview(node.kind))
+                lm.lineByteCount = sizeForKind(node.kind);
+            state.emitPlaceholder(lm);
         }
+        return;
     }
 
+    // Resolve pointer target name for display
+    QString ptrTargetName;
+    QString ptrTypeOverride = leafTypeOverride(tree, node, state.typeAliases, &ptrTargetName);
+
     // Detect type overflow in compact mode (for effectiveTypeW)
     QString rawType = ptrTypeOverride.isEmpty() ? fmt::typeNameRaw(node.kind) : ptrTypeOverride;
     bool typeOverflow = state.compactColumns && rawType.size() > typeW;
@@ -156,24 +297,34 @@ void composeLeaf(ComposeState& state, const NodeTree& tree,
         lm.isContinuation  = isCont;
         lm.lineKind        = isCont ? LineKind::Continuation : LineKind::Field;
         lm.nodeKind        = node.kind;
-        lm.offsetText      = fmt::fmtOffsetMargin(absAddr, isCont, state.offsetHexDigits);
+        lm.offsetStyle     = isCont ? OffsetStyle::Continuation : OffsetStyle::Address;
         lm.offsetAddr      = absAddr;
         lm.ptrBase         = state.currentPtrBase;
         lm.markerMask      = computeMarkers(node, prov, absAddr, isCont, depth);
         lm.foldLevel       = computeFoldLevel(depth, false);
         lm.effectiveTypeW  = lineTypeW;
         lm.effectiveNameW  = nameW;
-        lm.pointerTargetName = ptrTargetName;
+        lm.ptrTargetId     = ptrTargetName.isEmpty() ? 0 : node.refId;
+        lm.valueLine       = ValueLine::Leaf;
+        lm.nullValues      = (&prov == &nullProvider());
+        lm.scopeTypeW      = typeW;
+        lm.scopeNameW      = nameW;
 
         // Set byte count for hex preview lines (used for per-byte change highlighting)
         if (isHexPreview(node.kind)) {
             lm.lineByteCount = sizeForKind(node.kind);
         }
 
-        QString lineText = fmt::fmtNodeLine(node, prov, absAddr, depth, sub,
-                                            /*comment=*/{}, typeW, nameW, ptrTypeOverride,
-                                            state.compactColumns);
-        state.emitLine(lineText, lm);
+        if (!state.materializeNext()) {
+            state.emitPlaceholder(lm);
+            continue;
+        }
+
+        state.beginLine(lm);
+        fmt::appendNodeLine(state.text, node, prov, absAddr, depth, sub,
+                            /*comment=*/{}, typeW, nameW, ptrTypeOverride,
+                            state.compactColumns);
+        state.endLine(lm);
     }
 }
 
@@ -188,6 +339,8 @@ void composeParent(ComposeState& state, const NodeTree& tree,
                    uint64_t base = 0, uint64_t rootId = 0, bool isArrayChild = false,
                    uint64_t scopeId = 0, int arrayElementIdx = -1,
                    uint64_t arrayContainerAddr = 0);
+void composeCachedParent(ComposeState& state, const NodeTree& tree,
+                         const Provider& prov, int nodeIdx, int depth, uint64_t scopeId);
 
 void composeParent(ComposeState& state, const NodeTree& tree,
                    const Provider& prov, int nodeIdx, int depth,
@@ -204,7 +357,7 @@ void composeParent(ComposeState& state, const NodeTree& tree,
         lm.nodeId     = node.id;
         lm.depth      = depth;
         lm.lineKind   = LineKind::Field;
-        lm.offsetText = fmt::fmtOffsetMargin(absAddr, false, state.offsetHexDigits);
+        lm.offsetStyle = OffsetStyle::Address;
         lm.offsetAddr = absAddr;
         lm.ptrBase    = state.currentPtrBase;
         lm.nodeKind   = node.kind;
@@ -223,7 +376,7 @@ void composeParent(ComposeState& state, const NodeTree& tree,
         lm.nodeId     = node.id;
         lm.depth      = depth;
         lm.lineKind   = LineKind::ArrayElementSeparator;
-        lm.offsetText = fmt::fmtOffsetMargin(absAddr, false, state.offsetHexDigits);
+        lm.offsetStyle = OffsetStyle::Address;
         lm.offsetAddr = absAddr;
         lm.ptrBase    = state.currentPtrBase;
         lm.nodeKind   = node.kind;
@@ -253,7 +406,7 @@ void composeParent(ComposeState& state, const NodeTree& tree,
         lm.nodeId     = node.id;
         lm.depth      = depth;
         lm.lineKind   = LineKind::Header;
-        lm.offsetText = fmt::fmtOffsetMargin(absAddr, false, state.offsetHexDigits);
+        lm.offsetStyle = OffsetStyle::Address;
         lm.offsetAddr = absAddr;
         lm.ptrBase    = state.currentPtrBase;
         lm.nodeKind   = node.kind;
@@ -270,8 +423,11 @@ void composeParent(ComposeState& state, const NodeTree& tree,
             lm.elementKind   = node.elementKind;
             lm.arrayViewIdx  = node.viewIndex;
             lm.arrayCount    = node.arrayLen;
-            QString elemStructName = (node.elementKind == NodeKind::Struct)
-                ? resolvePointerTarget(tree, node.refId) : QString();
+            QString elemStructName;
+            if (node.elementKind == NodeKind::Struct) {
+                elemStructName = resolvePointerTarget(tree, node.refId);
+                state.noteRef(node.refId);
+            }
             QString rawType = fmt::arrayTypeName(node.elementKind, node.arrayLen, elemStructName);
             bool overflow = state.compactColumns && rawType.size() > typeW;
             lm.effectiveTypeW = overflow ? rawType.size() : typeW;
@@ -307,7 +463,7 @@ void composeParent(ComposeState& state, const NodeTree& tree,
                 lm.nodeKind   = NodeKind::UInt32;
                 lm.foldLevel  = computeFoldLevel(childDepth, false);
                 lm.markerMask = 0;
-                lm.offsetText = fmt::fmtOffsetMargin(absAddr, true, state.offsetHexDigits);
+                lm.offsetStyle = OffsetStyle::Continuation;
                 lm.offsetAddr = absAddr;
                 lm.ptrBase    = state.currentPtrBase;
                 state.emitLine(fmt::fmtEnumMember(m.first, m.second, childDepth, maxNameLen), lm);
@@ -324,7 +480,7 @@ void composeParent(ComposeState& state, const NodeTree& tree,
                 lm.isRootHeader = isRootHeader;
                 lm.foldLevel = computeFoldLevel(depth, false);
                 lm.markerMask = 0;
-                lm.offsetText = fmt::fmtOffsetMargin(absAddr, false, state.offsetHexDigits);
+                lm.offsetStyle = OffsetStyle::Address;
                 lm.offsetAddr = absAddr;
                 lm.ptrBase    = state.currentPtrBase;
                 state.emitLine(fmt::fmtStructFooter(node, depth, 0), lm);
@@ -344,19 +500,40 @@ void composeParent(ComposeState& state, const NodeTree& tree,
             int elemSize = sizeForKind(node.elementKind);
             int eTW = state.effectiveTypeW(node.id);
             int eNW = state.effectiveNameW(node.id);
+
+            // Reused per element: only offset and the "[i]" suffix change
+            Node elem;
+            elem.kind = node.elementKind;
+            elem.parentId = node.id;
+            elem.id = 0;
+            QString elemTypeStr = kindTypeName(node.elementKind, state.typeAliases)
+                                + QLatin1Char('[');
+            const int elemTypeBaseLen = elemTypeStr.size();
+
             for (int i = 0; i < node.arrayLen; i++) {
                 uint64_t elemAddr = absAddr + i * elemSize;
 
-                // Type override: "float[0]", "uint32_t[1]", etc.
-                QString elemTypeStr = fmt::typeNameRaw(node.elementKind)
-                                    + QStringLiteral("[%1]").arg(i);
+                if (!state.materializeNext()) {
+                    LineMeta lm;
+                    lm.nodeIdx    = nodeIdx;
+                    lm.nodeId     = node.id;
+                    lm.depth      = childDepth;
+                    lm.lineKind   = LineKind::Field;
+                    lm.nodeKind   = node.elementKind;
+                    lm.isArrayElement = true;
+                    lm.arrayElementIdx = i;
+                    lm.offsetAddr = elemAddr;
+                    lm.ptrBase    = state.currentPtrBase;
+                    lm.foldLevel  = computeFoldLevel(childDepth, false);
+                    lm.effectiveTypeW = eTW;
+                    lm.effectiveNameW = eNW;
+                    state.emitPlaceholder(lm);
+                    continue;
+                }
 
-                Node elem;
-                elem.kind = node.elementKind;
-                elem.name = QString();  // no name for array elements
+                // Type override: "float[0]", "uint32_t[1]", etc.
+                setElementIndex(elemTypeStr, elemTypeBaseLen, i);
                 elem.offset = node.offset + i * elemSize;
-                elem.parentId = node.id;
-                elem.id = 0;
 
                 LineMeta lm;
                 lm.nodeIdx    = nodeIdx;
@@ -366,7 +543,7 @@ void composeParent(ComposeState& state, const NodeTree& tree,
                 lm.nodeKind   = node.elementKind;
                 lm.isArrayElement = true;
                 lm.arrayElementIdx = i;
-                lm.offsetText = fmt::fmtOffsetMargin(elemAddr, false, state.offsetHexDigits);
+                lm.offsetStyle = OffsetStyle::Address;
                 lm.offsetAddr = elemAddr;
                 lm.ptrBase    = state.currentPtrBase;
                 lm.markerMask = computeMarkers(elem, prov, elemAddr, false, childDepth);
@@ -374,10 +551,15 @@ void composeParent(ComposeState& state, const NodeTree& tree,
                 bool elemOverflow = state.compactColumns && elemTypeStr.size() > eTW;
                 lm.effectiveTypeW = elemOverflow ? elemTypeStr.size() : eTW;
                 lm.effectiveNameW = eNW;
-
-                state.emitLine(fmt::fmtNodeLine(elem, prov, elemAddr, childDepth, 0,
-                                                {}, eTW, eNW, elemTypeStr,
-                                                state.compactColumns), lm);
+                lm.valueLine  = ValueLine::ArrayElement;
+                lm.nullValues = (&prov == &nullProvider());
+                lm.scopeTypeW = eTW;
+                lm.scopeNameW = eNW;
+
+                state.beginLine(lm);
+                fmt::appendNodeLine(state.text, elem, prov, elemAddr, childDepth, 0,
+                                    {}, eTW, eNW, elemTypeStr, state.compactColumns);
+                state.endLine(lm);
             }
         }
 
@@ -385,6 +567,7 @@ void composeParent(ComposeState& state, const NodeTree& tree,
         // referenced struct for each element (like repeated pointer deref)
         if (node.kind == NodeKind::Array && children.isEmpty()
             && node.elementKind == NodeKind::Struct && node.refId != 0) {
+            state.noteRef(node.refId);
             int refIdx = tree.indexOfId(node.refId);
             if (refIdx >= 0) {
                 int elemSize = tree.structSpan(node.refId, &state.childMap);
@@ -401,6 +584,7 @@ void composeParent(ComposeState& state, const NodeTree& tree,
         // Embedded struct with refId but no child nodes: expand referenced struct's
         // children at this node's offset (single instance, like array with count=1)
         if (node.kind == NodeKind::Struct && children.isEmpty() && node.refId != 0) {
+            state.noteRef(node.refId);
             int refIdx = tree.indexOfId(node.refId);
             if (refIdx >= 0) {
                 const QVector<int>& refChildren = childIndices(state, node.refId);
@@ -419,9 +603,7 @@ void composeParent(ComposeState& state, const NodeTree& tree,
                         lm.nodeId     = child.id;
                         lm.depth      = childDepth;
                         lm.lineKind   = LineKind::Header;
-                        lm.offsetText = fmt::fmtOffsetMargin(
-                            absAddr + child.offset, false,
-                            state.offsetHexDigits);
+                        lm.offsetStyle = OffsetStyle::Address;
                         lm.offsetAddr = absAddr + child.offset;
                         lm.ptrBase    = state.currentPtrBase;
                         lm.nodeKind   = child.kind;
@@ -466,7 +648,7 @@ void composeParent(ComposeState& state, const NodeTree& tree,
         lm.foldLevel  = computeFoldLevel(depth, false);
         lm.markerMask = 0;
         int sz = tree.structSpan(node.id, &state.childMap);
-        lm.offsetText = fmt::fmtOffsetMargin(absAddr + sz, false, state.offsetHexDigits);
+        lm.offsetStyle = OffsetStyle::Address;
         lm.offsetAddr = absAddr + sz;
         lm.ptrBase    = state.currentPtrBase;
         state.emitLine(fmt::fmtStructFooter(node, depth, sz), lm);
@@ -475,6 +657,280 @@ void composeParent(ComposeState& state, const NodeTree& tree,
     state.visiting.remove(node.id);
 }
 
+// ── Fragment cache ──
+
+// Move the lines emitted since the recorder's last piece into a new own piece.
+void flushOwnPiece(ComposeState& state, const NodeTree& tree, ComposeState::Recorder& rec) {
+    int n = state.meta.size() - rec.metaPos;
+    if (n > 0) {
+        ComposeFragment::Piece piece;
+        piece.text = state.text.mid(rec.textPos);
+        piece.meta = state.meta.mid(rec.metaPos, n);
+        piece.metaNodeIds.resize(n);
+        for (int i = 0; i < n; i++) {
+            int ni = piece.meta[i].nodeIdx;
+            piece.metaNodeIds[i] = (ni >= 0 && ni < tree.nodes.size()) ? tree.nodes[ni].id : 0;
+        }
+        rec.frag.pieces.append(piece);
+    }
+    rec.textPos = state.text.size();
+    rec.metaPos = state.meta.size();
+}
+
+// Record a finished (or replayed) child fragment in the enclosing recorder.
+void appendChildPiece(ComposeState& state, uint64_t childId, const QSet<uint64_t>& refs) {
+    if (state.recorders.isEmpty()) return;
+    ComposeState::Recorder& parent = state.recorders.last();
+    ComposeFragment::Piece piece;
+    piece.childId = childId;
+    parent.frag.pieces.append(piece);
+    parent.frag.refs.unite(refs);
+    parent.textPos = state.text.size();
+    parent.metaPos = state.meta.size();
+}
+
+bool fragmentComplete(const ComposeCache& cache, const ComposeFragment& frag) {
+    for (const auto& piece : frag.pieces) {
+        if (piece.childId == 0) continue;
+        auto it = cache.fragments.constFind(piece.childId);
+        if (it == cache.fragments.constEnd() || !fragmentComplete(cache, *it))
+            return false;
+    }
+    return true;
+}
+
+void replayFragment(ComposeState& state, const NodeTree& tree, const ComposeFragment& frag) {
+    for (const auto& piece : frag.pieces) {
+        if (piece.childId != 0) {
+            replayFragment(state, tree, *state.cache->fragments.constFind(piece.childId));
+            continue;
+        }
+        state.text += piece.text;
+        for (int i = 0; i < piece.meta.size(); i++) {
+            LineMeta lm = piece.meta[i];
+            // Node indices move when other nodes are removed; ids don't
+            if (lm.nodeIdx >= 0
+                && (lm.nodeIdx >= tree.nodes.size()
+                    || tree.nodes[lm.nodeIdx].id != piece.metaNodeIds[i]))
+                lm.nodeIdx = tree.indexOfId(piece.metaNodeIds[i]);
+            state.meta.append(lm);
+        }
+        state.currentLine += piece.meta.size();
+    }
+    if (frag.setsBaseEmitted)
+        state.baseEmitted = true;
+    if (!frag.fullyMaterialized)
+        state.placeholderLines++;
+}
+
+void composeCachedParent(ComposeState& state, const NodeTree& tree,
+                         const Provider& prov, int nodeIdx, int depth, uint64_t scopeId) {
+    const Node& node = tree.nodes[nodeIdx];
+
+    ComposeFragment ctx;
+    ctx.depth           = depth;
+    ctx.scopeId         = scopeId;
+    ctx.absAddr         = state.absOffsets.at(nodeIdx);
+    ctx.typeW           = state.typeW;
+    ctx.nameW           = state.nameW;
+    ctx.scopeTypeW      = state.effectiveTypeW(scopeId);
+    ctx.scopeNameW      = state.effectiveNameW(scopeId);
+    ctx.offsetHexDigits = state.offsetHexDigits;
+    ctx.compactColumns  = state.compactColumns;
+    ctx.baseEmitted     = state.baseEmitted;
+
+    // Flush the enclosing fragment's own lines before this child starts
+    if (!state.recorders.isEmpty())
+        flushOwnPiece(state, tree, state.recorders.last());
+
+    auto it = state.cache->fragments.constFind(node.id);
+    if (it != state.cache->fragments.constEnd() && it->sameContext(ctx)) {
+        // Partially materialized fragments only fit where they were composed;
+        // fully materialized ones fit anywhere the window fully covers.
+        bool fits = it->fullyMaterialized
+            ? state.window.containsRange(state.currentLine, state.currentLine + it->lineCount - 1)
+            : it->startLine == state.currentLine;
+        if (fits && fragmentComplete(*state.cache, *it)) {
+            state.replayed++;
+            replayFragment(state, tree, *it);
+            appendChildPiece(state, node.id, it->refs);
+            return;
+        }
+    }
+
+    ComposeState::Recorder rec;
+    rec.id = node.id;
+    rec.frag = ctx;
+    rec.frag.startLine = state.currentLine;
+    rec.textPos = state.text.size();
+    rec.metaPos = state.meta.size();
+    state.recorders.append(rec);
+    int placeholdersBefore = state.placeholderLines;
+
+    composeParent(state, tree, prov, nodeIdx, depth, 0, 0, false, scopeId);
+
+    rec = state.recorders.takeLast();
+    flushOwnPiece(state, tree, rec);
+    ComposeFragment& frag = rec.frag;
+    frag.lineCount = state.currentLine - frag.startLine;
+    frag.setsBaseEmitted = !ctx.baseEmitted && state.baseEmitted;
+    frag.fullyMaterialized = (state.placeholderLines == placeholdersBefore);
+
+    appendChildPiece(state, node.id, frag.refs);
+    state.recorded.insert(node.id, frag);
+}
+
+// Drop fragments invalidated since the last compose: dirty ids, their
+// ancestors, and anything that referenced them, to a fixed point.
+void pruneCache(ComposeCache& cache, const NodeTree& tree,
+                const Provider& prov, const ComposeWindow& window) {
+    if (cache.provider != &prov) {
+        cache.fragments.clear();
+        cache.provider = &prov;
+    }
+    if (cache.window != window) {
+        for (auto it = cache.fragments.begin(); it != cache.fragments.end(); ) {
+            if (it->fullyMaterialized) ++it;
+            else it = cache.fragments.erase(it);
+        }
+        cache.window = window;
+    }
+    if (cache.dirty.isEmpty()) return;
+
+    QSet<uint64_t> stale;
+    auto addWithAncestors = [&](uint64_t id) {
+        while (id != 0 && !stale.contains(id)) {
+            stale.insert(id);
+            int idx = tree.indexOfId(id);
+            if (idx < 0) break;
+            id = tree.nodes[idx].parentId;
+        }
+    };
+    for (uint64_t id : cache.dirty)
+        addWithAncestors(id);
+
+    for (bool grew = true; grew; ) {
+        grew = false;
+        for (auto it = cache.fragments.cbegin(); it != cache.fragments.cend(); ++it) {
+            if (stale.contains(it.key())) continue;
+            for (uint64_t ref : it->refs) {
+                if (stale.contains(ref)) {
+                    addWithAncestors(it.key());
+                    grew = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (uint64_t id : stale)
+        cache.fragments.remove(id);
+    cache.dirty.clear();
+}
+
+// Display type string of a node as its scope's type column sizes it
+QString nodeTypeName(const NodeTree& tree, const Node& n, const TypeAliases* aliases) {
+    if (n.kind == NodeKind::Array) {
+        QString sn = (n.elementKind == NodeKind::Struct)
+            ? resolvePointerTarget(tree, n.refId) : QString();
+        return fmt::arrayTypeName(n.elementKind, n.arrayLen, sn);
+    }
+    if (n.kind == NodeKind::Struct)
+        return fmt::structTypeName(n);
+    if (n.kind == NodeKind::Pointer32 || n.kind == NodeKind::Pointer64)
+        return fmt::pointerTypeName(n.kind, resolvePointerTarget(tree, n.refId));
+    return kindTypeName(n.kind, aliases);
+}
+
+// Widths of one scope from its direct children (hex nodes show an ASCII
+// preview instead of a name, so they don't size the name column)
+ScopeWidths measureScope(const NodeTree& tree, const QHash<uint64_t, QVector<int>>& childMap,
+                         const TypeAliases* aliases, uint64_t scopeId, const Node* container) {
+    ScopeWidths w;
+    auto kids = childMap.constFind(scopeId);
+    bool hasKids = kids != childMap.constEnd() && !kids->isEmpty();
+    if (hasKids) {
+        for (int childIdx : *kids) {
+            const Node& child = tree.nodes[childIdx];
+            w.typeLen = qMax(w.typeLen, (int)nodeTypeName(tree, child, aliases).size());
+            if (!isHexPreview(child.kind))
+                w.nameLen = qMax(w.nameLen, (int)child.name.size());
+        }
+    }
+
+    // Primitive arrays with no tree children: account for synthesized element types
+    // e.g. "uint32_t[0]", "uint32_t[99]" — longest index determines width
+    if (container && container->kind == NodeKind::Array && !hasKids
+        && container->elementKind != NodeKind::Struct
+        && container->elementKind != NodeKind::Array
+        && container->arrayLen > 0) {
+        w.elemTypeLen = kindTypeName(container->elementKind, aliases).size()
+                      + QString::number(container->arrayLen - 1).size() + 2;
+    }
+    return w;
+}
+
+void updateWidest(ColumnWidths& widths) {
+    widths.widest = {};
+    for (const ScopeWidths& w : widths.scopes) {
+        widths.widest.typeLen = qMax(widths.widest.typeLen, w.typeLen);
+        widths.widest.nameLen = qMax(widths.widest.nameLen, w.nameLen);
+    }
+}
+
+void measureAllScopes(ColumnWidths& widths, const NodeTree& tree,
+                      const QHash<uint64_t, QVector<int>>& childMap,
+                      const TypeAliases* aliases) {
+    widths.scopes.clear();
+    widths.scopes.insert(0, measureScope(tree, childMap, aliases, 0, nullptr));
+    for (const Node& n : tree.nodes) {
+        if (n.kind == NodeKind::Struct || n.kind == NodeKind::Array)
+            widths.scopes.insert(n.id, measureScope(tree, childMap, aliases, n.id, &n));
+    }
+    updateWidest(widths);
+    widths.valid = true;
+}
+
+// A dirty node re-sizes its parent's scope and, as a container, its own.
+// Pointers and struct arrays spell their target's name, so their scopes
+// follow a dirty target too. Names, kinds and type names only change
+// through dirty marks; everything else keeps its measured widths.
+void updateColumnWidths(ColumnWidths& widths, const NodeTree& tree,
+                        const QHash<uint64_t, QVector<int>>& childMap,
+                        const TypeAliases* aliases, const QSet<uint64_t>& dirty) {
+    if (!widths.valid) {
+        measureAllScopes(widths, tree, childMap, aliases);
+        return;
+    }
+    if (dirty.isEmpty()) return;
+
+    QSet<uint64_t> scopes;
+    for (uint64_t id : dirty) {
+        scopes.insert(id);
+        int idx = tree.indexOfId(id);
+        if (idx >= 0)
+            scopes.insert(tree.nodes[idx].parentId);
+    }
+    for (const Node& n : tree.nodes) {
+        if (n.refId != 0 && dirty.contains(n.refId))
+            scopes.insert(n.parentId);
+    }
+
+    for (uint64_t id : scopes) {
+        if (id == 0) {
+            widths.scopes.insert(0, measureScope(tree, childMap, aliases, 0, nullptr));
+            continue;
+        }
+        int idx = tree.indexOfId(id);
+        const Node* n = idx >= 0 ? &tree.nodes[idx] : nullptr;
+        if (n && (n->kind == NodeKind::Struct || n->kind == NodeKind::Array))
+            widths.scopes.insert(id, measureScope(tree, childMap, aliases, id, n));
+        else
+            widths.scopes.remove(id);
+    }
+    updateWidest(widths);
+}
+
 void composeNode(ComposeState& state, const NodeTree& tree,
                  const Provider& prov, int nodeIdx, int depth,
                  uint64_t base, uint64_t rootId, bool isArrayChild,
@@ -490,6 +946,7 @@ void composeNode(ComposeState& state, const NodeTree& tree,
     // Pointer deref expansion — single fold header merges pointer + struct header
     if ((node.kind == NodeKind::Pointer32 || node.kind == NodeKind::Pointer64)
         && node.refId != 0) {
+        state.noteRef(node.refId);
         QString ptrTargetName = resolvePointerTarget(tree, node.refId);
         QString ptrTypeOverride = fmt::pointerTypeName(node.kind, ptrTargetName);
 
@@ -505,6 +962,10 @@ void composeNode(ComposeState& state, const NodeTree& tree,
                               && state.virtualPtrRefs.contains(node.refId);
         bool effectiveCollapsed = node.collapsed || forceCollapsed;
 
+        // Target address for the expansion; the header records it so a value
+        // pass can tell when the pointer moved and the layout went stale.
+        uint64_t pBase = effectiveCollapsed ? 0 : readPointerTarget(node, prov, absAddr);
+
         // Emit merged fold header: "Type* Name {" (expanded) or "Type* Name -> val" (collapsed)
         {
             LineMeta lm;
@@ -512,7 +973,7 @@ void composeNode(ComposeState& state, const NodeTree& tree,
             lm.nodeId     = node.id;
             lm.depth      = depth;
             lm.lineKind   = effectiveCollapsed ? LineKind::Field : LineKind::Header;
-            lm.offsetText = fmt::fmtOffsetMargin(absAddr, false, state.offsetHexDigits);
+            lm.offsetStyle = OffsetStyle::Address;
             lm.offsetAddr = absAddr;
             lm.ptrBase    = state.currentPtrBase;
             lm.nodeKind   = node.kind;
@@ -524,34 +985,22 @@ void composeNode(ComposeState& state, const NodeTree& tree,
             bool ptrOverflow = state.compactColumns && ptrTypeOverride.size() > typeW;
             lm.effectiveTypeW = ptrOverflow ? ptrTypeOverride.size() : typeW;
             lm.effectiveNameW = nameW;
-            lm.pointerTargetName = ptrTargetName;
-            state.emitLine(fmt::fmtPointerHeader(node, depth, effectiveCollapsed,
-                                                  prov, absAddr, ptrTypeOverride,
-                                                  typeW, nameW, state.compactColumns), lm);
+            lm.ptrTargetId = ptrTargetName.isEmpty() ? 0 : node.refId;
+            lm.valueLine  = ValueLine::PointerHeader;
+            lm.nullValues = (&prov == &nullProvider());
+            lm.scopeTypeW = typeW;
+            lm.scopeNameW = nameW;
+            lm.ptrTarget  = pBase;
+            state.beginLine(lm);
+            fmt::appendPointerHeader(state.text, node, depth, effectiveCollapsed,
+                                     prov, absAddr, ptrTypeOverride,
+                                     typeW, nameW, state.compactColumns);
+            state.endLine(lm);
         }
 
         if (!effectiveCollapsed) {
-            int sz = node.byteSize();
-            uint64_t ptrVal = 0;
-            if (prov.isValid() && sz > 0 && prov.isReadable(absAddr, sz)) {
-                ptrVal = (node.kind == NodeKind::Pointer32)
-                    ? (uint64_t)prov.readU32(absAddr) : prov.readU64(absAddr);
-                if (ptrVal != 0) {
-                    // Treat sentinel values as invalid pointers
-                    if (ptrVal == UINT64_MAX || (node.kind == NodeKind::Pointer32 && ptrVal == 0xFFFFFFFF))
-                        ptrVal = 0;
-                }
-            }
-
-            // Pointer target address is used directly (absolute)
-            uint64_t pBase = ptrVal;
-            bool ptrReadable = (ptrVal != 0) && prov.isReadable(pBase, 1);
-
             // For invalid/unreadable pointers: use NullProvider (shows zeros)
-            static NullProvider s_nullProv;
-            const Provider& childProv = ptrReadable ? prov : static_cast<const Provider&>(s_nullProv);
-            if (!ptrReadable)
-                pBase = 0;
+            const Provider& childProv = (pBase != 0) ? prov : nullProvider();
 
             uint64_t savedPtrBase = state.currentPtrBase;
             state.currentPtrBase = pBase;
@@ -601,7 +1050,6 @@ void composeNode(ComposeState& state, const NodeTree& tree,
                 lm.depth     = depth;
                 lm.lineKind  = LineKind::Footer;
                 lm.nodeKind  = node.kind;
-                lm.offsetText.clear();
                 lm.foldLevel = computeFoldLevel(depth, false);
                 lm.markerMask = 0;
                 state.emitLine(fmt::indent(depth) + QStringLiteral("}"), lm);
@@ -611,23 +1059,155 @@ void composeNode(ComposeState& state, const NodeTree& tree,
     }
 
     if (node.kind == NodeKind::Struct || node.kind == NodeKind::Array) {
-        composeParent(state, tree, prov, nodeIdx, depth, base, rootId, isArrayChild, scopeId, arrayElementIdx, arrayContainerAddr);
+        // Tree containers (not ref/pointer expansions) go through the fragment cache
+        if (state.cache && base == 0 && rootId == 0 && !isArrayChild)
+            composeCachedParent(state, tree, prov, nodeIdx, depth, scopeId);
+        else
+            composeParent(state, tree, prov, nodeIdx, depth, base, rootId, isArrayChild, scopeId, arrayElementIdx, arrayContainerAddr);
     } else {
         composeLeaf(state, tree, prov, nodeIdx, depth, absAddr, scopeId);
     }
 }
 
+// ── Parallel roots ──
+// Root subtrees share nothing while composing: the tree, provider, widths
+// and cache are only read, and every piece of mutable state lives in a
+// per-root ComposeState. Each root is composed into its own buffer on the
+// thread pool and the buffers are stitched in order afterwards.
+
+// Below this many nodes the hand-off costs more than composing inline
+constexpr int kParallelMinNodes = 4096;
+
+// Claimed by index from the caller and pool helpers alike. A helper that
+// starts after the last root was claimed touches nothing but this struct,
+// so it may outlive the compose() call that created it.
+struct RootJob {
+    int                      count = 0;
+    QAtomicInt               next{0};
+    QSemaphore               done;
+    std::function<void(int)> work;
+
+    void drain() {
+        for (int i = next.fetchAndAddRelaxed(1); i < count; i = next.fetchAndAddRelaxed(1)) {
+            work(i);
+            done.release();
+        }
+    }
+};
+
+class RootJobRunner : public QRunnable {
+    std::shared_ptr<RootJob> m_job;
+public:
+    explicit RootJobRunner(std::shared_ptr<RootJob> job) : m_job(std::move(job)) {}
+    void run() override { m_job->drain(); }
+};
+
+// Fresh state for one root: same layout inputs and read-only lookups as
+// `parent` (implicitly shared, never written), empty output. Line numbers
+// continue from the parent's; stitching shifts them into place.
+ComposeState forkRootState(const ComposeState& parent) {
+    ComposeState s;
+    s.currentLine     = parent.currentLine;
+    s.typeW           = parent.typeW;
+    s.nameW           = parent.nameW;
+    s.offsetHexDigits = parent.offsetHexDigits;
+    s.baseEmitted     = parent.baseEmitted;
+    s.compactColumns  = parent.compactColumns;
+    s.window          = parent.window;
+    s.cache           = parent.cache;
+    s.typeAliases     = parent.typeAliases;
+    s.childMap        = parent.childMap;
+    s.absOffsets      = parent.absOffsets;
+    s.widths          = parent.widths;
+    s.typeCap         = parent.typeCap;
+    return s;
+}
+
+bool canComposeRootsInParallel(const NodeTree& tree, const QVector<int>& roots,
+                               const ComposeState& state, bool requested) {
+    if (!requested || roots.size() < 2 || tree.nodes.size() < kParallelMinNodes)
+        return false;
+    // Materialization depends on absolute line numbers, which a root only
+    // learns once every root before it has been composed
+    if (!state.window.isFull())
+        return false;
+    // Later roots assume the first one emits the base address
+    if (state.baseEmitted || tree.nodes[roots.first()].kind != NodeKind::Struct)
+        return false;
+    return QThreadPool::globalInstance()->maxThreadCount() > 1;
+}
+
+void composeRootsParallel(ComposeState& state, const NodeTree& tree,
+                          const Provider& prov, const QVector<int>& roots) {
+    // NodeTree builds its id and child indices lazily; do it before sharing
+    tree.indexOfId(0);
+    tree.childIndex();
+
+    std::vector<ComposeState> parts;
+    parts.reserve(roots.size());
+    for (int i = 0; i < roots.size(); i++) {
+        parts.push_back(forkRootState(state));
+        if (i > 0) parts.back().baseEmitted = true;
+    }
+
+    auto job = std::make_shared<RootJob>();
+    job->count = roots.size();
+    job->work = [&](int i) { composeNode(parts[i], tree, prov, roots[i], 0); };
+
+    QThreadPool* pool = QThreadPool::globalInstance();
+    int helpers = qMin(job->count - 1, pool->maxThreadCount());
+    for (int h = 0; h < helpers; h++)
+        pool->start(new RootJobRunner(job));
+    job->drain();
+    job->done.acquire(job->count);
+
+    const int forkLine = state.currentLine;
+    for (ComposeState& part : parts) {
+        const int shift = state.currentLine - forkLine;
+        state.text += part.text;
+        state.meta += part.meta;
+        state.currentLine += part.meta.size();
+        state.placeholderLines += part.placeholderLines;
+        state.baseEmitted = state.baseEmitted || part.baseEmitted;
+        state.replayed += part.replayed;
+        for (auto it = part.recorded.begin(); it != part.recorded.end(); ++it) {
+            it->startLine += shift;
+            state.recorded.insert(it.key(), *it);
+        }
+    }
+}
+
 } // anonymous namespace
 
 ComposeResult compose(const NodeTree& tree, const Provider& prov, uint64_t viewRootId,
-                      bool compactColumns) {
+                      bool compactColumns, const ComposeWindow& window,
+                      ComposeCache* cache, const ComposeOptions& opts) {
     ComposeState state;
     state.compactColumns = compactColumns;
+    state.window = window;
+    state.cache = cache;
+    state.typeAliases = opts.typeAliases;
 
     // Precompute parent→children map
     for (int i = 0; i < tree.nodes.size(); i++)
         state.childMap[tree.nodes[i].parentId].append(i);
 
+    // Size the output once up front: tree lines (plus header/footer for
+    // containers and synthesized primitive elements) at a typical line width.
+    // Pointer expansions can still grow it.
+    {
+        int estLines = 1;
+        for (const Node& n : tree.nodes) {
+            if (n.kind == NodeKind::Struct || n.kind == NodeKind::Array)
+                estLines += 2 + (n.kind == NodeKind::Array && n.elementKind != NodeKind::Struct
+                                 ? n.arrayLen : 0);
+            else
+                estLines += linesForKind(n.kind);
+        }
+        state.meta.reserve(estLines);
+        state.text.reserve(estLines * kEstLineChars);
+    }
+
     for (auto it = state.childMap.begin(); it != state.childMap.end(); ++it) {
         QVector<int>& children = it.value();
         std::sort(children.begin(), children.end(), [&](int a, int b) {
@@ -653,92 +1233,18 @@ ComposeResult compose(const NodeTree& tree, const Provider& prov, uint64_t viewR
         else                                        state.offsetHexDigits = 16;
     }
 
-    // Helper: compute the display type string for a node (for width calculation)
-    auto nodeTypeName = [&](const Node& n) -> QString {
-        if (n.kind == NodeKind::Array) {
-            QString sn = (n.elementKind == NodeKind::Struct)
-                ? resolvePointerTarget(tree, n.refId) : QString();
-            return fmt::arrayTypeName(n.elementKind, n.arrayLen, sn);
-        }
-        if (n.kind == NodeKind::Struct)
-            return fmt::structTypeName(n);
-        if (n.kind == NodeKind::Pointer32 || n.kind == NodeKind::Pointer64)
-            return fmt::pointerTypeName(n.kind, resolvePointerTarget(tree, n.refId));
-        return fmt::typeNameRaw(n.kind);
-    };
-
-    // Compute effective type column width from longest type name
-    // Include struct/array headers which use "struct TypeName" or "type[count]" format
-    const int typeCap = state.compactColumns ? kCompactTypeW : kMaxTypeW;
-    int maxTypeLen = kMinTypeW;
-    for (const Node& node : tree.nodes) {
-        maxTypeLen = qMax(maxTypeLen, (int)nodeTypeName(node).size());
-    }
-    state.typeW = qBound(kMinTypeW, maxTypeLen, typeCap);
-
-    // Compute effective name column width from longest name
-    // Include struct/array names - they now use columnar layout too
-    int maxNameLen = kMinNameW;
-    for (const Node& node : tree.nodes) {
-        // Skip hex (they show ASCII preview, not name column)
-        if (isHexPreview(node.kind)) continue;
-        maxNameLen = qMax(maxNameLen, (int)node.name.size());
-    }
-    state.nameW = qBound(kMinNameW, maxNameLen, kMaxNameW);
-
-    // Pre-compute per-scope widths (each container gets widths based on direct children only)
-    for (int i = 0; i < tree.nodes.size(); i++) {
-        const Node& container = tree.nodes[i];
-        if (container.kind != NodeKind::Struct && container.kind != NodeKind::Array)
-            continue;
-
-        int scopeMaxType = kMinTypeW;
-        int scopeMaxName = kMinNameW;
-
-        for (int childIdx : state.childMap.value(container.id)) {
-            const Node& child = tree.nodes[childIdx];
-            scopeMaxType = qMax(scopeMaxType, (int)nodeTypeName(child).size());
-
-            // Name width (skip hex, but include containers)
-            if (!isHexPreview(child.kind)) {
-                scopeMaxName = qMax(scopeMaxName, (int)child.name.size());
-            }
-        }
-
-        // Primitive arrays with no tree children: account for synthesized element types
-        // e.g. "uint32_t[0]", "uint32_t[99]" — longest index determines width
-        if (container.kind == NodeKind::Array
-            && state.childMap.value(container.id).isEmpty()
-            && container.elementKind != NodeKind::Struct
-            && container.elementKind != NodeKind::Array
-            && container.arrayLen > 0) {
-            int maxIdx = container.arrayLen - 1;
-            QString longestElemType = fmt::typeNameRaw(container.elementKind)
-                                    + QStringLiteral("[%1]").arg(maxIdx);
-            scopeMaxType = qMax(scopeMaxType, (int)longestElemType.size());
-        }
-
-        state.scopeTypeW[container.id] = qBound(kMinTypeW, scopeMaxType, typeCap);
-        state.scopeNameW[container.id] = qBound(kMinNameW, scopeMaxName, kMaxNameW);
-    }
-
-    // Compute scope widths for root level (parentId == 0)
-    // Include struct/array headers - they now use columnar layout too
-    {
-        int rootMaxType = kMinTypeW;
-        int rootMaxName = kMinNameW;
-        for (int childIdx : state.childMap.value(0)) {
-            const Node& child = tree.nodes[childIdx];
-            rootMaxType = qMax(rootMaxType, (int)nodeTypeName(child).size());
-
-            // Name width (skip hex, include containers)
-            if (!isHexPreview(child.kind)) {
-                rootMaxName = qMax(rootMaxName, (int)child.name.size());
-            }
-        }
-        state.scopeTypeW[0] = qBound(kMinTypeW, rootMaxType, typeCap);
-        state.scopeNameW[0] = qBound(kMinNameW, rootMaxName, kMaxNameW);
+    // Column widths: re-measure only scopes touched since the last compose
+    if (cache) {
+        updateColumnWidths(cache->widths, tree, state.childMap, opts.typeAliases, cache->dirty);
+        pruneCache(*cache, tree, prov, window);
+        cache->replayed = 0;
+        state.widths = &cache->widths;
+    } else {
+        measureAllScopes(state.ownWidths, tree, state.childMap, opts.typeAliases);
     }
+    state.typeCap = state.compactColumns ? kCompactTypeW : kMaxTypeW;
+    state.typeW = qBound(kMinTypeW, state.widths->widest.typeLen, state.typeCap);
+    state.nameW = qBound(kMinNameW, state.widths->widest.nameLen, kMaxNameW);
 
     // Emit CommandRow as line 0 (combined: source + address + root class type + name)
     const QString cmdRowText = QStringLiteral("[\u25B8] source\u25BE \u00B7 0x0 \u00B7 struct NoName {");
@@ -750,7 +1256,7 @@ ComposeResult compose(const NodeTree& tree, const Provider& prov, uint64_t viewR
         lm.lineKind  = LineKind::CommandRow;
         lm.foldLevel = SC_FOLDLEVELBASE;
         lm.foldHead  = false;
-        lm.offsetText = fmt::fmtOffsetMargin(tree.baseAddress, false, state.offsetHexDigits);
+        lm.offsetStyle = OffsetStyle::Address;
         lm.offsetAddr = tree.baseAddress;
         lm.ptrBase    = state.currentPtrBase;
         lm.markerMask = 0;
@@ -759,16 +1265,104 @@ ComposeResult compose(const NodeTree& tree, const Provider& prov, uint64_t viewR
         state.emitLine(cmdRowText, lm);
     }
 
-    const QVector<int>& roots = childIndices(state, 0);
+    // If viewRootId is set, skip roots that don't match
+    QVector<int> roots;
+    for (int idx : childIndices(state, 0)) {
+        if (viewRootId == 0 || tree.nodes[idx].id == viewRootId)
+            roots.append(idx);
+    }
 
-    for (int idx : roots) {
-        // If viewRootId is set, skip roots that don't match
-        if (viewRootId != 0 && tree.nodes[idx].id != viewRootId)
+    if (canComposeRootsInParallel(tree, roots, state, opts.parallel)) {
+        composeRootsParallel(state, tree, prov, roots);
+    } else {
+        for (int idx : roots)
+            composeNode(state, tree, prov, idx, 0);
+    }
+
+    if (cache) {
+        for (auto it = state.recorded.cbegin(); it != state.recorded.cend(); ++it)
+            cache->fragments.insert(it.key(), it.value());
+        cache->replayed = state.replayed;
+    }
+
+    return { state.text, state.meta, LayoutInfo{state.typeW, state.nameW, state.offsetHexDigits,
+                                                 tree.baseAddress, state.compactColumns} };
+}
+
+QString pointerTargetName(const NodeTree& tree, const LineMeta& lm) {
+    return resolvePointerTarget(tree, lm.ptrTargetId);
+}
+
+bool recomposeValues(ComposeResult& result, const NodeTree& tree, const Provider& prov,
+                     const ComposeOptions& opts) {
+    // Validate the whole layout before touching anything
+    for (const LineMeta& lm : result.meta) {
+        if (lm.valueLine == ValueLine::None) continue;
+        if (lm.nodeIdx < 0 || lm.nodeIdx >= tree.nodes.size()) return false;
+        const Node& node = tree.nodes[lm.nodeIdx];
+        if (node.id != lm.nodeId) return false;
+        NodeKind kind = (lm.valueLine == ValueLine::ArrayElement) ? node.elementKind : node.kind;
+        if (kind != lm.nodeKind) return false;
+        if (lm.valueLine == ValueLine::PointerHeader && !lm.foldCollapsed) {
+            const Provider& p = lm.nullValues ? nullProvider() : prov;
+            if (readPointerTarget(node, p, lm.offsetAddr) != lm.ptrTarget) return false;
+        }
+    }
+
+    const bool compact = result.layout.compactColumns;
+    const QString& old = result.text;
+    QString text;
+    text.reserve(old.size());
+    int pos = 0;
+    for (int line = 0; line < result.meta.size(); line++) {
+        int end = old.indexOf(QLatin1Char('\n'), pos);
+        if (end < 0) end = old.size();
+        if (line > 0) text += QLatin1Char('\n');
+
+        LineMeta& lm = result.meta[line];
+        lm.dataChanged = false;
+        lm.heatLevel = 0;
+        lm.changedBytes = 0;
+
+        bool rerender = lm.valueLine != ValueLine::None && lm.materialized
+            && !(lm.valueLine == ValueLine::PointerHeader && !lm.foldCollapsed);
+        if (!rerender) {
+            text.append(old.constData() + pos, end - pos);
+            pos = end + 1;
             continue;
-        composeNode(state, tree, prov, idx, 0);
+        }
+
+        const Node& node = tree.nodes[lm.nodeIdx];
+        const Provider& p = lm.nullValues ? nullProvider() : prov;
+        // Value lines always carry the 3-char fold indicator column
+        text.append(old.constData() + pos, 3);
+        if (lm.valueLine == ValueLine::PointerHeader) {
+            QString ptrTypeOverride = fmt::pointerTypeName(
+                node.kind, resolvePointerTarget(tree, node.refId));
+            fmt::appendPointerHeader(text, node, lm.depth, true, p, lm.offsetAddr,
+                                     ptrTypeOverride, lm.scopeTypeW, lm.scopeNameW,
+                                     compact);
+        } else if (lm.valueLine == ValueLine::ArrayElement) {
+            Node elem;
+            elem.kind = node.elementKind;
+            elem.offset = node.offset + lm.arrayElementIdx * sizeForKind(node.elementKind);
+            elem.parentId = node.id;
+            elem.id = 0;
+            QString elemTypeStr = kindTypeName(node.elementKind, opts.typeAliases)
+                                + QLatin1Char('[');
+            setElementIndex(elemTypeStr, elemTypeStr.size(), lm.arrayElementIdx);
+            fmt::appendNodeLine(text, elem, p, lm.offsetAddr, lm.depth, 0,
+                                {}, lm.scopeTypeW, lm.scopeNameW, elemTypeStr, compact);
+        } else {
+            fmt::appendNodeLine(text, node, p, lm.offsetAddr, lm.depth, lm.subLine,
+                                {}, lm.scopeTypeW, lm.scopeNameW,
+                                leafTypeOverride(tree, node, opts.typeAliases), compact);
+        }
+        pos = end + 1;
     }
 
-    return { state.text, state.meta, LayoutInfo{state.typeW, state.nameW, state.offsetHexDigits, tree.baseAddress} };
+    result.text = text;
+    return true;
 }
 
 QSet<uint64_t> NodeTree::normalizePreferAncestors(const QSet<uint64_t>& ids) const {
@@ -1,4 +1,8 @@
 #include "controller.h"
+#include "pointerchase.h"
+#include "refreshplan.h"
+#include "providers/coredump_provider.h"
+#include "samplerdialog.h"
 #include "addressparser.h"
 #include "typeselectorpopup.h"
 #include "providerregistry.h"
@@ -17,19 +21,12 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QSettings>
+#include <QDateTime>
 #include <QtConcurrent/QtConcurrentRun>
 #include <limits>
 
 namespace rcx {
 
-static thread_local const RcxDocument* s_composeDoc = nullptr;
-
-static QString docTypeNameProvider(NodeKind k) {
-    if (s_composeDoc) return s_composeDoc->resolveTypeName(k);
-    auto* m = kindMeta(k);
-    return m ? QString::fromLatin1(m->typeName) : QStringLiteral("???");
-}
-
 static QString elide(QString s, int max) {
     if (max <= 0) return {};
     if (s.size() <= max) return s;
@@ -43,6 +40,8 @@ static QString elideLeft(const QString& s, int max) {
     return QStringLiteral("\u2026") + s.right(max - 1);
 }
 
+// Bytes of target memory a composed line renders. Headers only read data
+// for pointers (the pointer value); footers and struct headers read none.
 static QString crumbFor(const rcx::NodeTree& t, uint64_t nodeId) {
     QStringList parts;
     QSet<uint64_t> seen;
@@ -72,8 +71,10 @@ RcxDocument::RcxDocument(QObject* parent)
     });
 }
 
-ComposeResult RcxDocument::compose(uint64_t viewRootId, bool compactColumns) const {
-    return rcx::compose(tree, *provider, viewRootId, compactColumns);
+ComposeResult RcxDocument::compose(uint64_t viewRootId, bool compactColumns,
+                                   const ComposeWindow& window, ComposeCache* cache) const {
+    return rcx::compose(tree, *provider, viewRootId, compactColumns, window, cache,
+                        composeOptions());
 }
 
 bool RcxDocument::save(const QString& path) {
@@ -124,14 +125,32 @@ bool RcxDocument::load(const QString& path) {
 }
 
 void RcxDocument::loadData(const QString& binaryPath) {
-    QFile file(binaryPath);
-    if (!file.open(QIODevice::ReadOnly))
-        return;
+    // Mapped rather than read: multi-GB dumps open at once and page in as
+    // the view touches them. Edits stay in memory, as with a buffer.
+    // ELF core files are shown at the addresses of the process that dumped
+    // them.
+    auto mapped = std::make_shared<MappedFileProvider>(binaryPath);
+    std::shared_ptr<CoreDumpProvider> core;
+    if (mapped->isOpen() && CoreDumpProvider::isCoreFile(mapped->data(), mapped->fileSize())) {
+        core = std::make_shared<CoreDumpProvider>(binaryPath);
+        if (!core->isOpen()) core.reset();
+    }
+    if (core) {
+        provider = core;
+    } else if (mapped->isOpen()) {
+        provider = mapped;
+    } else {
+        // Empty files cannot be mapped, and a 32-bit build may lack the
+        // address space for a big one
+        QFile file(binaryPath);
+        if (!file.open(QIODevice::ReadOnly) || file.size() > INT_MAX)
+            return;
+        provider = std::make_shared<BufferProvider>(
+            file.readAll(), QFileInfo(binaryPath).fileName());
+    }
     undoStack.clear();
-    provider = std::make_shared<BufferProvider>(
-        file.readAll(), QFileInfo(binaryPath).fileName());
     dataPath = binaryPath;
-    tree.baseAddress = 0;
+    tree.baseAddress = provider->base();
     emit documentChanged();
 }
 
@@ -155,7 +174,6 @@ void RcxCommand::redo() { m_ctrl->applyCommand(m_cmd, false); }
 RcxController::RcxController(RcxDocument* doc, QWidget* parent)
     : QObject(parent), m_doc(doc)
 {
-    fmt::setTypeNameProvider(docTypeNameProvider);
     connect(m_doc, &RcxDocument::documentChanged, this, &RcxController::refresh);
     setupAutoRefresh();
 }
@@ -165,6 +183,8 @@ RcxController::~RcxController() {
         m_refreshWatcher->cancel();
         m_refreshWatcher->waitForFinished();
     }
+    if (m_composeWatcher)
+        m_composeWatcher->waitForFinished();
 }
 
 RcxEditor* RcxController::primaryEditor() const {
@@ -178,6 +198,8 @@ RcxEditor* RcxController::addSplitEditor(QWidget* parent) {
 
     if (!m_lastResult.text.isEmpty()) {
         editor->applyDocument(m_lastResult);
+        if (editor->hasUnmaterializedVisibleLines())
+            scheduleWindowRefresh();
     }
     updateCommandRow();
 
@@ -332,7 +354,7 @@ void RcxController::connectEditor(RcxEditor* editor) {
 
             AddressParserCallbacks cbs;
             if (m_doc->provider) {
-                auto* prov = m_doc->provider.get();
+                auto* prov = syncProvider().get();
                 cbs.resolveModule = [prov](const QString& name, bool* ok) -> uint64_t {
                     uint64_t base = prov->symbolToAddress(name);
                     *ok = (base != 0);
@@ -464,6 +486,37 @@ void RcxController::connectEditor(RcxEditor* editor) {
     });
     connect(editor, &RcxEditor::inlineEditCancelled,
             this, [this]() { refresh(); });
+    connect(editor, &RcxEditor::unmaterializedLinesVisible,
+            this, &RcxController::scheduleWindowRefresh);
+}
+
+// Lines to materialize: what each editor shows plus a scroll margin, so
+// ordinary scrolling stays inside already-composed text.
+ComposeWindow RcxController::composeWindow() const {
+    static constexpr int kWindowMargin = 256;
+    ComposeWindow window;
+    if (m_fullCompose) return window;
+    for (auto* editor : m_editors) {
+        int first, last;
+        editor->visibleLineRange(kWindowMargin, &first, &last);
+        window.add(first, last);
+    }
+    return window;
+}
+
+// Coalesce scroll notifications into one recompose per event loop pass.
+void RcxController::scheduleWindowRefresh() {
+    if (m_windowRefreshPending) return;
+    m_windowRefreshPending = true;
+    QTimer::singleShot(0, this, [this]() {
+        m_windowRefreshPending = false;
+        if (m_suppressRefresh) return;
+        for (auto* editor : m_editors)
+            if (editor->isEditing()) return;
+        m_composeCacheTrusted = true;  // only the window moved
+        m_scheduler.wake();            // newly visible pages go first
+        refreshAsync();
+    });
 }
 
 void RcxController::setViewRootId(uint64_t id) {
@@ -487,47 +540,150 @@ void RcxController::setTrackValues(bool on) {
     }
 }
 
+// Refreshes not driven by applyCommand (loads, data ticks, direct tree
+// edits) can't say what changed: drop the cache and compose from scratch.
+// Data ticks leave names and kinds alone, so they keep the column widths.
+void RcxController::prepareComposeCache() {
+    if (!m_composeCacheTrusted) {
+        if (m_valuesOnlyRefresh)
+            m_composeCache.clearFragments();
+        else
+            m_composeCache.clear();
+    }
+    m_composeCacheTrusted = false;
+}
+
+// Data ticks only change bytes: when the last layout still fits the tree
+// and the viewport, re-format just the value columns.
+bool RcxController::tryValuesOnlyCompose(const ComposeWindow& window,
+                                         const ComposeOptions& opts) {
+    bool valuesOnly = m_valuesOnlyRefresh && m_layoutCurrent && m_snapshotProv
+                      && window == m_lastWindow
+                      && recomposeValues(m_lastResult, m_doc->tree, *m_snapshotProv, opts);
+    m_valuesOnlyRefresh = false;
+    return valuesOnly;
+}
+
 void RcxController::refresh() {
-    // Bracket compose with thread-local doc pointer for type name resolution
-    s_composeDoc = m_doc;
+    ++m_composeGen;  // a compose still running on a worker is now stale
+    m_composePending = false;
+    m_scheduler.wake();  // the layout may need pages the snapshot lacks
+    prepareComposeCache();
+
+    const ComposeWindow window = composeWindow();
+    ComposeOptions opts = m_doc->composeOptions();
+
+    // Compose against snapshot provider if active, otherwise real provider.
+    // Snapshot pages are immutable, so root structs may compose in parallel.
+    if (!tryValuesOnlyCompose(window, opts)) {
+        if (m_snapshotProv) {
+            opts.parallel = true;
+            m_lastResult = rcx::compose(m_doc->tree, *m_snapshotProv, m_viewRootId, m_compactColumns,
+                                        window, &m_composeCache, opts);
+        } else {
+            m_lastResult = m_doc->compose(m_viewRootId, m_compactColumns, window, &m_composeCache);
+        }
+        m_lastWindow = window;
+        m_layoutCurrent = true;
+    }
+    applyComposed();
+}
 
-    // Compose against snapshot provider if active, otherwise real provider
-    if (m_snapshotProv)
-        m_lastResult = rcx::compose(m_doc->tree, *m_snapshotProv, m_viewRootId, m_compactColumns);
-    else
-        m_lastResult = m_doc->compose(m_viewRootId, m_compactColumns);
+// Data ticks and scrolls on large live documents compose on a worker against
+// a copy of the tree (implicitly shared, so copying is cheap until the GUI
+// edits it) and the current snapshot; the GUI thread only applies the
+// result. Edits still go through refresh(), which bumps m_composeGen so a
+// result composed against the old tree is dropped when it lands.
+void RcxController::refreshAsync() {
+    static constexpr int kAsyncComposeMinNodes = 2048;
+    if (!m_snapshotProv || m_doc->tree.nodes.size() < kAsyncComposeMinNodes) {
+        refresh();
+        return;
+    }
+    if (m_composeWatcher->isRunning()) {
+        // Recompose once the running job lands, as a data tick (see onComposeComplete)
+        m_composePending = true;
+        m_composeCacheTrusted = false;
+        m_valuesOnlyRefresh = false;
+        return;
+    }
+
+    prepareComposeCache();
+    const ComposeWindow window = composeWindow();
+    ComposeOptions opts = m_doc->composeOptions();
+    if (tryValuesOnlyCompose(window, opts)) {
+        applyComposed();
+        return;
+    }
+
+    m_composeJobGen = m_composeGen;
+    auto snap = m_snapshotProv;
+    NodeTree tree = m_doc->tree;
+    QHash<NodeKind, QString> aliases = m_doc->typeAliases;
+    ComposeCache cache = m_composeCache;
+    uint64_t viewRootId = m_viewRootId;
+    bool compact = m_compactColumns;
+    m_composeWatcher->setFuture(QtConcurrent::run(
+        [snap, tree, aliases, cache, window, viewRootId, compact]() mutable -> ComposedDocument {
+            ComposeOptions jobOpts;
+            jobOpts.typeAliases = aliases.isEmpty() ? nullptr : &aliases;
+            jobOpts.parallel = true;
+            ComposedDocument doc;
+            doc.result = rcx::compose(tree, *snap, viewRootId, compact, window, &cache, jobOpts);
+            doc.cache = std::move(cache);
+            doc.window = window;
+            return doc;
+        }));
+}
+
+void RcxController::onComposeComplete() {
+    bool current = m_composeJobGen == m_composeGen && !m_suppressRefresh;
+    for (auto* editor : m_editors)
+        if (editor->isEditing()) current = false;
+
+    if (current) {
+        ComposedDocument doc = m_composeWatcher->result();
+        m_lastResult = std::move(doc.result);
+        m_composeCache = std::move(doc.cache);
+        m_lastWindow = doc.window;
+        m_layoutCurrent = true;
+        applyComposed();
+    }
 
-    s_composeDoc = nullptr;
+    if (m_composePending) {
+        m_composePending = false;
+        m_valuesOnlyRefresh = true;
+        refreshAsync();
+    }
+}
 
-    // Mark lines whose node data changed since last refresh
-    if (!m_changedOffsets.isEmpty()) {
+// Everything after compose: change and heat marking, selection pruning, and
+// pushing m_lastResult to the editors. Always runs on the GUI thread.
+void RcxController::applyComposed() {
+    // Mark lines whose bytes changed since last refresh
+    if (!m_changedRanges.isEmpty()) {
         for (auto& lm : m_lastResult.meta) {
+            if (!lm.materialized) continue;
             if (lm.nodeIdx < 0 || lm.nodeIdx >= m_doc->tree.nodes.size()) continue;
-            int64_t offset = m_doc->tree.computeOffset(lm.nodeIdx);
             const Node& node = m_doc->tree.nodes[lm.nodeIdx];
+            int64_t addr = static_cast<int64_t>(lm.offsetAddr);
 
             if (isHexPreview(node.kind)) {
                 // Per-byte tracking for hex preview nodes
-                int lineOff = 0;
-                int byteCount = lm.lineByteCount;
-                for (int b = 0; b < byteCount; b++) {
-                    if (m_changedOffsets.contains(offset + lineOff + b)) {
-                        lm.changedByteIndices.append(b);
-                        lm.dataChanged = true;
-                    }
+                uint8_t mask = m_changedRanges.byteMask(addr, qMin(lm.lineByteCount, 8));
+                if (mask) {
+                    lm.changedBytes |= mask;
+                    lm.dataChanged = true;
                 }
             } else {
                 // Use structSpan for containers (byteSize returns 0 for Array-of-Struct)
                 int sz = (node.kind == NodeKind::Struct || node.kind == NodeKind::Array)
                     ? m_doc->tree.structSpan(node.id) : node.byteSize();
-                for (int64_t b = offset; b < offset + sz; b++) {
-                    if (m_changedOffsets.contains(b)) {
-                        lm.dataChanged = true;
-                        break;
-                    }
-                }
+                if (m_changedRanges.intersects(addr, sz))
+                    lm.dataChanged = true;
             }
         }
+        m_changedRanges.clear();
     }
 
     // Update value history and compute heat levels
@@ -539,8 +695,12 @@ void RcxController::refresh() {
         else if (m_doc->provider && m_doc->provider->isValid() && m_doc->provider->isLive())
             prov = m_doc->provider.get();
 
-        if (m_trackValues && prov) {
+        // A rewound view shows old values: they are not new observations
+        if (m_trackValues && prov && m_historyPos < 0) {
+            const int64_t now = QDateTime::currentMSecsSinceEpoch();
+            char bytes[ValueHistory::kMaxWidth];
             for (auto& lm : m_lastResult.meta) {
+                if (!lm.materialized) continue;
                 if (lm.nodeIdx < 0 || lm.nodeIdx >= m_doc->tree.nodes.size()) continue;
                 if (isSyntheticLine(lm) || lm.isContinuation) continue;
                 if (lm.lineKind != LineKind::Field) continue;
@@ -554,14 +714,15 @@ void RcxController::refresh() {
 
                 // Use the absolute address from compose (correct for pointer-expanded nodes)
                 uint64_t addr = lm.offsetAddr;
-                int sz = node.byteSize();
+                int sz = qMin(node.byteSize(), ValueHistory::kMaxWidth);
                 if (sz <= 0 || !prov->isReadable(addr, sz)) continue;
 
-                QString val = fmt::readValue(node, *prov, addr, lm.subLine);
-                if (!val.isEmpty()) {
-                    m_valueHistory[lm.nodeId].record(val);
-                    lm.heatLevel = m_valueHistory[lm.nodeId].heatLevel();
-                }
+                // Raw bytes only; the history popup formats them when it opens.
+                // isReadable() is a hint for live targets, so a failed read
+                // records nothing rather than stale stack bytes.
+                if (!prov->read(addr, bytes, sz)) continue;
+                m_valueHistory.record(lm.nodeId, bytes, sz, now);
+                lm.heatLevel = m_valueHistory.heatLevel(lm.nodeId);
             }
         }
     }
@@ -593,7 +754,9 @@ void RcxController::refresh() {
     const Provider* snapProv = m_snapshotProv
         ? static_cast<const Provider*>(m_snapshotProv.get())
         : (m_doc->provider ? m_doc->provider.get() : nullptr);
-    const Provider* realProv = m_doc->provider ? m_doc->provider.get() : nullptr;
+    m_editorRealProv = syncProvider();
+    const Provider* realProv = m_editorRealProv.get();
+    m_editorSnapshot = m_snapshotProv;  // keep snapProv alive for the editors
 
     for (auto* editor : m_editors) {
         editor->setCustomTypeNames(customTypes);
@@ -1009,6 +1172,15 @@ void RcxController::materializeRefChildren(int nodeIdx) {
 void RcxController::applyCommand(const Command& command, bool isUndo) {
     auto& tree = m_doc->tree;
 
+    // Containers whose compose output this command invalidates; compose()
+    // extends each mark to ancestors and referencing containers.
+    auto markDirty = [&](uint64_t nodeId) { m_composeCache.markDirty(nodeId); };
+    auto markAdjsDirty = [&](const QVector<cmd::OffsetAdj>& adjs) {
+        for (const auto& adj : adjs) markDirty(adj.nodeId);
+    };
+    m_composeCacheTrusted = true;
+    m_layoutCurrent = false;
+
     // Clear value history for nodes whose effective offset changed.
     // When offsets shift (insert/delete/resize), old recorded values came from
     // a different memory address, so keeping them would show false heat.
@@ -1032,70 +1204,67 @@ void RcxController::applyCommand(const Command& command, bool isUndo) {
             int idx = tree.indexOfId(c.nodeId);
             if (idx >= 0)
                 tree.nodes[idx].kind = isUndo ? c.oldKind : c.newKind;
-            for (const auto& adj : c.offAdjs) {
-                int ai = tree.indexOfId(adj.nodeId);
-                if (ai >= 0)
-                    tree.nodes[ai].offset = isUndo ? adj.oldOffset : adj.newOffset;
-            }
+            for (const auto& adj : c.offAdjs)
+                tree.setNodeOffset(tree.indexOfId(adj.nodeId),
+                                   isUndo ? adj.oldOffset : adj.newOffset);
             // The changed node's value format changed; clear its history.
             // If offAdjs is empty (same-size change), still bump gen to
             // discard in-flight reads that would record the old format.
             if (c.offAdjs.isEmpty()) m_refreshGen++;
             m_valueHistory.remove(c.nodeId);
             clearHistoryForAdjs(c.offAdjs);
+            markDirty(c.nodeId);
+            markAdjsDirty(c.offAdjs);
         } else if constexpr (std::is_same_v<T, cmd::Rename>) {
             int idx = tree.indexOfId(c.nodeId);
             if (idx >= 0)
                 tree.nodes[idx].name = isUndo ? c.oldName : c.newName;
+            markDirty(c.nodeId);
         } else if constexpr (std::is_same_v<T, cmd::Collapse>) {
             int idx = tree.indexOfId(c.nodeId);
             if (idx >= 0)
                 tree.nodes[idx].collapsed = isUndo ? c.oldState : c.newState;
+            markDirty(c.nodeId);
         } else if constexpr (std::is_same_v<T, cmd::Insert>) {
             if (isUndo) {
                 // Revert offset adjustments
-                for (const auto& adj : c.offAdjs) {
-                    int ai = tree.indexOfId(adj.nodeId);
-                    if (ai >= 0) tree.nodes[ai].offset = adj.oldOffset;
-                }
+                for (const auto& adj : c.offAdjs)
+                    tree.setNodeOffset(tree.indexOfId(adj.nodeId), adj.oldOffset);
                 int idx = tree.indexOfId(c.node.id);
-                if (idx >= 0) {
-                    tree.nodes.remove(idx);
-                    tree.invalidateIdCache();
-                }
+                if (idx >= 0)
+                    tree.removeIndices({idx});
             } else {
                 tree.addNode(c.node);
                 // Apply offset adjustments
-                for (const auto& adj : c.offAdjs) {
-                    int ai = tree.indexOfId(adj.nodeId);
-                    if (ai >= 0) tree.nodes[ai].offset = adj.newOffset;
-                }
+                for (const auto& adj : c.offAdjs)
+                    tree.setNodeOffset(tree.indexOfId(adj.nodeId), adj.newOffset);
             }
             clearHistoryForAdjs(c.offAdjs);
+            markDirty(c.node.id);
+            markDirty(c.node.parentId);
+            markAdjsDirty(c.offAdjs);
         } else if constexpr (std::is_same_v<T, cmd::Remove>) {
+            for (const Node& n : c.subtree) {
+                markDirty(n.id);
+                markDirty(n.parentId);
+            }
+            markAdjsDirty(c.offAdjs);
             if (isUndo) {
                 // Restore nodes first
                 for (const Node& n : c.subtree)
                     tree.addNode(n);
                 // Revert offset adjustments
-                for (const auto& adj : c.offAdjs) {
-                    int ai = tree.indexOfId(adj.nodeId);
-                    if (ai >= 0) tree.nodes[ai].offset = adj.oldOffset;
-                }
+                for (const auto& adj : c.offAdjs)
+                    tree.setNodeOffset(tree.indexOfId(adj.nodeId), adj.oldOffset);
             } else {
                 // Apply offset adjustments first (before removing changes indices)
-                for (const auto& adj : c.offAdjs) {
-                    int ai = tree.indexOfId(adj.nodeId);
-                    if (ai >= 0) tree.nodes[ai].offset = adj.newOffset;
-                }
+                for (const auto& adj : c.offAdjs)
+                    tree.setNodeOffset(tree.indexOfId(adj.nodeId), adj.newOffset);
                 // Remove nodes and their value history
                 QVector<int> indices = tree.subtreeIndices(c.nodeId);
-                std::sort(indices.begin(), indices.end(), std::greater<int>());
-                for (int idx : indices) {
+                for (int idx : indices)
                     m_valueHistory.remove(tree.nodes[idx].id);
-                    tree.nodes.remove(idx);
-                }
-                tree.invalidateIdCache();
+                tree.removeIndices(indices);
             }
             // Siblings shifted — their old values are from wrong addresses
             clearHistoryForAdjs(c.offAdjs);
@@ -1103,16 +1272,20 @@ void RcxController::applyCommand(const Command& command, bool isUndo) {
             tree.baseAddress = isUndo ? c.oldBase : c.newBase;
             tree.baseAddressFormula = isUndo ? c.oldFormula : c.newFormula;
             resetSnapshot();
+            m_composeCache.clearFragments();
         } else if constexpr (std::is_same_v<T, cmd::WriteBytes>) {
             const QByteArray& bytes = isUndo ? c.oldBytes : c.newBytes;
             // Write through snapshot (patches pages only on success) or provider directly.
             // If write fails, the snapshot is NOT patched, so the next compose shows the
             // real unchanged value — no optimistic visual leak.
+            setHistoryPosition(-1);     // writes land on the live target
             bool ok = m_snapshotProv
-                ? m_snapshotProv->write(c.addr, bytes.constData(), bytes.size())
+                ? writableSnapshot()->write(c.addr, bytes.constData(), bytes.size())
                 : m_doc->provider->writeBytes(c.addr, bytes);
             if (!ok)
                 qWarning() << "WriteBytes failed at address" << QString::number(c.addr, 16);
+            m_composeCache.clearFragments();  // provider bytes changed
+            if (m_syncProv) m_syncProv->invalidate();
         } else if constexpr (std::is_same_v<T, cmd::ChangeArrayMeta>) {
             int idx = tree.indexOfId(c.nodeId);
             if (idx >= 0) {
@@ -1121,6 +1294,7 @@ void RcxController::applyCommand(const Command& command, bool isUndo) {
                 if (tree.nodes[idx].viewIndex >= tree.nodes[idx].arrayLen)
                     tree.nodes[idx].viewIndex = qMax(0, tree.nodes[idx].arrayLen - 1);
             }
+            markDirty(c.nodeId);
         } else if constexpr (std::is_same_v<T, cmd::ChangePointerRef>) {
             int idx = tree.indexOfId(c.nodeId);
             if (idx >= 0) {
@@ -1128,23 +1302,26 @@ void RcxController::applyCommand(const Command& command, bool isUndo) {
                 if (tree.nodes[idx].refId != 0)
                     tree.nodes[idx].collapsed = true;
             }
+            markDirty(c.nodeId);
         } else if constexpr (std::is_same_v<T, cmd::ChangeStructTypeName>) {
             int idx = tree.indexOfId(c.nodeId);
             if (idx >= 0)
                 tree.nodes[idx].structTypeName = isUndo ? c.oldName : c.newName;
+            markDirty(c.nodeId);
         } else if constexpr (std::is_same_v<T, cmd::ChangeClassKeyword>) {
             int idx = tree.indexOfId(c.nodeId);
             if (idx >= 0)
                 tree.nodes[idx].classKeyword = isUndo ? c.oldKeyword : c.newKeyword;
+            markDirty(c.nodeId);
         } else if constexpr (std::is_same_v<T, cmd::ChangeOffset>) {
-            int idx = tree.indexOfId(c.nodeId);
-            if (idx >= 0)
-                tree.nodes[idx].offset = isUndo ? c.oldOffset : c.newOffset;
+            tree.setNodeOffset(tree.indexOfId(c.nodeId),
+                               isUndo ? c.oldOffset : c.newOffset);
             // Node and its descendants read from a different address now
             m_refreshGen++;  // discard in-flight async read (stale layout)
             m_valueHistory.remove(c.nodeId);
             for (int ci : tree.subtreeIndices(c.nodeId))
                 m_valueHistory.remove(tree.nodes[ci].id);
+            markDirty(c.nodeId);
         }
     }, command);
 
@@ -1213,14 +1390,17 @@ void RcxController::setNodeValue(int nodeIdx, int subLine, const QString& text,
 
     // Test the write first — don't push a command that will silently fail.
     // This prevents optimistic visual updates for read-only providers.
+    // Writing while rewound returns the view to the live target first.
+    setHistoryPosition(-1);
     bool writeOk = m_snapshotProv
-        ? m_snapshotProv->write(addr, newBytes.constData(), newBytes.size())
+        ? writableSnapshot()->write(addr, newBytes.constData(), newBytes.size())
         : m_doc->provider->writeBytes(addr, newBytes);
     if (!writeOk) {
         qWarning() << "Write failed at address" << QString::number(addr, 16);
         refresh();  // refresh to show the real unchanged value
         return;
     }
+    if (m_syncProv) m_syncProv->invalidate();
 
     // Write succeeded — push undo command (redo will write again, which is harmless)
     m_doc->undoStack.push(new RcxCommand(this,
@@ -1483,6 +1663,8 @@ void RcxController::showContextMenu(RcxEditor* editor, int line, int nodeIdx,
             act->setChecked(m_trackValues);
             connect(act, &QAction::toggled, this, &RcxController::setTrackValues);
         }
+        if (m_doc->provider && m_doc->provider->isLive())
+            menu.addAction("&Sample Fields...", [this, ids]() { sampleFields(ids); });
         menu.addSeparator();
 
         // Check if all selected nodes share the same parent (required for grouping)
@@ -1641,6 +1823,16 @@ void RcxController::showContextMenu(RcxEditor* editor, int line, int nodeIdx,
             act->setChecked(m_trackValues);
             connect(act, &QAction::toggled, this, &RcxController::setTrackValues);
         }
+        if (m_doc->provider && m_doc->provider->isLive()) {
+            // An array element line samples that element, not the array
+            uint64_t sampleId = nodeId;
+            if (line >= 0 && line < m_lastResult.meta.size()) {
+                const LineMeta& lm = m_lastResult.meta[line];
+                if (lm.isArrayElement && lm.arrayElementIdx >= 0)
+                    sampleId = makeArrayElemSelId(nodeId, lm.arrayElementIdx);
+            }
+            menu.addAction("&Sample Fields...", [this, sampleId]() { sampleFields({sampleId}); });
+        }
         menu.addSeparator();
 
         // Convert to Hex nodes (decompose non-hex types into Hex64/32/16/8)
@@ -1813,7 +2005,11 @@ void RcxController::showContextMenu(RcxEditor* editor, int line, int nodeIdx,
 
     menu.addSeparator();
 
-    menu.addAction(icon("clippy.svg"), "Copy All as Text", [editor]() {
+    menu.addAction(icon("clippy.svg"), "Copy All as Text", [this, editor]() {
+        // Materialize every line first; the editor normally holds only a window
+        m_fullCompose = true;
+        refresh();
+        m_fullCompose = false;
         QApplication::clipboard()->setText(editor->textWithMargins());
     });
 
@@ -2696,8 +2892,9 @@ void RcxController::pushSavedSourcesToEditors() {
 // ── Auto-refresh ──
 
 void RcxController::setRefreshInterval(int ms) {
+    m_scheduler.setBaseInterval(ms);
     if (m_refreshTimer)
-        m_refreshTimer->setInterval(qMax(1, ms));
+        m_refreshTimer->setInterval(m_scheduler.minInterval());
 }
 
 void RcxController::setCompactColumns(bool v) {
@@ -2706,108 +2903,105 @@ void RcxController::setCompactColumns(bool v) {
 }
 
 void RcxController::setupAutoRefresh() {
-    int ms = QSettings("Reclass", "Reclass").value("refreshMs", 660).toInt();
+    // The timer only paces the scheduler; which pages a tick reads (if any)
+    // is up to m_scheduler. refreshMs is the starting interval of each page.
+    QSettings settings("Reclass", "Reclass");
+    m_scheduler.setBaseInterval(settings.value("refreshMs", 660).toInt());
+    m_scheduler.setBudget(int64_t(settings.value("refreshBudgetKBps", 8192).toInt()) * 1024);
+    m_history.setBudget(int64_t(settings.value("historyBudgetMB", 64).toInt()) * 1024 * 1024);
+    m_refreshClock.start();
     m_refreshTimer = new QTimer(this);
-    m_refreshTimer->setInterval(qMax(1, ms));
+    m_refreshTimer->setInterval(m_scheduler.minInterval());
     connect(m_refreshTimer, &QTimer::timeout, this, &RcxController::onRefreshTick);
     m_refreshTimer->start();
 
-    m_refreshWatcher = new QFutureWatcher<PageMap>(this);
-    connect(m_refreshWatcher, &QFutureWatcher<PageMap>::finished,
+    m_refreshWatcher = new QFutureWatcher<std::shared_ptr<PageRead>>(this);
+    connect(m_refreshWatcher, &QFutureWatcher<std::shared_ptr<PageRead>>::finished,
             this, &RcxController::onReadComplete);
-}
-
-// Recursively collect memory ranges for a struct and its pointer targets.
-// memBase is the absolute address where this struct's data lives.
-void RcxController::collectPointerRanges(
-        uint64_t structId, uint64_t memBase,
-        int depth, int maxDepth,
-        QSet<QPair<uint64_t,uint64_t>>& visited,
-        QVector<QPair<uint64_t,int>>& ranges) const
-{
-    if (depth >= maxDepth) return;
-    QPair<uint64_t,uint64_t> key{structId, memBase};
-    if (visited.contains(key)) return;
-    visited.insert(key);
-
-    int span = m_doc->tree.structSpan(structId);
-    if (span <= 0) return;
-    ranges.append({memBase, span});
-
-    if (!m_snapshotProv) return;
-
-    // Walk children looking for non-collapsed pointers
-    QVector<int> children = m_doc->tree.childrenOf(structId);
-    for (int ci : children) {
-        const Node& child = m_doc->tree.nodes[ci];
-        if (child.kind != NodeKind::Pointer32 && child.kind != NodeKind::Pointer64)
-            continue;
-        if (child.collapsed || child.refId == 0) continue;
-
-        uint64_t ptrAddr = memBase + child.offset;
-        int ptrSize = child.byteSize();
-        if (!m_snapshotProv->isReadable(ptrAddr, ptrSize)) continue;
-
-        uint64_t ptrVal = (child.kind == NodeKind::Pointer32)
-            ? (uint64_t)m_snapshotProv->readU32(ptrAddr)
-            : m_snapshotProv->readU64(ptrAddr);
-        if (ptrVal == 0 || ptrVal == UINT64_MAX) continue;
-
-        uint64_t pBase = ptrVal;
-        collectPointerRanges(child.refId, pBase, depth + 1, maxDepth,
-                             visited, ranges);
-    }
 
-    // Embedded struct references (struct node with refId but no own children)
-    int idx = m_doc->tree.indexOfId(structId);
-    if (idx >= 0) {
-        const Node& sn = m_doc->tree.nodes[idx];
-        if (sn.kind == NodeKind::Struct && sn.refId != 0 && children.isEmpty())
-            collectPointerRanges(sn.refId, memBase, depth, maxDepth,
-                                 visited, ranges);
-    }
+    m_composeWatcher = new QFutureWatcher<ComposedDocument>(this);
+    connect(m_composeWatcher, &QFutureWatcher<ComposedDocument>::finished,
+            this, &RcxController::onComposeComplete);
 }
 
 void RcxController::onRefreshTick() {
     if (m_readInFlight) return;
     if (!m_doc->provider || !m_doc->provider->isLive()) return;
     if (m_suppressRefresh) return;
+    const int64_t now = m_refreshClock.elapsed();
+    if (now < m_scheduler.nextDueMs(now)) return;
     for (auto* editor : m_editors)
         if (editor->isEditing()) return;
 
-    int extent = computeDataExtent();
-    if (extent <= 0) return;
-
-    // Collect all needed ranges: main struct + pointer targets (absolute addresses)
-    QVector<QPair<uint64_t,int>> ranges;
-    ranges.append({m_doc->tree.baseAddress, extent});
-
-    if (m_snapshotProv) {
-        QSet<QPair<uint64_t,uint64_t>> visited;
-        uint64_t rootId = m_viewRootId;
-        if (rootId == 0 && !m_doc->tree.nodes.isEmpty())
-            rootId = m_doc->tree.nodes[0].id;
-        collectPointerRanges(rootId, m_doc->tree.baseAddress, 0, 99, visited, ranges);
-    }
+    constexpr uint64_t kPageSize = RefreshScheduler::kPageSize;
 
     m_readInFlight = true;
     m_readGen = m_refreshGen;
 
+    // The GUI thread only hands over copies (implicitly shared until it
+    // edits them); working out what to read happens on the worker too
+    const NodeTree tree = m_doc->tree;
+    const QVector<LineMeta> meta = m_layoutCurrent ? m_lastResult.meta : QVector<LineMeta>();
+    const ComposeWindow window = composeWindow();
+    const uint64_t rootId = m_viewRootId;
+    RefreshScheduler scheduler = m_scheduler.fork();
+
     auto prov = m_doc->provider;
-    m_refreshWatcher->setFuture(QtConcurrent::run([prov, ranges]() -> PageMap {
-        constexpr uint64_t kPageSize = 4096;
-        constexpr uint64_t kPageMask = ~(kPageSize - 1);
-        PageMap pages;
-        for (const auto& r : ranges) {
-            uint64_t pageStart = r.first & kPageMask;
-            uint64_t end = r.first + r.second;
-            uint64_t pageEnd = (end + kPageSize - 1) & kPageMask;
-            for (uint64_t p = pageStart; p < pageEnd; p += kPageSize) {
-                if (!pages.contains(p))
-                    pages[p] = prov->readBytes(p, static_cast<int>(kPageSize));
-            }
-        }
-        return pages;
+    std::shared_ptr<const PageMap> prevPages = m_prevPages;
+    PageMap pages = std::move(m_readSpare);
+    m_readSpare = PageMap();
+    m_refreshWatcher->setFuture(QtConcurrent::run(
+            [prov, prevPages, tree, meta, window, rootId, now,
+             scheduler = std::move(scheduler),
+             pages = std::move(pages)]() mutable -> std::shared_ptr<PageRead> {
+        auto result = std::make_shared<PageRead>();
+        PageRead& read = *result;
+
+        // Pages behind the composed lines, on-screen ones first
+        RefreshPlan plan = planRefresh(tree, meta, window, prov->size(), kPageSize);
+        QVector<uint64_t> fetch = scheduler.plan(plan.wanted, now, plan.visible);
+        read.wanted = std::move(plan.wanted);
+        read.extent = plan.extent;
+        read.scheduler = std::move(scheduler);
+        read.pages = std::move(pages);
+        if (fetch.isEmpty()) {
+            read.identical = true;
+            return result;
+        }
+
+        // Pages come from the pool and the table from the last tick, so a
+        // steady-state read allocates nothing per page
+        read.pages.reserve(fetch.size());
+        PagePool& pool = PagePool::instance();
+        for (uint64_t p : fetch)
+            read.pages.insert(p, pool.acquire());
+
+        // One vectored read for every page; fetch is already in address
+        // order, so adjacent pages sit next to each other in the batch
+        QVector<Provider::ReadRequest> reqs;
+        reqs.reserve(fetch.size());
+        for (uint64_t p : fetch)
+            reqs.append(Provider::ReadRequest{p, read.pages.find(p)->data(), static_cast<int>(kPageSize)});
+        prov->readBatch(reqs.data(), reqs.size());
+
+        // Follow pointers out of the fresh bytes and read moved or new
+        // targets now, so expansions match their parents in this snapshot
+        const uint64_t base = tree.baseAddress
+            + (rootId ? tree.computeOffset(tree.indexOfId(rootId)) : 0);
+        chasePointers(tree, rootId, base, *prov, read.pages, prevPages.get());
+
+        // Fingerprint every page and diff only the ones whose fingerprint
+        // moved, here rather than on the GUI thread
+        read.identical = true;
+        for (auto it = read.pages.constBegin(); it != read.pages.constEnd(); ++it) {
+            uint64_t h = SnapshotProvider::pageHash(it.value());
+            read.pages.setHash(it.key(), h);
+            if (!prevPages || prevPages->hashOf(it.key()) != h)
+                read.identical = false;
+        }
+        if (!read.identical && prevPages && !prevPages->isEmpty())
+            read.changed = SnapshotProvider::changedRanges(*prevPages, read.pages);
+        return result;
     }));
 }
 
@@ -2816,9 +3010,9 @@ void RcxController::onReadComplete() {
 
     if (m_readGen != m_refreshGen) return;
 
-    PageMap newPages;
+    std::shared_ptr<PageRead> result;
     try {
-        newPages = m_refreshWatcher->result();
+        result = m_refreshWatcher->result();
     } catch (const std::exception& e) {
         qWarning() << "[Refresh] async read threw:" << e.what();
         return;
@@ -2826,82 +3020,234 @@ void RcxController::onReadComplete() {
         qWarning() << "[Refresh] async read threw unknown exception";
         return;
     }
+    if (!result) return;
+    PageRead& read = *result;
+    m_scheduler.join(std::move(read.scheduler));
+    PageMap& newPages = read.pages;
+    const bool havePrev = m_prevPages && !m_prevPages->isEmpty();
 
     // All-zero guard: if page 0 is all zeros and we already have data, discard
-    if (!m_prevPages.isEmpty() && newPages.contains(0)) {
-        const QByteArray& p0 = newPages.value(0);
-        bool allZero = true;
-        for (int i = 0; i < p0.size(); ++i) {
-            if (p0[i] != 0) { allZero = false; break; }
-        }
-        if (allZero) {
-            qDebug() << "[Refresh] discarding all-zero page-0, keeping stale snapshot";
-            return;
+    if (havePrev) {
+        if (const PageBuf* p0 = newPages.find(0)) {
+            const char* d = p0->constData();
+            bool allZero = true;
+            for (int i = 0; i < p0->size(); ++i) {
+                if (d[i] != 0) { allZero = false; break; }
+            }
+            if (allZero) {
+                qDebug() << "[Refresh] discarding all-zero page-0, keeping stale snapshot";
+                recycleReadTable(std::move(newPages));
+                return;
+            }
         }
     }
 
-    // Fast path: no changes at all
-    if (newPages == m_prevPages)
+    // Tell the scheduler which pages moved, so hot ones poll faster and
+    // static ones back off
+    const int64_t now = m_refreshClock.elapsed();
+    for (auto it = newPages.constBegin(); it != newPages.constEnd(); ++it) {
+        uint64_t prevHash = havePrev ? m_prevPages->hashOf(it.key()) : 0;
+        if (prevHash != 0)
+            m_scheduler.record(it.key(), prevHash != it.hash(), now);
+        else
+            m_scheduler.wake();  // new data may expand pointers to more pages
+    }
+
+    // Fast path: no changes at all (page fingerprints all match)
+    if (read.identical) {
+        recycleReadTable(std::move(newPages));
         return;
+    }
 
-    // Compute which byte offsets changed (for change highlighting).
-    // Skip on first snapshot — nothing to compare against.
-    m_changedOffsets.clear();
-    if (!m_prevPages.isEmpty()) {
-        for (auto it = newPages.constBegin(); it != newPages.constEnd(); ++it) {
-            uint64_t pageAddr = it.key();
-            const QByteArray& newPage = it.value();
-            auto oldIt = m_prevPages.constFind(pageAddr);
-            if (oldIt == m_prevPages.constEnd())
-                continue;   // new page, no previous data to diff against
-            const QByteArray& oldPage = oldIt.value();
-            int cmpLen = qMin(oldPage.size(), newPage.size());
-            for (int i = 0; i < cmpLen; ++i) {
-                if (oldPage[i] != newPage[i])
-                    m_changedOffsets.insert(static_cast<int64_t>(pageAddr) + i);
-            }
+    // Only the due pages were read: the rest of the snapshot carries over
+    // (sharing the pooled pages). Pages the document stopped needing are
+    // dropped.
+    if (havePrev) {
+        for (uint64_t p : read.wanted) {
+            if (newPages.contains(p)) continue;
+            if (const PageBuf* old = m_prevPages->find(p))
+                newPages.insert(p, *old, m_prevPages->hashOf(p));
         }
     }
 
-    int mainExtent = computeDataExtent();
-    m_prevPages = newPages;
+    // The worker that diffed against m_prevPages may still hold it; reuse
+    // its storage only when nobody else does
+    if (!m_prevPages || m_prevPages.use_count() > 1)
+        m_prevPages = std::make_shared<PageMap>();
+    *m_prevPages = newPages;
 
-    if (m_snapshotProv)
-        m_snapshotProv->updatePages(std::move(newPages), mainExtent);
+    // Every refresh that changed something becomes a history frame, also
+    // while the view is rewound (frame indices shift as old ones drop out)
+    if (m_history.budget() > 0) {
+        int dropped = m_history.record(newPages, QDateTime::currentMSecsSinceEpoch());
+        if (m_historyPos >= 0)
+            m_historyPos = qMax(0, m_historyPos - dropped);
+        emit historyChanged();
+    }
+    if (m_historyPos >= 0) {
+        recycleReadTable(std::move(newPages));
+        return;
+    }
+
+    // Changed ranges for highlighting (empty on the first snapshot — nothing
+    // to compare against). Ranges not yet consumed by a pending compose
+    // carry over.
+    m_changedRanges.unite(read.changed);
+
+    // A compose job or the editors may still be reading the current snapshot:
+    // swap in a new one instead of replacing its pages underneath.
+    if (m_snapshotProv && m_snapshotProv.use_count() == 1)
+        recycleReadTable(m_snapshotProv->updatePages(std::move(newPages), read.extent));
     else
-        m_snapshotProv = std::make_unique<SnapshotProvider>(
-            m_doc->provider, std::move(newPages), mainExtent);
+        m_snapshotProv = std::make_shared<SnapshotProvider>(
+            m_doc->provider, std::move(newPages), read.extent);
 
-    refresh();
-    m_changedOffsets.clear();
+    m_valuesOnlyRefresh = true;
+    refreshAsync();
 }
 
-int RcxController::computeDataExtent() const {
-    static constexpr int64_t kMaxMainExtent = 16 * 1024 * 1024; // 16 MB cap
+// Keep an emptied page table for the next read to fill: its slot array is
+// already sized for the document. Dropping its entries returns pages
+// nobody else holds to the pool.
+void RcxController::recycleReadTable(PageMap&& table) {
+    table.clear();
+    if (table.capacity() >= m_readSpare.capacity())
+        m_readSpare = std::move(table);
+}
 
-    int64_t treeExtent = 0;
-    for (int i = 0; i < m_doc->tree.nodes.size(); i++) {
-        const Node& node = m_doc->tree.nodes[i];
-        int64_t off = m_doc->tree.computeOffset(i);
-        int sz = (node.kind == NodeKind::Struct || node.kind == NodeKind::Array)
-            ? m_doc->tree.structSpan(node.id) : node.byteSize();
-        int64_t end = off + sz;
-        if (end > treeExtent) treeExtent = end;
+// Copy-on-write for the snapshot: pages shared with a running compose job
+// or the editors are never patched in place. Pages themselves stay
+// implicitly shared; only the ones written to detach.
+SnapshotProvider* RcxController::writableSnapshot() {
+    if (m_snapshotProv && m_snapshotProv.use_count() > 1)
+        m_snapshotProv = std::make_shared<SnapshotProvider>(
+            m_doc->provider, m_snapshotProv->pages(), m_snapshotProv->size());
+    return m_snapshotProv.get();
+}
+
+std::shared_ptr<Provider> RcxController::syncProvider() {
+    const std::shared_ptr<Provider>& prov = m_doc->provider;
+    if (!prov || !prov->isLive()) {
+        m_syncProv.reset();
+        return prov;
     }
-    if (treeExtent > 0) return static_cast<int>(qMin(treeExtent, kMaxMainExtent));
+    if (!m_syncProv || m_syncProv->real() != prov)
+        m_syncProv = std::make_shared<CachingProvider>(prov);
+    return m_syncProv;
+}
 
-    int provSize = m_doc->provider->size();
-    if (provSize > 0) return provSize;
-    return 0;
+int RcxController::computeDataExtent() const {
+    return mainDataExtent(m_doc->tree, m_doc->provider->size());
 }
 
 void RcxController::resetSnapshot() {
     m_refreshGen++;
+    m_composeGen++;
+    m_composePending = false;
     m_readInFlight = false;
     m_snapshotProv.reset();
-    m_prevPages.clear();
-    m_changedOffsets.clear();
+    m_prevPages.reset();
+    m_readSpare = PageMap();
+    m_changedRanges.clear();
+    m_scheduler.clear();
     m_valueHistory.clear();
+    m_history.clear();
+    m_historyPos = -1;
+    emit historyChanged();
+    PagePool::instance().trim();
+}
+
+// Show a recorded frame instead of the live snapshot (-1 returns to live).
+// The view composes from the frame's pages; refreshes keep reading and
+// recording behind it. Bytes that differ from what was on screen before
+// are highlighted, so stepping through frames shows what each one changed.
+void RcxController::setHistoryPosition(int frame) {
+    if (frame >= m_history.size()) frame = -1;
+    if (frame < -1) frame = -1;
+    if (frame == m_historyPos) return;
+    m_historyPos = frame;
+
+    PageMap pages;
+    if (frame >= 0)
+        pages = m_history.pagesAt(frame);
+    else if (m_prevPages)
+        pages = *m_prevPages;
+    if (m_snapshotProv)
+        m_changedRanges = SnapshotProvider::changedRanges(m_snapshotProv->pages(), pages);
+    m_snapshotProv = std::make_shared<SnapshotProvider>(
+        m_doc->provider, std::move(pages), computeDataExtent());
+    if (frame < 0)
+        m_scheduler.wake();
+
+    m_valuesOnlyRefresh = true;
+    refreshAsync();
+    emit historyChanged();
+}
+
+// Sample the selected scalars, and the scalars laid out inside selected
+// structs, in a window of their own. Addresses come from the composed
+// lines, so fields under expanded pointers follow the pointer; footers
+// stand for their struct, array elements for themselves.
+void RcxController::sampleFields(const QSet<uint64_t>& ids) {
+    const NodeTree& tree = m_doc->tree;
+    const auto& childMap = tree.childIndex();
+    QSet<uint64_t> wanted;
+    for (uint64_t id : ids)
+        wanted.insert((id & kFooterIdBit) ? (id & ~kFooterIdBit) : id);
+
+    QVector<SampledField> fields;
+    QSet<uint64_t> seen;        // addresses already sampled
+    auto push = [&](SampledField f) {
+        if (fields.size() >= FieldSampler::kMaxFields || seen.contains(f.addr)) return;
+        seen.insert(f.addr);
+        fields.append(std::move(f));
+    };
+    std::function<void(int, uint64_t)> add = [&](int idx, uint64_t addr) {
+        const Node& n = tree.nodes[idx];
+        if (n.kind == NodeKind::Struct) {
+            for (int ci : childMap.value(n.id)) add(ci, addr + uint64_t(tree.nodes[ci].offset));
+            return;
+        }
+        if (!FieldSampler::canSample(n)) return;
+        SampledField f;
+        f.nodeId = n.id;
+        int pi = tree.indexOfId(n.parentId);
+        f.name = pi >= 0 ? tree.nodes[pi].name + QLatin1Char('.') + n.name : n.name;
+        f.kind = n.kind;
+        f.addr = addr;
+        f.size = n.byteSize();
+        push(std::move(f));
+    };
+
+    for (const LineMeta& lm : m_lastResult.meta) {
+        if (isSyntheticLine(lm) || lm.isContinuation || lm.nullValues) continue;
+        if (lm.nodeIdx < 0 || lm.nodeIdx >= tree.nodes.size()) continue;
+        if (lm.lineKind == LineKind::Footer) continue;
+        if (lm.isArrayElement && lm.arrayElementIdx >= 0) {
+            Node elem;
+            elem.kind = lm.elementKind;
+            if (!wanted.contains(makeArrayElemSelId(lm.nodeId, lm.arrayElementIdx))
+                || !FieldSampler::canSample(elem))
+                continue;
+            SampledField f;
+            f.nodeId = lm.nodeId;
+            f.name = QStringLiteral("%1[%2]").arg(tree.nodes[lm.nodeIdx].name).arg(lm.arrayElementIdx);
+            f.kind = lm.elementKind;
+            f.addr = lm.offsetAddr;
+            f.size = sizeForKind(lm.elementKind);
+            push(std::move(f));
+            continue;
+        }
+        if (wanted.contains(lm.nodeId))
+            add(lm.nodeIdx, lm.offsetAddr);
+    }
+    if (fields.isEmpty()) return;
+    std::sort(fields.begin(), fields.end(), [](const SampledField& a, const SampledField& b) {
+        return a.addr < b.addr;
+    });
+
+    auto* dlg = new SamplerDialog(m_doc->provider, fields, primaryEditor());
+    dlg->show();
 }
 
 void RcxController::handleMarginClick(RcxEditor* editor, int margin,
@@ -1,11 +1,15 @@
 #pragma once
 #include "core.h"
 #include "editor.h"
+#include "providers/caching_provider.h"
 #include "providers/snapshot_provider.h"
+#include "providers/snapshot_history.h"
+#include "refreshscheduler.h"
 #include <QObject>
 #include <QUndoStack>
 #include <QUndoCommand>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QFutureWatcher>
 #include <QPointer>
 #include <memory>
@@ -40,7 +44,14 @@ public:
         return m ? QString::fromLatin1(m->typeName) : QStringLiteral("???");
     }
 
-    ComposeResult compose(uint64_t viewRootId = 0, bool compactColumns = false) const;
+    ComposeOptions composeOptions() const {
+        ComposeOptions opts;
+        opts.typeAliases = typeAliases.isEmpty() ? nullptr : &typeAliases;
+        return opts;
+    }
+
+    ComposeResult compose(uint64_t viewRootId = 0, bool compactColumns = false,
+                          const ComposeWindow& window = {}, ComposeCache* cache = nullptr) const;
     bool save(const QString& path);
     bool load(const QString& path);
     void loadData(const QString& binaryPath);
@@ -117,6 +128,11 @@ public:
     void applySelectionOverlays();
     QSet<uint64_t> selectedIds() const { return m_selIds; }
 
+    // Provider for one-off synchronous reads (popups, address expressions,
+    // MCP): the document's provider, behind a short-lived page cache when
+    // it is live
+    std::shared_ptr<Provider> syncProvider();
+
     void setViewRootId(uint64_t id);
     uint64_t viewRootId() const { return m_viewRootId; }
     void scrollToNodeId(uint64_t nodeId);
@@ -140,15 +156,23 @@ public:
     bool trackValues() const { return m_trackValues; }
     void setTrackValues(bool on);
 
+    // Snapshot history (live sources): past refreshes the view can be
+    // rewound to. Frame 0 is the oldest; position -1 follows the target.
+    int historySize() const { return m_history.size(); }
+    int64_t historyTime(int frame) const { return m_history.timeOf(frame); }
+    int historyPosition() const { return m_historyPos; }
+    void setHistoryPosition(int frame);
+
     // Cross-tab type visibility: point at the project's full document list
     void setProjectDocuments(QVector<RcxDocument*>* docs) { m_projectDocs = docs; }
 
     // Test accessor
-    const QHash<uint64_t, ValueHistory>& valueHistory() const { return m_valueHistory; }
+    const ValueHistory& valueHistory() const { return m_valueHistory; }
 
 signals:
     void nodeSelected(int nodeIdx);
     void selectionChanged(int count);
+    void historyChanged();
 
 private:
     RcxDocument*       m_doc;
@@ -159,6 +183,24 @@ private:
     bool               m_suppressRefresh = false;
     bool               m_compactColumns = false;
     uint64_t           m_viewRootId = 0;
+    bool               m_fullCompose = false;       // materialize every line (Copy All)
+    bool               m_windowRefreshPending = false;
+    ComposeCache       m_composeCache;              // per-container compose output
+    bool               m_composeCacheTrusted = false;  // dirty marks cover every change since last refresh
+    bool               m_valuesOnlyRefresh = false;    // data tick: try recomposeValues() first
+    bool               m_layoutCurrent = false;        // m_lastResult still matches the tree
+    ComposeWindow      m_lastWindow;                   // window m_lastResult was composed for
+
+    // ── Off-thread compose (large live documents) ──
+    struct ComposedDocument {
+        ComposeResult result;
+        ComposeCache  cache;     // the worker's copy, adopted along with the result
+        ComposeWindow window;
+    };
+    QFutureWatcher<ComposedDocument>* m_composeWatcher = nullptr;
+    uint64_t           m_composeGen = 0;      // bumped by every synchronous compose
+    uint64_t           m_composeJobGen = 0;   // m_composeGen when the running job started
+    bool               m_composePending = false;  // a refresh arrived while a job ran
 
     // ── Saved sources for quick-switch ──
     QVector<SavedSourceEntry> m_savedSources;
@@ -168,13 +210,31 @@ private:
     QPointer<TypeSelectorPopup> m_cachedPopup;
 
     // ── Auto-refresh state ──
-    using PageMap = QHash<uint64_t, QByteArray>;
+    using PageMap = SnapshotProvider::PageMap;
+    struct PageRead {
+        PageMap pages;              // fetched pages, with their fingerprints
+        ChangedRanges changed;      // against the pages the read was issued after
+        bool identical = false;     // same pages, same fingerprints as last time
+        QVector<uint64_t> wanted;   // pages the document needed when the read was planned
+        int extent = 0;             // main struct size, for the snapshot
+        RefreshScheduler scheduler; // the copy that planned this read
+    };
     QTimer*         m_refreshTimer = nullptr;
-    QFutureWatcher<PageMap>* m_refreshWatcher = nullptr;
-    std::unique_ptr<SnapshotProvider> m_snapshotProv;
-    PageMap         m_prevPages;
-    QSet<int64_t>   m_changedOffsets;
-    QHash<uint64_t, ValueHistory> m_valueHistory;
+    QElapsedTimer   m_refreshClock;
+    RefreshScheduler m_scheduler;
+    // Results travel by pointer: the future's result store keeps its own
+    // copy, which must not pin the pages or copy the table
+    QFutureWatcher<std::shared_ptr<PageRead>>* m_refreshWatcher = nullptr;
+    std::shared_ptr<SnapshotProvider> m_snapshotProv;  // shared with compose jobs
+    std::shared_ptr<SnapshotProvider> m_editorSnapshot; // what the editors' provider refs point at
+    std::shared_ptr<CachingProvider> m_syncProv;        // see syncProvider()
+    std::shared_ptr<Provider> m_editorRealProv;         // the editors' code-reading provider
+    std::shared_ptr<PageMap> m_prevPages;   // last read, shared with the next read's worker
+    PageMap         m_readSpare;        // emptied table whose storage the next read reuses
+    ChangedRanges   m_changedRanges;
+    SnapshotHistory m_history;
+    int             m_historyPos = -1;  // frame on screen, -1 = live
+    ValueHistory    m_valueHistory;
     bool            m_trackValues = false;
     uint64_t        m_refreshGen = 0;
     uint64_t        m_readGen = 0;
@@ -185,6 +245,14 @@ private:
     void connectEditor(RcxEditor* editor);
     void handleMarginClick(RcxEditor* editor, int margin, int line, Qt::KeyboardModifiers mods);
     void updateCommandRow();
+    ComposeWindow composeWindow() const;
+    void scheduleWindowRefresh();
+    void prepareComposeCache();
+    bool tryValuesOnlyCompose(const ComposeWindow& window, const ComposeOptions& opts);
+    void refreshAsync();
+    void onComposeComplete();
+    void applyComposed();
+    SnapshotProvider* writableSnapshot();
     void switchToSavedSource(int idx);
     void pushSavedSourcesToEditors();
     void showTypePopup(RcxEditor* editor, TypePopupMode mode, int nodeIdx, QPoint globalPos);
@@ -196,10 +264,8 @@ private:
     void onReadComplete();
     int  computeDataExtent() const;
     void resetSnapshot();
-    void collectPointerRanges(uint64_t structId, uint64_t memBase,
-                              int depth, int maxDepth,
-                              QSet<QPair<uint64_t,uint64_t>>& visited,
-                              QVector<QPair<uint64_t,int>>& ranges) const;
+    void recycleReadTable(PageMap&& table);
+    void sampleFields(const QSet<uint64_t>& ids);
 };
 
 } // namespace rcx
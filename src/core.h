@@ -7,9 +7,12 @@
 #include <QByteArray>
 #include <QHash>
 #include <QSet>
+#include <QVarLengthArray>
 #include <cstdint>
+#include <algorithm>
 #include <array>
 #include <memory>
+#include <type_traits>
 #include <variant>
 
 #include "providers/provider.h"
@@ -290,47 +293,79 @@ struct NodeTree {
     uint64_t      m_nextId    = 1;
     mutable QHash<uint64_t, int> m_idCache;
 
+    // Derived indices, built lazily and kept current by addNode / setNodeOffset /
+    // removeSubtree.  Code that mutates nodes[] directly (parentId, offset, removal)
+    // must call invalidateIdCache() afterwards.
+    struct ChainInfo {
+        int64_t offset = 0;   // structure-relative offset (sum of ancestor offsets)
+        int     depth  = 0;
+        uint8_t state  = 0;   // 0 = unknown, 1 = resolving, 2 = resolved
+    };
+    mutable QHash<uint64_t, QVector<int>> m_childCache;  // parentId → child indices (ascending)
+    mutable bool                          m_childCacheValid = false;
+    mutable QVector<ChainInfo>            m_chainCache;  // indexed by node index
+
     int addNode(const Node& n) {
         Node copy = n;
         if (copy.id == 0) copy.id = m_nextId++;
         else if (copy.id >= m_nextId) m_nextId = copy.id + 1;
         int idx = nodes.size();
+        if (!m_chainCache.isEmpty())
+            childIndex();  // needed below to find orphans of the new id
         nodes.append(copy);
         if (!m_idCache.isEmpty())
             m_idCache[copy.id] = idx;
+        if (!m_chainCache.isEmpty())
+            m_chainCache.append(ChainInfo{});
+        if (m_childCacheValid) {
+            m_childCache[copy.parentId].append(idx);
+            // Orphans waiting for this id now hang below it
+            if (m_childCache.contains(copy.id))
+                invalidateChain(copy.id);
+        }
         return idx;
     }
 
     // Reserve a unique ID atomically (for use before pushing undo commands)
     uint64_t reserveId() { return m_nextId++; }
 
-    void invalidateIdCache() const { m_idCache.clear(); }
+    // Drop every derived index (id lookup, child index, offset/depth cache)
+    void invalidateIdCache() const {
+        m_idCache.clear();
+        m_childCache.clear();
+        m_childCacheValid = false;
+        m_chainCache.clear();
+    }
 
     int indexOfId(uint64_t id) const {
         if (m_idCache.isEmpty() && !nodes.isEmpty()) {
+            m_idCache.reserve(nodes.size());
             for (int i = 0; i < nodes.size(); i++)
                 m_idCache[nodes[i].id] = i;
         }
         return m_idCache.value(id, -1);
     }
 
-    QVector<int> childrenOf(uint64_t parentId) const {
-        QVector<int> result;
-        for (int i = 0; i < nodes.size(); i++) {
-            if (nodes[i].parentId == parentId) result.append(i);
+    const QHash<uint64_t, QVector<int>>& childIndex() const {
+        if (!m_childCacheValid) {
+            m_childCache.clear();
+            for (int i = 0; i < nodes.size(); i++)
+                m_childCache[nodes[i].parentId].append(i);
+            m_childCacheValid = true;
         }
-        return result;
+        return m_childCache;
+    }
+
+    QVector<int> childrenOf(uint64_t parentId) const {
+        return childIndex().value(parentId);
     }
 
     // Collect node + all descendants (iterative, cycle-safe)
     QVector<int> subtreeIndices(uint64_t nodeId) const {
         int idx = indexOfId(nodeId);
         if (idx < 0) return {};
-        // Build parent→children map
-        QHash<uint64_t, QVector<int>> childMap;
-        for (int i = 0; i < nodes.size(); i++)
-            childMap[nodes[i].parentId].append(i);
-        // BFS with visited guard
+        const auto& childMap = childIndex();
+        // DFS with visited guard
         QVector<int> result;
         QSet<uint64_t> visited;
         QVector<uint64_t> stack;
@@ -339,7 +374,9 @@ struct NodeTree {
         visited.insert(nodeId);
         while (!stack.isEmpty()) {
             uint64_t pid = stack.takeLast();
-            for (int ci : childMap.value(pid)) {
+            auto it = childMap.constFind(pid);
+            if (it == childMap.constEnd()) continue;
+            for (int ci : it.value()) {
                 uint64_t cid = nodes[ci].id;
                 if (!visited.contains(cid)) {
                     visited.insert(cid);
@@ -352,6 +389,9 @@ struct NodeTree {
     }
 
     int depthOf(int idx) const {
+        if (idx < 0 || idx >= nodes.size()) return 0;
+        if (resolveChain(idx)) return m_chainCache[idx].depth;
+        // Parent cycle: walk until a node repeats (not cached)
         int d = 0;
         QSet<uint64_t> visited;
         int cur = idx;
@@ -367,6 +407,9 @@ struct NodeTree {
     }
 
     int64_t computeOffset(int idx) const {
+        if (idx < 0 || idx >= nodes.size()) return 0;
+        if (resolveChain(idx)) return m_chainCache[idx].offset;
+        // Parent cycle: sum until a node repeats (not cached)
         int64_t total = 0;
         QSet<uint64_t> visited;
         int cur = idx;
@@ -381,6 +424,72 @@ struct NodeTree {
         return total;
     }
 
+    // Change a node's offset, invalidating cached offsets of its subtree only
+    void setNodeOffset(int idx, int offset) {
+        if (idx < 0 || idx >= nodes.size() || nodes[idx].offset == offset) return;
+        nodes[idx].offset = offset;
+        if (!m_chainCache.isEmpty())
+            invalidateChain(nodes[idx].id);
+    }
+
+    // Remove a node and all its descendants in one compaction pass
+    void removeSubtree(uint64_t nodeId) {
+        removeIndices(subtreeIndices(nodeId));
+    }
+
+    // Remove the given node indices. Surviving nodes keep their cached offsets;
+    // indices in the id/child caches are remapped in place.
+    void removeIndices(QVector<int> doomed) {
+        if (doomed.isEmpty()) return;
+        std::sort(doomed.begin(), doomed.end());
+        doomed.erase(std::unique(doomed.begin(), doomed.end()), doomed.end());
+
+        // Children left behind by a removed parent become orphans
+        QVector<uint64_t> orphanParents;
+        if (!m_chainCache.isEmpty()) {
+            childIndex();
+            for (int di : doomed)
+                if (di >= 0 && di < nodes.size() && m_childCache.contains(nodes[di].id))
+                    orphanParents.append(nodes[di].id);
+        }
+
+        QVector<int> remap(nodes.size(), -1);
+        bool haveChain = !m_chainCache.isEmpty();
+        int w = 0, k = 0;
+        for (int r = 0; r < nodes.size(); r++) {
+            if (k < doomed.size() && doomed[k] == r) { k++; continue; }
+            remap[r] = w;
+            if (w != r) {
+                nodes[w] = std::move(nodes[r]);
+                if (haveChain) m_chainCache[w] = m_chainCache[r];
+            }
+            w++;
+        }
+        nodes.resize(w);
+        if (haveChain) m_chainCache.resize(w);
+
+        for (auto it = m_idCache.begin(); it != m_idCache.end(); ) {
+            int ni = remap.value(it.value(), -1);
+            if (ni < 0) it = m_idCache.erase(it);
+            else { it.value() = ni; ++it; }
+        }
+        if (m_childCacheValid) {
+            for (auto it = m_childCache.begin(); it != m_childCache.end(); ) {
+                QVector<int>& kids = it.value();
+                int kw = 0;
+                for (int ci : kids) {
+                    int ni = remap.value(ci, -1);
+                    if (ni >= 0) kids[kw++] = ni;
+                }
+                kids.resize(kw);
+                if (kids.isEmpty()) it = m_childCache.erase(it);
+                else ++it;
+            }
+        }
+        for (uint64_t pid : orphanParents)
+            invalidateChain(pid);
+    }
+
     int structSpan(uint64_t structId,
                    const QHash<uint64_t, QVector<int>>* childMap = nullptr,
                    QSet<uint64_t>* visited = nullptr) const {
@@ -413,6 +522,113 @@ struct NodeTree {
         return qMax(declaredSize, maxEnd);
     }
 
+    // structSpan() for passes that ask about many containers of a tree that
+    // does not change meanwhile: each span is worked out once and kept in
+    // `memo` (container id -> span). A container met again while its own
+    // span is being worked out (a cycle) counts as 0.
+    int structSpan(uint64_t structId, const QHash<uint64_t, QVector<int>>& childMap,
+                   QHash<uint64_t, int>& memo) const {
+        auto hit = memo.constFind(structId);
+        if (hit != memo.constEnd()) return qMax(0, hit.value());
+        int idx = indexOfId(structId);
+        if (idx < 0) return 0;
+        memo.insert(structId, -1);  // in progress
+
+        const Node& node = nodes[idx];
+        int maxEnd = 0;
+        auto kids = childMap.constFind(structId);
+        if (kids != childMap.constEnd()) {
+            for (int ci : kids.value()) {
+                const Node& c = nodes[ci];
+                int sz = (c.kind == NodeKind::Struct || c.kind == NodeKind::Array)
+                    ? structSpan(c.id, childMap, memo) : c.byteSize();
+                maxEnd = qMax(maxEnd, c.offset + sz);
+            }
+        } else if (node.kind == NodeKind::Struct && node.refId != 0) {
+            maxEnd = structSpan(node.refId, childMap, memo);
+        }
+
+        int span = qMax(node.byteSize(), maxEnd);
+        memo.insert(structId, span);
+        return span;
+    }
+
+    // End of the furthest byte any node covers, relative to baseAddress
+    int64_t dataExtent() const {
+        const auto& childMap = childIndex();
+        QHash<uint64_t, int> spans;
+        int64_t extent = 0;
+        for (int i = 0; i < nodes.size(); i++) {
+            const Node& node = nodes[i];
+            int64_t off = computeOffset(i);
+            int sz = (node.kind == NodeKind::Struct || node.kind == NodeKind::Array)
+                ? structSpan(node.id, childMap, spans) : node.byteSize();
+            extent = qMax(extent, off + sz);
+        }
+        return extent;
+    }
+
+    // Resolve (and memoize) offset/depth for idx and its uncached ancestors.
+    // Returns false if the parent chain contains a cycle.
+    bool resolveChain(int idx) const {
+        if (m_chainCache.size() != nodes.size())
+            m_chainCache = QVector<ChainInfo>(nodes.size());
+        if (m_chainCache[idx].state == 2) return true;
+
+        QVarLengthArray<int, 32> path;
+        int top = -1;  // first resolved ancestor above the path (-1 = none)
+        int cur = idx;
+        for (;;) {
+            ChainInfo& ci = m_chainCache[cur];
+            if (ci.state == 2) { top = cur; break; }
+            if (ci.state == 1) {
+                for (int p : path) m_chainCache[p].state = 0;
+                return false;
+            }
+            ci.state = 1;
+            path.append(cur);
+            const Node& n = nodes[cur];
+            if (n.parentId == 0) break;
+            int pi = indexOfId(n.parentId);
+            if (pi < 0) break;
+            cur = pi;
+        }
+        for (int i = path.size() - 1; i >= 0; i--) {
+            int ni = path[i];
+            ChainInfo& ci = m_chainCache[ni];
+            if (top >= 0) {
+                ci.offset = m_chainCache[top].offset + nodes[ni].offset;
+                ci.depth  = m_chainCache[top].depth + 1;
+            } else {
+                ci.offset = nodes[ni].offset;
+                ci.depth  = 0;
+            }
+            ci.state = 2;
+            top = ni;
+        }
+        return true;
+    }
+
+    void invalidateChain(uint64_t rootId) const {
+        if (m_chainCache.isEmpty()) return;
+        QVector<uint64_t> stack{rootId};
+        QSet<uint64_t> visited;
+        const auto& childMap = childIndex();
+        int ri = indexOfId(rootId);
+        if (ri >= 0 && ri < m_chainCache.size()) m_chainCache[ri].state = 0;
+        while (!stack.isEmpty()) {
+            uint64_t pid = stack.takeLast();
+            if (visited.contains(pid)) continue;
+            visited.insert(pid);
+            auto it = childMap.constFind(pid);
+            if (it == childMap.constEnd()) continue;
+            for (int ci : it.value()) {
+                if (ci < m_chainCache.size()) m_chainCache[ci].state = 0;
+                stack.append(nodes[ci].id);
+            }
+        }
+    }
+
     // Batch selection normalizers
     QSet<uint64_t> normalizePreferAncestors(const QSet<uint64_t>& ids) const;
     QSet<uint64_t> normalizePreferDescendants(const QSet<uint64_t>& ids) const;
@@ -445,47 +661,102 @@ struct NodeTree {
 
 };
 
-// ── Value History (ring buffer for heatmap) ──
-
-struct ValueHistory {
-    static constexpr int kCapacity = 10;
-    std::array<QString, kCapacity> values;
-    int count = 0;   // total unique values recorded
-    int head  = 0;   // next write position in ring
-
-    void record(const QString& v) {
-        if (count > 0) {
-            int last = (head + kCapacity - 1) % kCapacity;
-            if (values[last] == v) return;  // no change
+// ── Value History (raw-byte rings for heatmap) ──
+
+// Recent values of every tracked node, kept as raw bytes plus timestamps.
+// Each node owns a ring of fixed-width slots (its field's size) and a
+// parallel ring of times; a sample is only added when the bytes differ
+// from the newest one, so the per-tick check is a memcmp, not a format.
+// Rings start at one slot and double up to kCapacity, so nodes that never
+// change cost a single sample. Strings are built by whoever displays them.
+class ValueHistory {
+public:
+    static constexpr int kCapacity = 4096;   // samples kept per node
+    static constexpr int kMaxWidth = 256;    // longer fields keep their first bytes
+
+    // Record `size` bytes for the node if they differ from its newest
+    // sample. A different width (the node changed type) starts over.
+    // Returns true if a sample was added.
+    bool record(uint64_t nodeId, const void* bytes, int size, int64_t timeMs) {
+        size = qBound(0, size, kMaxWidth);
+        if (size == 0) return false;
+        Track& t = m_tracks[nodeId];
+        if (t.width != size) t = Track{size};
+        const int cap = t.times.size();
+        const int n = qMin(t.count, cap);
+        if (n > 0) {
+            int last = (t.head + cap - 1) % cap;
+            if (std::memcmp(t.bytes.constData() + size_t(last) * size, bytes, size) == 0)
+                return false;
         }
-        values[head] = v;
-        head = (head + 1) % kCapacity;
-        if (count < INT_MAX) count++;
+        if (n == cap) {
+            if (cap < kCapacity) {
+                // Not wrapped yet: growing keeps the samples in order
+                int grown = qMin(qMax(cap * 2, 1), kCapacity);
+                t.bytes.resize(grown * size);
+                t.times.resize(grown);
+                t.head = cap;
+            } else {
+                t.head %= cap;
+            }
+        }
+        std::memcpy(t.bytes.data() + size_t(t.head) * size, bytes, size);
+        t.times[t.head] = timeMs;
+        t.head = (t.head + 1) % t.times.size();
+        if (t.count < INT_MAX) t.count++;
+        return true;
     }
 
-    int uniqueCount() const { return qMin(count, kCapacity); }
-
-    // 0=static, 1=cold(2 unique), 2=warm(3-4), 3=hot(5+)
-    int heatLevel() const {
-        if (count <= 1) return 0;
-        if (count == 2) return 1;
-        if (count <= 4) return 2;
-        return 3;
+    // Changes recorded for the node, including ones that fell out of its ring
+    int count(uint64_t nodeId) const {
+        auto it = m_tracks.constFind(nodeId);
+        return it == m_tracks.constEnd() ? 0 : it->count;
+    }
+    // Samples still held (at most kCapacity)
+    int sampleCount(uint64_t nodeId) const {
+        auto it = m_tracks.constFind(nodeId);
+        return it == m_tracks.constEnd() ? 0 : qMin(it->count, int(it->times.size()));
     }
 
-    QString last() const {
-        if (count == 0) return {};
-        return values[(head + kCapacity - 1) % kCapacity];
+    // 0=static, 1=cold(2 values), 2=warm(3-4), 3=hot(5+)
+    int heatLevel(uint64_t nodeId) const {
+        int c = count(nodeId);
+        if (c <= 1) return 0;
+        if (c == 2) return 1;
+        if (c <= 4) return 2;
+        return 3;
     }
 
-    // Iterate from oldest to newest (up to uniqueCount entries)
+    // fn(const char* bytes, int size, int64_t timeMs), oldest to newest
     template<typename Fn>
-    void forEach(Fn&& fn) const {
-        int n = uniqueCount();
-        int start = (head + kCapacity - n) % kCapacity;
-        for (int i = 0; i < n; i++)
-            fn(values[(start + i) % kCapacity]);
+    void forEach(uint64_t nodeId, Fn&& fn) const {
+        auto it = m_tracks.constFind(nodeId);
+        if (it == m_tracks.constEnd()) return;
+        const Track& t = *it;
+        const int cap = t.times.size();
+        const int n = qMin(t.count, cap);
+        const int start = (t.head + cap - n) % qMax(cap, 1);
+        for (int i = 0; i < n; i++) {
+            int slot = (start + i) % cap;
+            fn(t.bytes.constData() + size_t(slot) * t.width, t.width, t.times[slot]);
+        }
     }
+
+    bool contains(uint64_t nodeId) const { return m_tracks.contains(nodeId); }
+    int  size() const { return m_tracks.size(); }
+    bool isEmpty() const { return m_tracks.isEmpty(); }
+    void remove(uint64_t nodeId) { m_tracks.remove(nodeId); }
+    void clear() { m_tracks.clear(); }
+
+private:
+    struct Track {
+        int width = 0;              // bytes per sample
+        int head  = 0;              // next slot to write
+        int count = 0;              // samples ever recorded (saturating)
+        QByteArray       bytes;     // times.size() slots of `width` bytes
+        QVector<int64_t> times;
+    };
+    QHash<uint64_t, Track> m_tracks;
 };
 
 // ── LineMeta ──
@@ -496,6 +767,21 @@ enum class LineKind : uint8_t {
     Header, Field, Continuation, Footer, ArrayElementSeparator
 };
 
+// Margin text a line shows; fmt::fmtOffsetMargin(lm, digits) formats it on demand
+enum class OffsetStyle : uint8_t {
+    None,           // blank margin
+    Address,        // offsetAddr, zero-padded hex
+    Continuation    // "  · " under a multi-line field
+};
+
+// How a line's provider-dependent text was rendered (see recomposeValues)
+enum class ValueLine : uint8_t {
+    None,           // text depends on the tree only
+    Leaf,           // fmtNodeLine for a tree node
+    ArrayElement,   // fmtNodeLine for a synthesized primitive array element
+    PointerHeader   // fmtPointerHeader; expanded headers pin the target address
+};
+
 static constexpr uint64_t kCommandRowId   = UINT64_MAX;
 static constexpr int      kCommandRowLine = 0;
 static constexpr int      kFirstDataLine  = 1;
@@ -512,41 +798,85 @@ inline int arrayElemIdxFromSelId(uint64_t selId) {
     return (int)((selId & kArrayElemMask) >> kArrayElemShift);
 }
 
+// Per-line metadata. Kept trivially copyable (no strings or containers) so a
+// million-line result is a single flat allocation and copies are a memcpy:
+// margin text and pointer target names are derived on demand.
 struct LineMeta {
-    int      nodeIdx        = -1;
     uint64_t nodeId         = 0;
+    uint64_t offsetAddr     = 0;     // Raw absolute address (for margin toggle)
+    uint64_t ptrBase        = 0;     // Pointer expansion base (non-zero = use for RVA)
+    uint64_t ptrTarget      = 0;     // expanded pointer header: address its children were laid out at
+    uint64_t ptrTargetId    = 0;     // typed pointer: target struct id (0 = void); see pointerTargetName()
+    int      nodeIdx        = -1;
     int      subLine        = 0;
     int      depth          = 0;
     int      foldLevel      = 0;
-    bool     foldHead       = false;
-    bool     foldCollapsed  = false;
-    bool     isContinuation = false;
-    bool     isRootHeader   = false;  // true for top-level struct headers (base address editable)
-    bool     isArrayHeader  = false;  // true for array headers (has <idx/count> nav)
-    LineKind lineKind       = LineKind::Field;
-    NodeKind nodeKind       = NodeKind::Int32;
-    NodeKind elementKind    = NodeKind::UInt8;  // Array element type
     int      arrayViewIdx   = 0;   // Array: current view index
     int      arrayCount     = 0;   // Array: total element count
     int      arrayElementIdx = -1; // Index of this element within parent array (-1 if not array element)
-    QString  offsetText;
-    uint64_t offsetAddr     = 0;     // Raw absolute address (for margin toggle)
-    uint64_t ptrBase        = 0;     // Pointer expansion base (non-zero = use for RVA)
     uint32_t markerMask     = 0;
-    bool     dataChanged    = false;  // true if any byte in this node changed since last refresh
     int      heatLevel      = 0;     // 0=static, 1=cold, 2=warm, 3=hot (from ValueHistory)
-    QVector<int> changedByteIndices;  // Hex preview: which byte indices (0-based) changed on this line
     int      lineByteCount  = 0;     // Hex preview: actual data byte count on this line
     int      effectiveTypeW = 14;  // Per-line type column width used for rendering
     int      effectiveNameW = 22;  // Per-line name column width used for rendering
-    QString  pointerTargetName;    // Resolved target type name for Pointer32/64 (empty = "void")
-    bool     isArrayElement  = false;  // true for synthesized primitive array element lines
+    int      scopeTypeW     = 0;   // column widths handed to fmt (before overflow widening)
+    int      scopeNameW     = 0;
+    LineKind lineKind       = LineKind::Field;
+    NodeKind nodeKind       = NodeKind::Int32;
+    NodeKind elementKind    = NodeKind::UInt8;  // Array element type
+    ValueLine valueLine     = ValueLine::None;
+    OffsetStyle offsetStyle = OffsetStyle::None;
+    uint8_t  changedBytes   = 0;     // Hex preview: bit i = byte i changed (lines hold at most 8 bytes)
+    bool     foldHead       = false;
+    bool     foldCollapsed  = false;
+    bool     isContinuation = false;
+    bool     isRootHeader   = false;  // true for top-level struct headers (base address editable)
+    bool     isArrayHeader  = false;  // true for array headers (has <idx/count> nav)
+    bool     isArrayElement = false;  // true for synthesized primitive array element lines
+    bool     dataChanged    = false;  // true if any byte in this node changed since last refresh
+    bool     materialized   = true;   // false = outside the compose window (blank text and margin)
+    bool     nullValues     = false;  // rendered through NullProvider (unreadable pointer target)
 };
+static_assert(std::is_trivially_copyable<LineMeta>::value,
+              "LineMeta must stay a flat record");
 
 inline bool isSyntheticLine(const LineMeta& lm) {
     return lm.lineKind == LineKind::CommandRow;
 }
 
+// ── Compose Window ──
+// Inclusive document line ranges whose text compose() materializes. Lines
+// outside the window still get a LineMeta (node, offset and fold mapping) but
+// skip value formatting. An empty window materializes every line.
+
+struct ComposeWindow {
+    struct Range { int first = 0; int last = -1; };
+    QVector<Range> ranges;
+
+    void add(int first, int last) { ranges.append(Range{first, last}); }
+    bool isFull() const { return ranges.isEmpty(); }
+    bool contains(int line) const {
+        if (ranges.isEmpty()) return true;
+        for (const Range& r : ranges)
+            if (line >= r.first && line <= r.last) return true;
+        return false;
+    }
+    bool containsRange(int first, int last) const {
+        if (ranges.isEmpty()) return true;
+        for (const Range& r : ranges)
+            if (first >= r.first && last <= r.last) return true;
+        return false;
+    }
+    bool operator==(const ComposeWindow& o) const {
+        if (ranges.size() != o.ranges.size()) return false;
+        for (int i = 0; i < ranges.size(); i++)
+            if (ranges[i].first != o.ranges[i].first || ranges[i].last != o.ranges[i].last)
+                return false;
+        return true;
+    }
+    bool operator!=(const ComposeWindow& o) const { return !(*this == o); }
+};
+
 // ── Layout Info ──
 
 struct LayoutInfo {
@@ -554,6 +884,7 @@ struct LayoutInfo {
     int nameW = 22;  // Effective name column width (default = kColName)
     int offsetHexDigits = 8;  // Hex digits for offset margin (4/8/12/16)
     uint64_t baseAddress = 0; // Base address for relative offset computation
+    bool compactColumns = false;
 };
 
 // ── ComposeResult ──
@@ -564,6 +895,76 @@ struct ComposeResult {
     LayoutInfo         layout;
 };
 
+// ── Compose Cache ──
+// Output of tree containers (not pointer or ref expansions) kept between
+// composes. Owners mark edited node ids dirty; compose() extends that to
+// ancestors and to every container that referenced a dirty struct, then
+// replays the remaining fragments instead of re-formatting them. Anything
+// that changes provider bytes must clearFragments(); anything that changes
+// type aliases or edits the tree behind the owner's back must clear().
+
+struct ComposeFragment {
+    struct Piece {
+        uint64_t          childId = 0;  // non-zero: replay that container's fragment
+        QString           text;         // own lines, each prefixed with '\n'
+        QVector<LineMeta> meta;
+        QVector<uint64_t> metaNodeIds;  // id behind each meta.nodeIdx (remapped on replay)
+    };
+    QVector<Piece>  pieces;
+    QSet<uint64_t>  refs;               // structs referenced here or in nested fragments
+    int  startLine         = 0;
+    int  lineCount         = 0;
+    bool fullyMaterialized = true;
+    bool setsBaseEmitted   = false;
+
+    // Compose context; a fragment is reused only under an identical one
+    int      depth           = 0;
+    uint64_t scopeId         = 0;
+    uint64_t absAddr         = 0;
+    int      typeW           = 0;   // global widths
+    int      nameW           = 0;
+    int      scopeTypeW      = 0;   // widths of the enclosing scope
+    int      scopeNameW      = 0;
+    int      offsetHexDigits = 0;
+    bool     compactColumns  = false;
+    bool     baseEmitted     = false;
+
+    bool sameContext(const ComposeFragment& o) const {
+        return depth == o.depth && scopeId == o.scopeId && absAddr == o.absAddr
+            && typeW == o.typeW && nameW == o.nameW
+            && scopeTypeW == o.scopeTypeW && scopeNameW == o.scopeNameW
+            && offsetHexDigits == o.offsetHexDigits
+            && compactColumns == o.compactColumns && baseEmitted == o.baseEmitted;
+    }
+};
+
+// Longest type and name among one scope's direct children, before clamping
+// to the column limits. Depends on names and kinds only, never on bytes.
+struct ScopeWidths {
+    int typeLen     = 0;
+    int nameLen     = 0;
+    int elemTypeLen = 0;  // primitive array: synthesized "type[N-1]" element
+};
+
+struct ColumnWidths {
+    QHash<uint64_t, ScopeWidths> scopes;  // container id (0 = root level) -> widths
+    ScopeWidths widest;                    // max over all scopes (global columns)
+    bool        valid = false;
+};
+
+struct ComposeCache {
+    QHash<uint64_t, ComposeFragment> fragments;  // container id -> fragment
+    QSet<uint64_t>  dirty;
+    ComposeWindow   window;                      // window the fragments were composed under
+    const Provider* provider = nullptr;
+    int             replayed = 0;                // fragments reused by the last compose
+    ColumnWidths    widths;                      // re-measured for dirty scopes only
+
+    void markDirty(uint64_t nodeId) { dirty.insert(nodeId); }
+    void clearFragments() { fragments.clear(); window = {}; provider = nullptr; }
+    void clear() { clearFragments(); dirty.clear(); widths = {}; }
+};
+
 // ── Command ──
 
 namespace cmd {
@@ -851,8 +1252,6 @@ struct ViewState {
 // ── Format function forward declarations ──
 
 namespace fmt {
-    using TypeNameFn = QString (*)(NodeKind);
-    void setTypeNameProvider(TypeNameFn fn);
     QString typeName(NodeKind kind, int colType = kColType);
     QString typeNameRaw(NodeKind kind);  // Unpadded type name for width calculation
     QString fmtInt8(int8_t v);
@@ -873,6 +1272,7 @@ namespace fmt {
                         const QString& comment = {}, int colType = kColType, int colName = kColName,
                         const QString& typeOverride = {}, bool compact = false);
     QString fmtOffsetMargin(uint64_t absoluteOffset, bool isContinuation, int hexDigits = 8);
+    QString fmtOffsetMargin(const LineMeta& lm, int hexDigits);  // empty for OffsetStyle::None
     QString fmtStructHeader(const Node& node, int depth, bool collapsed, int colType = kColType, int colName = kColName, bool compact = false);
     QString fmtStructFooter(const Node& node, int depth, int totalSize = -1);
     QString fmtArrayHeader(const Node& node, int depth, int viewIdx, bool collapsed, int colType = kColType, int colName = kColName, const QString& elemStructName = {}, bool compact = false);
@@ -893,11 +1293,42 @@ namespace fmt {
     QByteArray parseAsciiValue(const QString& text, int expectedSize, bool* ok);
     QString validateValue(NodeKind kind, const QString& text);
     QString fmtEnumMember(const QString& name, int64_t value, int depth, int nameW);
+
+    // In-place variants for compose(): append to `out` instead of building
+    // per-field temporaries. Output is identical to the functions above.
+    void appendIndent(QString& out, int depth);
+    void appendNodeLine(QString& out, const Node& node, const Provider& prov,
+                        uint64_t addr, int depth, int subLine = 0,
+                        const QString& comment = {}, int colType = kColType, int colName = kColName,
+                        const QString& typeOverride = {}, bool compact = false);
+    void appendPointerHeader(QString& out, const Node& node, int depth, bool collapsed,
+                             const Provider& prov, uint64_t addr,
+                             const QString& ptrTypeName, int colType = kColType,
+                             int colName = kColName, bool compact = false);
 } // namespace fmt
 
 // ── Compose function forward declaration ──
 
+// Per-document compose inputs that are not part of the tree
+struct ComposeOptions {
+    const QHash<NodeKind, QString>* typeAliases = nullptr;  // kind -> display type name
+    bool parallel = false;  // fan root structs out to the thread pool; the provider
+                            // must tolerate reads from several threads at once
+};
+
 ComposeResult compose(const NodeTree& tree, const Provider& prov, uint64_t viewRootId = 0,
-                      bool compactColumns = false);
+                      bool compactColumns = false, const ComposeWindow& window = {},
+                      ComposeCache* cache = nullptr, const ComposeOptions& opts = {});
+
+// Display name of a typed pointer line's target ("" for void / primitive pointers)
+QString pointerTargetName(const NodeTree& tree, const LineMeta& lm);
+
+// Value pass: re-read and re-format only the provider-dependent lines of a
+// previous compose() result, keeping its layout (line structure, widths,
+// fold levels, meta). Returns false and leaves the result untouched when the
+// layout no longer fits: the tree changed under it, or an expanded pointer
+// now targets another address. The caller must compose() again.
+bool recomposeValues(ComposeResult& result, const NodeTree& tree, const Provider& prov,
+                     const ComposeOptions& opts = {});
 
 } // namespace rcx
@@ -31,6 +31,52 @@ static QString getLineText(QsciScintilla* sci, int line);
 
 // ── Value history popup (styled like TypeSelectorPopup) ──
 
+// One recorded sample, served at the address it was read from. Symbols
+// still resolve through the editor's provider, so pointer samples read
+// the way the line shows them.
+class SampleProvider : public Provider {
+    const char*     m_bytes;
+    int             m_size;
+    uint64_t        m_addr;
+    const Provider* m_symbols;
+public:
+    SampleProvider(const char* bytes, int size, uint64_t addr, const Provider* symbols)
+        : m_bytes(bytes), m_size(size), m_addr(addr), m_symbols(symbols) {}
+
+    bool isReadable(uint64_t addr, int len) const override {
+        if (len <= 0) return len == 0;
+        return addr >= m_addr && addr - m_addr <= uint64_t(m_size)
+            && uint64_t(len) <= uint64_t(m_size) - (addr - m_addr);
+    }
+    bool read(uint64_t addr, void* buf, int len) const override {
+        if (!isReadable(addr, len)) return false;
+        std::memcpy(buf, m_bytes + (addr - m_addr), len);
+        return true;
+    }
+    int size() const override { return m_size; }
+    QString getSymbol(uint64_t addr) const override {
+        return m_symbols ? m_symbols->getSymbol(addr) : QString();
+    }
+};
+
+// The newest recorded values of a line's node, oldest first, formatted
+// only now. Samples whose text matches the previous one are folded.
+static QStringList historyStrings(const ValueHistory& hist, const LineMeta& lm,
+                                  const NodeTree* tree, const Provider* symbols) {
+    constexpr int kRows = 10;
+    QStringList vals;
+    if (!tree || lm.nodeIdx < 0 || lm.nodeIdx >= tree->nodes.size()) return vals;
+    const Node& node = tree->nodes[lm.nodeIdx];
+    int skip = hist.sampleCount(lm.nodeId) - kRows;
+    hist.forEach(lm.nodeId, [&](const char* bytes, int size, int64_t) {
+        if (skip-- > 0) return;
+        SampleProvider sample(bytes, size, lm.offsetAddr, symbols);
+        QString v = fmt::readValue(node, sample, lm.offsetAddr, lm.subLine);
+        if (vals.isEmpty() || vals.last() != v) vals.append(v);
+    });
+    return vals;
+}
+
 class ValueHistoryPopup : public QFrame {
     uint64_t m_nodeId = 0;
     bool     m_hasButtons = false;
@@ -50,11 +96,8 @@ public:
     uint64_t nodeId() const { return m_nodeId; }
     void setOnSet(std::function<void(const QString&)> fn) { m_onSet = std::move(fn); }
 
-    void populate(uint64_t nodeId, const ValueHistory& hist, const QFont& font,
+    void populate(uint64_t nodeId, const QStringList& vals, const QFont& font,
                   bool showButtons = false) {
-        QStringList vals;
-        hist.forEach([&](const QString& v) { vals.append(v); });
-
         if (nodeId == m_nodeId && vals == m_values
             && showButtons == m_hasButtons && isVisible())
             return;
@@ -395,6 +438,13 @@ RcxEditor::RcxEditor(QWidget* parent) : QWidget(parent) {
     m_sci->viewport()->installEventFilter(this);
     m_sci->viewport()->setMouseTracking(true);
 
+    // Scrolled outside the composed window: ask the controller for the new rows
+    connect(m_sci->verticalScrollBar(), &QScrollBar::valueChanged,
+            this, [this]() {
+        if (hasUnmaterializedVisibleLines())
+            emit unmaterializedLinesVisible();
+    });
+
     // Recalculate hover when the viewport scrolls (scrollbar drag, wheel
     // deceleration, etc.) so the highlight tracks whatever is under the cursor.
     connect(m_sci->verticalScrollBar(), &QScrollBar::valueChanged,
@@ -859,10 +909,10 @@ void RcxEditor::applyMarginText(const QVector<LineMeta>& meta) {
     m_sci->clearMarginText(-1);
 
     for (int i = 0; i < meta.size(); i++) {
-        const auto& lm = meta[i];
-        if (lm.offsetText.isEmpty()) continue;
+        QString margin = marginText(meta[i]);
+        if (margin.isEmpty()) continue;
 
-        QByteArray text = lm.offsetText.toUtf8();
+        QByteArray text = margin.toUtf8();
         m_sci->SendScintilla(QsciScintillaBase::SCI_MARGINSETTEXT,
                              (uintptr_t)i, text.constData());
         QByteArray styles(text.size(), '\0');  // style 0 = dim
@@ -871,37 +921,34 @@ void RcxEditor::applyMarginText(const QVector<LineMeta>& meta) {
     }
 }
 
+// Margin text for a line in the current offset mode, formatted on demand
+QString RcxEditor::marginText(const LineMeta& lm) const {
+    int hexDigits = m_layout.offsetHexDigits;
+    if (!m_relativeOffsets || lm.offsetStyle != OffsetStyle::Address)
+        return fmt::fmtOffsetMargin(lm, hexDigits);
+    if (lm.lineKind == LineKind::Footer ||
+        lm.lineKind == LineKind::ArrayElementSeparator ||
+        lm.lineKind == LineKind::CommandRow)
+        return QString(hexDigits + 1, ' ');
+    uint64_t rvaBase = lm.ptrBase ? lm.ptrBase : m_layout.baseAddress;
+    uint64_t rel = lm.offsetAddr >= rvaBase ? lm.offsetAddr - rvaBase : 0;
+    return (QStringLiteral("+") + QString::number(rel, 16).toUpper())
+        .rightJustified(hexDigits, ' ') + QChar(' ');
+}
+
 void RcxEditor::reformatMargins() {
     uint64_t base = m_layout.baseAddress;
-    int hexDigits = m_layout.offsetHexDigits;
 
     // ── Pass 1: margin text (global offset only) ──
     m_sci->clearMarginText(-1);
     for (int i = 0; i < m_meta.size(); i++) {
-        auto& lm = m_meta[i];
+        const auto& lm = m_meta[i];
+        if (!lm.materialized) continue;
 
-        if (lm.isContinuation) {
-            lm.offsetText = QStringLiteral("  \u00B7 ");
-        } else if (lm.offsetText.isEmpty()) {
-            continue;
-        } else if (m_relativeOffsets) {
-            if (lm.lineKind == LineKind::Footer ||
-                lm.lineKind == LineKind::ArrayElementSeparator ||
-                lm.lineKind == LineKind::CommandRow) {
-                lm.offsetText = QString(hexDigits + 1, ' ');
-            } else {
-                uint64_t rvaBase = lm.ptrBase ? lm.ptrBase : base;
-                uint64_t rel = lm.offsetAddr >= rvaBase ? lm.offsetAddr - rvaBase : 0;
-                lm.offsetText = (QStringLiteral("+") +
-                    QString::number(rel, 16).toUpper())
-                    .rightJustified(hexDigits, ' ') + QChar(' ');
-            }
-        } else {
-            lm.offsetText = QString::number(lm.offsetAddr, 16).toUpper()
-                .rightJustified(hexDigits, '0') + QChar(' ');
-        }
+        QString margin = marginText(lm);
+        if (margin.isEmpty()) continue;
 
-        QByteArray text = lm.offsetText.toUtf8();
+        QByteArray text = margin.toUtf8();
         m_sci->SendScintilla(QsciScintillaBase::SCI_MARGINSETTEXT,
                              (uintptr_t)i, text.constData());
         QByteArray styles(text.size(), '\0');
@@ -913,7 +960,7 @@ void RcxEditor::reformatMargins() {
     m_sci->setReadOnly(false);
     for (int i = 0; i < m_meta.size(); i++) {
         const auto& lm = m_meta[i];
-        if (lm.depth <= 1 || lm.isContinuation) continue;
+        if (!lm.materialized || lm.depth <= 1 || lm.isContinuation) continue;
         if (lm.lineKind != LineKind::Field && lm.lineKind != LineKind::Header)
             continue;
 
@@ -1175,6 +1222,24 @@ void RcxEditor::applyHoverHighlight() {
     }
 }
 
+void RcxEditor::visibleLineRange(int margin, int* first, int* last) const {
+    int topVisible = (int)m_sci->SendScintilla(QsciScintillaBase::SCI_GETFIRSTVISIBLELINE);
+    int onScreen = (int)m_sci->SendScintilla(QsciScintillaBase::SCI_LINESONSCREEN);
+    int top = (int)m_sci->SendScintilla(QsciScintillaBase::SCI_DOCLINEFROMVISIBLE,
+                                        (unsigned long)topVisible);
+    *first = std::max(0, top - margin);
+    *last  = top + onScreen + margin;
+}
+
+bool RcxEditor::hasUnmaterializedVisibleLines() const {
+    int first, last;
+    visibleLineRange(0, &first, &last);
+    last = std::min(last, (int)m_meta.size() - 1);
+    for (int ln = first; ln <= last; ln++)
+        if (!m_meta[ln].materialized) return true;
+    return false;
+}
+
 ViewState RcxEditor::saveViewState() const {
     ViewState vs;
     vs.scrollLine = (int)m_sci->SendScintilla(QsciScintillaBase::SCI_GETFIRSTVISIBLELINE);
@@ -2749,8 +2814,8 @@ void RcxEditor::applyHoverCursor() {
                 && m_editState.line >= 0 && m_editState.line < m_meta.size()) {
                 const LineMeta& lm = m_meta[m_editState.line];
                 if (lm.heatLevel > 0 && lm.nodeId != 0) {
-                    auto it = m_valueHistory->find(lm.nodeId);
-                    if (it != m_valueHistory->end() && it->uniqueCount() > 1) {
+                    QStringList vals = historyStrings(*m_valueHistory, lm, m_disasmTree, m_disasmProvider);
+                    if (vals.size() > 1) {
                         if (!m_historyPopup)
                             m_historyPopup = new ValueHistoryPopup(this);
                         auto* popup = static_cast<ValueHistoryPopup*>(m_historyPopup);
@@ -2763,7 +2828,7 @@ void RcxEditor::applyHoverCursor() {
                             m_sci->SendScintilla(QsciScintillaBase::SCI_REPLACESEL,
                                                  (uintptr_t)0, utf8.constData());
                         });
-                        popup->populate(lm.nodeId, *it, editorFont(), true);
+                        popup->populate(lm.nodeId, vals, editorFont(), true);
                         int px = (int)m_sci->SendScintilla(QsciScintillaBase::SCI_POINTXFROMPOSITION,
                                                            (unsigned long)0, m_editState.posStart);
                         int py = (int)m_sci->SendScintilla(QsciScintillaBase::SCI_POINTYFROMPOSITION,
@@ -2905,17 +2970,17 @@ void RcxEditor::applyHoverCursor() {
             bool skipForDisasm = isFuncPtr(lm.nodeKind)
                 || ((lm.nodeKind == NodeKind::Pointer32
                      || lm.nodeKind == NodeKind::Pointer64)
-                    && lm.pointerTargetName.isEmpty());
+                    && lm.ptrTargetId == 0);
             if (lm.heatLevel > 0 && lm.nodeId != 0 && !skipForDisasm) {
-                auto it = m_valueHistory->find(lm.nodeId);
-                if (it != m_valueHistory->end() && it->uniqueCount() > 1) {
+                QStringList vals = historyStrings(*m_valueHistory, lm, m_disasmTree, m_disasmProvider);
+                if (vals.size() > 1) {
                     QString lineText = getLineText(m_sci, h.line);
                     ColumnSpan vs = valueSpan(lm, lineText.size(), lm.effectiveTypeW, lm.effectiveNameW);
                     if (vs.valid && h.col >= vs.start && h.col < vs.end) {
                         if (!m_historyPopup)
                             m_historyPopup = new ValueHistoryPopup(this);
                         auto* popup = static_cast<ValueHistoryPopup*>(m_historyPopup);
-                        popup->populate(lm.nodeId, *it, editorFont(), false);
+                        popup->populate(lm.nodeId, vals, editorFont(), false);
                         long linePos = m_sci->SendScintilla(QsciScintillaBase::SCI_POSITIONFROMLINE,
                                                             (unsigned long)h.line);
                         long byteOff = lineText.left(vs.start).toUtf8().size();
@@ -2944,7 +3009,7 @@ void RcxEditor::applyHoverCursor() {
             bool isFP = isFuncPtr(lm.nodeKind);
             bool isVoidPtr = (lm.nodeKind == NodeKind::Pointer32
                               || lm.nodeKind == NodeKind::Pointer64)
-                             && lm.pointerTargetName.isEmpty();
+                             && lm.ptrTargetId == 0;
             if ((isFP || isVoidPtr) && lm.nodeIdx >= 0
                 && lm.nodeIdx < m_disasmTree->nodes.size()) {
                 // Check hover is over the address portion of the value column
@@ -3042,7 +3107,7 @@ void RcxEditor::applyHoverCursor() {
             const LineMeta& lm = m_meta[h.line];
             bool isTypedPtr = (lm.nodeKind == NodeKind::Pointer32
                                || lm.nodeKind == NodeKind::Pointer64)
-                              && !lm.pointerTargetName.isEmpty();
+                              && lm.ptrTargetId != 0;
             if (isTypedPtr && lm.foldCollapsed
                 && lm.nodeIdx >= 0 && lm.nodeIdx < m_disasmTree->nodes.size()) {
                 const Node& node = m_disasmTree->nodes[lm.nodeIdx];
@@ -3070,7 +3135,7 @@ void RcxEditor::applyHoverCursor() {
                                 m_structPreviewPopup = new StructPreviewPopup(this);
                             auto* popup = static_cast<StructPreviewPopup*>(m_structPreviewPopup);
                             popup->populate(lm.nodeId,
-                                lm.pointerTargetName, body, editorFont());
+                                pointerTargetName(*m_disasmTree, lm), body, editorFont());
                             long linePos = m_sci->SendScintilla(
                                 QsciScintillaBase::SCI_POSITIONFROMLINE,
                                 (unsigned long)h.line);
@@ -3269,7 +3334,7 @@ QString RcxEditor::textWithMargins() const {
     for (int i = 0; i < lineCount; i++) {
         QString margin;
         if (i < m_meta.size())
-            margin = m_meta[i].offsetText;
+            margin = marginText(m_meta[i]);
         QString lineText = getLineText(m_sci, i);
         lines.append(margin + lineText);
     }
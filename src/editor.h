@@ -31,6 +31,11 @@ public:
     QWidget* structPreviewPopup() const { return m_structPreviewPopup; }
     const LineMeta* metaForLine(int line) const;
     int currentNodeIndex() const;
+
+    // ── Virtualized compose ──
+    // Document lines currently on screen, widened by `margin` lines each way.
+    void visibleLineRange(int margin, int* first, int* last) const;
+    bool hasUnmaterializedVisibleLines() const;
     void scrollToNodeId(uint64_t nodeId);
 
     // ── Column span computation ──
@@ -56,7 +61,7 @@ public:
     // Custom type names (struct types from the tree) shown in type picker + lexer GlobalClass coloring
     QString textWithMargins() const;
     void setCustomTypeNames(const QStringList& names);
-    void setValueHistoryRef(const QHash<uint64_t, ValueHistory>* ref) { m_valueHistory = ref; }
+    void setValueHistoryRef(const ValueHistory* ref) { m_valueHistory = ref; }
     void setProviderRef(const Provider* prov, const Provider* realProv, const NodeTree* tree) {
         m_disasmProvider = prov; m_disasmRealProv = realProv; m_disasmTree = tree;
     }
@@ -75,6 +80,7 @@ signals:
     void inlineEditCancelled();
     void typeSelectorRequested();
     void typePickerRequested(EditTarget target, int nodeIdx, QPoint globalPos);
+    void unmaterializedLinesVisible();
 
 protected:
     bool eventFilter(QObject* obj, QEvent* event) override;
@@ -142,7 +148,7 @@ private:
     QVector<SavedSourceDisplay> m_savedSourceDisplay;
 
     // ── Value history ref (owned by controller) ──
-    const QHash<uint64_t, ValueHistory>* m_valueHistory = nullptr;
+    const ValueHistory* m_valueHistory = nullptr;
     QWidget* m_historyPopup = nullptr;  // ValueHistoryPopup (file-local class in editor.cpp)
     QWidget* m_disasmPopup = nullptr;   // DisasmPopup (file-local class in editor.cpp)
     QWidget* m_structPreviewPopup = nullptr; // StructPreviewPopup (file-local class in editor.cpp)
@@ -164,6 +170,7 @@ private:
 
     void applyMarginText(const QVector<LineMeta>& meta);
     void reformatMargins();
+    QString marginText(const LineMeta& lm) const;
     void applyMarkers(const QVector<LineMeta>& meta);
     void applyFoldLevels(const QVector<LineMeta>& meta);
     void applyHexDimming(const QVector<LineMeta>& meta);
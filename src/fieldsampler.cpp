@@ -0,0 +1,251 @@
+#include "fieldsampler.h"
+#include <QtEndian>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace rcx {
+
+bool FieldSampler::canSample(const Node& node) {
+    switch (node.kind) {
+    case NodeKind::Hex8:  case NodeKind::Hex16:  case NodeKind::Hex32:  case NodeKind::Hex64:
+    case NodeKind::Int8:  case NodeKind::Int16:  case NodeKind::Int32:  case NodeKind::Int64:
+    case NodeKind::UInt8: case NodeKind::UInt16: case NodeKind::UInt32: case NodeKind::UInt64:
+    case NodeKind::Float: case NodeKind::Double: case NodeKind::Bool:
+    case NodeKind::Pointer32: case NodeKind::Pointer64:
+    case NodeKind::FuncPtr32: case NodeKind::FuncPtr64:
+        return true;
+    default:
+        return false;
+    }
+}
+
+FieldSampler::FieldSampler(std::shared_ptr<Provider> prov, QVector<SampledField> fields,
+                           int rateHz, int ringCapacity)
+    : m_prov(std::move(prov))
+    , m_fields(std::move(fields))
+    , m_rateHz(qBound(1, rateHz, kMaxRateHz))
+    , m_ring(m_fields.size(), ringCapacity)
+    , m_values(m_fields.size(), 0)
+{
+    // Merge fields into as few read ranges as their layout allows: fields
+    // of one struct usually cost a single request per sample
+    QVector<int> order(m_fields.size());
+    for (int i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return m_fields[a].addr < m_fields[b].addr;
+    });
+    m_fieldOffset.resize(m_fields.size());
+    int scratch = 0;
+    for (int i : order) {
+        const SampledField& f = m_fields[i];
+        uint64_t end = f.addr + uint64_t(f.size);
+        if (!m_spans.isEmpty()) {
+            Span& last = m_spans.last();
+            uint64_t lastEnd = last.addr + uint64_t(last.len);
+            if (f.addr <= lastEnd + kMergeGap) {
+                if (end > lastEnd) {
+                    scratch += int(end - lastEnd);
+                    last.len = int(end - last.addr);
+                }
+                m_fieldOffset[i] = last.offset + int(f.addr - last.addr);
+                continue;
+            }
+        }
+        m_spans.append(Span{f.addr, f.size, scratch});
+        m_fieldOffset[i] = scratch;
+        scratch += f.size;
+    }
+    m_scratch = QByteArray(scratch, '\0');
+    for (const Span& s : m_spans)
+        m_reqs.append(Provider::ReadRequest{s.addr, m_scratch.data() + s.offset, s.len});
+}
+
+FieldSampler::~FieldSampler() {
+    stop();
+}
+
+void FieldSampler::start() {
+    if (isRunning() || m_fields.isEmpty()) return;
+    m_stop.store(false, std::memory_order_relaxed);
+    m_thread.reset(QThread::create([this]() { run(); }));
+    m_thread->setObjectName(QStringLiteral("FieldSampler"));
+    m_thread->start(QThread::TimeCriticalPriority);
+}
+
+void FieldSampler::stop() {
+    if (!m_thread) return;
+    m_stop.store(true, std::memory_order_relaxed);
+    m_thread->wait();
+    m_thread.reset();
+}
+
+void FieldSampler::sampleOnce(int64_t timeNs) {
+    // A failed read leaves a gap in the log rather than a sample of zeros
+    if (!m_prov->readBatch(m_reqs.data(), m_reqs.size())) {
+        m_failedReads.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const char* base = m_scratch.constData();
+    for (int i = 0; i < m_fields.size(); ++i) {
+        uint64_t v = 0;
+        std::memcpy(&v, base + m_fieldOffset[i], m_fields[i].size);
+        m_values[i] = qFromLittleEndian(v);
+    }
+    m_ring.push(timeNs, m_values.data());
+}
+
+// Sleep while the next sample is far off, then spin the last stretch:
+// OS sleeps are too coarse for kHz rates. A sampler that falls behind
+// (slow provider) resumes from now instead of bursting to catch up.
+void FieldSampler::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::nanoseconds(1000000000LL / m_rateHz);
+    const auto origin = Clock::now();
+    auto next = origin;
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        auto now = Clock::now();
+        sampleOnce(std::chrono::duration_cast<std::chrono::nanoseconds>(now - origin).count());
+
+        next += period;
+        now = Clock::now();
+        if (next < now) next = now;
+        while (now < next && !m_stop.load(std::memory_order_relaxed)) {
+            auto left = next - now;
+            if (left > std::chrono::milliseconds(2))
+                std::this_thread::sleep_for(left - std::chrono::milliseconds(1));
+            else
+                std::this_thread::yield();
+            now = Clock::now();
+        }
+    }
+}
+
+// ── Sample values ──
+
+static int64_t signExtend(uint64_t raw, int size) {
+    if (size >= 8) return int64_t(raw);
+    const int shift = 64 - size * 8;
+    return int64_t(raw << shift) >> shift;
+}
+
+QString formatSample(NodeKind kind, int size, uint64_t raw) {
+    switch (kind) {
+    case NodeKind::Int8: case NodeKind::Int16: case NodeKind::Int32: case NodeKind::Int64:
+        return QString::number(signExtend(raw, size));
+    case NodeKind::UInt8: case NodeKind::UInt16: case NodeKind::UInt32: case NodeKind::UInt64:
+        return QString::number(raw);
+    case NodeKind::Float: {
+        float f;
+        uint32_t bits = uint32_t(raw);
+        std::memcpy(&f, &bits, 4);
+        return QString::number(double(f), 'g', 9);
+    }
+    case NodeKind::Double: {
+        double d;
+        std::memcpy(&d, &raw, 8);
+        return QString::number(d, 'g', 17);
+    }
+    case NodeKind::Bool:
+        return raw ? QStringLiteral("true") : QStringLiteral("false");
+    default:
+        return QStringLiteral("0x") + QString::number(raw, 16).toUpper();
+    }
+}
+
+double sampleValue(NodeKind kind, int size, uint64_t raw) {
+    switch (kind) {
+    case NodeKind::Int8: case NodeKind::Int16: case NodeKind::Int32: case NodeKind::Int64:
+        return double(signExtend(raw, size));
+    case NodeKind::Float: {
+        float f;
+        uint32_t bits = uint32_t(raw);
+        std::memcpy(&f, &bits, 4);
+        return double(f);
+    }
+    case NodeKind::Double: {
+        double d;
+        std::memcpy(&d, &raw, 8);
+        return d;
+    }
+    default:
+        return double(raw);
+    }
+}
+
+// ── SampleLog ──
+
+void SampleLog::clear() {
+    m_times.clear();
+    for (auto& c : m_columns) c.clear();
+}
+
+void SampleLog::append(int64_t timeNs, const uint64_t* values) {
+    if (m_times.size() >= kMaxSamples) {
+        const int drop = kMaxSamples / 4;
+        m_times.remove(0, drop);
+        for (auto& c : m_columns) c.remove(0, drop);
+    }
+    m_times.append(timeNs);
+    for (int i = 0; i < m_columns.size(); ++i)
+        m_columns[i].append(values[i]);
+}
+
+bool SampleLog::writeCsv(QIODevice& out, const QVector<SampledField>& fields) const {
+    QByteArray line = "time_ns";
+    for (const auto& f : fields) {
+        QString name = f.name;
+        name.replace(QLatin1Char('"'), QLatin1String("\"\""));
+        line += ",\"" + name.toUtf8() + '"';
+    }
+    line += '\n';
+    if (out.write(line) != line.size()) return false;
+
+    // Written in chunks: a full log is tens of megabytes of text
+    QByteArray chunk;
+    for (int r = 0; r < m_times.size(); ++r) {
+        chunk += QByteArray::number(qlonglong(m_times[r]));
+        for (int c = 0; c < m_columns.size() && c < fields.size(); ++c) {
+            chunk += ',';
+            chunk += formatSample(fields[c].kind, fields[c].size, m_columns[c][r]).toUtf8();
+        }
+        chunk += '\n';
+        if (chunk.size() >= (1 << 16) || r + 1 == m_times.size()) {
+            if (out.write(chunk) != chunk.size()) return false;
+            chunk.clear();
+        }
+    }
+    return true;
+}
+
+bool SampleLog::writeBinary(QIODevice& out, const QVector<SampledField>& fields) const {
+    QByteArray buf("RCXSMPL1");
+    auto put = [&buf](auto v) {
+        v = qToLittleEndian(v);
+        buf.append(reinterpret_cast<const char*>(&v), int(sizeof(v)));
+    };
+    const int n = qMin(fields.size(), m_columns.size());
+    put(uint32_t(n));
+    put(uint64_t(m_times.size()));
+    for (int c = 0; c < n; ++c) {
+        const QByteArray name = fields[c].name.toUtf8();
+        put(fields[c].addr);
+        put(uint8_t(fields[c].kind));
+        put(uint8_t(fields[c].size));
+        put(uint16_t(name.size()));
+        buf += name;
+    }
+    for (int r = 0; r < m_times.size(); ++r) {
+        put(m_times[r]);
+        for (int c = 0; c < n; ++c)
+            put(m_columns[c][r]);
+        if (buf.size() >= (1 << 16) || r + 1 == m_times.size()) {
+            if (out.write(buf) != buf.size()) return false;
+            buf.clear();
+        }
+    }
+    if (!buf.isEmpty() && out.write(buf) != buf.size()) return false;
+    return true;
+}
+
+} // namespace rcx
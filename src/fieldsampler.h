@@ -0,0 +1,164 @@
+#pragma once
+#include "core.h"
+#include <QIODevice>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace rcx {
+
+// One field the sampler watches: a scalar of at most 8 bytes at a fixed
+// address
+struct SampledField {
+    uint64_t nodeId = 0;
+    QString  name;
+    NodeKind kind = NodeKind::Hex32;
+    uint64_t addr = 0;
+    int      size = 0;
+};
+
+// Single-producer, single-consumer ring of sample records: the sampler
+// thread pushes, the GUI drains, and neither waits on the other. When the
+// consumer falls behind, the producer drops new records and counts them
+// instead of blocking.
+class SampleRing {
+public:
+    SampleRing(int fields, int capacity) : m_fields(fields), m_stride(1 + fields) {
+        int cap = 1;
+        while (cap < capacity) cap <<= 1;
+        m_mask = uint64_t(cap - 1);
+        m_slots.resize(size_t(cap) * m_stride);
+    }
+
+    int fieldCount() const { return m_fields; }
+    int capacity() const { return int(m_mask + 1); }
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Producer side. False (and counted) when the ring is full.
+    bool push(int64_t timeNs, const uint64_t* values) {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        uint64_t* rec = m_slots.data() + size_t(head & m_mask) * m_stride;
+        rec[0] = uint64_t(timeNs);
+        std::memcpy(rec + 1, values, sizeof(uint64_t) * m_fields);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: fn(int64_t timeNs, const uint64_t* values) for every
+    // record pushed so far, oldest first. Returns how many were drained.
+    template<typename Fn>
+    int drain(Fn&& fn) {
+        const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        const uint64_t head = m_head.load(std::memory_order_acquire);
+        for (uint64_t i = tail; i != head; ++i) {
+            const uint64_t* rec = m_slots.data() + size_t(i & m_mask) * m_stride;
+            fn(int64_t(rec[0]), rec + 1);
+        }
+        m_tail.store(head, std::memory_order_release);
+        return int(head - tail);
+    }
+
+private:
+    int m_fields;
+    int m_stride;                       // time, then one value per field
+    uint64_t m_mask = 0;
+    std::vector<uint64_t> m_slots;
+    alignas(64) std::atomic<uint64_t> m_head{0};    // written by the producer
+    alignas(64) std::atomic<uint64_t> m_tail{0};    // written by the consumer
+    alignas(64) std::atomic<uint64_t> m_dropped{0};
+};
+
+// Reads a fixed set of fields at a fixed rate on a thread of its own, well
+// above the refresh rate and without compose: one batched provider read per
+// sample, with neighbouring fields sharing a range. Samples land in ring()
+// for the GUI to drain.
+class FieldSampler {
+public:
+    static constexpr int kMaxRateHz   = 10000;
+    static constexpr int kMaxFields   = 64;
+    static constexpr int kMergeGap    = 64;     // join fields closer than this into one read
+
+    // Scalars only: what fits one 8-byte sample slot
+    static bool canSample(const Node& node);
+
+    FieldSampler(std::shared_ptr<Provider> prov, QVector<SampledField> fields,
+                 int rateHz, int ringCapacity = 1 << 16);
+    ~FieldSampler();
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_thread && m_thread->isRunning(); }
+
+    const QVector<SampledField>& fields() const { return m_fields; }
+    int rateHz() const { return m_rateHz; }
+    SampleRing& ring() { return m_ring; }
+    uint64_t failedReads() const { return m_failedReads.load(std::memory_order_relaxed); }
+
+    // Number of provider read ranges one sample takes (after merging)
+    int spanCount() const { return m_spans.size(); }
+
+    // Take one sample now, on the calling thread (the thread loop's body).
+    // Nothing is pushed when the read fails; failedReads() counts those.
+    void sampleOnce(int64_t timeNs);
+
+private:
+    struct Span {
+        uint64_t addr;
+        int      len;
+        int      offset;    // into m_scratch
+    };
+
+    std::shared_ptr<Provider> m_prov;
+    QVector<SampledField> m_fields;
+    int m_rateHz;
+    SampleRing m_ring;
+    QVector<Span> m_spans;
+    QVector<int>  m_fieldOffset;    // each field's bytes in m_scratch
+    QByteArray    m_scratch;
+    QVector<Provider::ReadRequest> m_reqs;
+    std::vector<uint64_t> m_values;
+    std::unique_ptr<QThread> m_thread;
+    std::atomic<bool> m_stop{false};
+    std::atomic<uint64_t> m_failedReads{0};
+
+    void run();
+};
+
+// A raw sample as text (CSV cells, sparkline labels) and as a number
+// (sparkline scale)
+QString formatSample(NodeKind kind, int size, uint64_t raw);
+double  sampleValue(NodeKind kind, int size, uint64_t raw);
+
+// Samples drained from a ring, one column per field, for display and
+// export. Holds at most kMaxSamples; beyond that the oldest quarter goes.
+class SampleLog {
+public:
+    static constexpr int kMaxSamples = 1 << 20;
+
+    explicit SampleLog(int fields = 0) : m_columns(fields) {}
+
+    int  size() const { return m_times.size(); }
+    int  fieldCount() const { return m_columns.size(); }
+    void clear();
+    void append(int64_t timeNs, const uint64_t* values);
+
+    const QVector<int64_t>&  times() const { return m_times; }
+    const QVector<uint64_t>& column(int field) const { return m_columns[field]; }
+
+    // time_ns followed by one column per field, values as formatSample()
+    bool writeCsv(QIODevice& out, const QVector<SampledField>& fields) const;
+    // "RCXSMPL1", field table, then fixed-size little-endian records
+    // (int64 time_ns + one uint64 per field)
+    bool writeBinary(QIODevice& out, const QVector<SampledField>& fields) const;
+
+private:
+    QVector<int64_t> m_times;
+    QVector<QVector<uint64_t>> m_columns;
+};
+
+} // namespace rcx
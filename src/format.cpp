@@ -1,5 +1,6 @@
 #include "core.h"
 #include "addressparser.h"
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <limits>
@@ -31,24 +32,43 @@ static QString fitOverflow(const QString& s, int w) {
     return s;
 }
 
-// ── Type name ──
+// In-place counterpart of fit(): pad or ellipsize whatever was appended to
+// `out` since `from` to exactly w characters.
+static void fitTail(QString& out, int from, int w) {
+    int len = out.size() - from;
+    if (w <= 0) { out.truncate(from); return; }
+    if (len > w) {
+        out.truncate(from + (w >= 2 ? w - 1 : w));
+        if (w >= 2) out += QChar(0x2026); // ellipsis
+        return;
+    }
+    if (len < w) out.resize(from + w, QLatin1Char(' '));
+}
 
-// Override seam: injectable type-name provider
-static TypeNameFn g_typeNameFn = nullptr;
+// Hex digits of v written backwards ending at `end`; returns the digit count
+static int writeHex(QChar* end, uint64_t v, bool upper) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    int n = 0;
+    do {
+        *--end = QLatin1Char(digits[v & 0xF]);
+        v >>= 4;
+        n++;
+    } while (v);
+    return n;
+}
 
-void setTypeNameProvider(TypeNameFn fn) { g_typeNameFn = fn; }
+// ── Type name ──
+// Built-in names only; per-document aliases are resolved by compose() and
+// reach the line formatters as a type override.
 
 // Unpadded type name for width calculation
 QString typeNameRaw(NodeKind kind) {
-    if (g_typeNameFn) return g_typeNameFn(kind);
     auto* m = kindMeta(kind);
     return m ? QString::fromLatin1(m->typeName) : QStringLiteral("???");
 }
 
 QString typeName(NodeKind kind, int colType) {
-    if (g_typeNameFn) return fit(g_typeNameFn(kind), colType);
-    auto* m = kindMeta(kind);
-    return fit(m ? QString::fromLatin1(m->typeName) : QStringLiteral("???"), colType);
+    return fit(typeNameRaw(kind), colType);
 }
 
 // Array type string: "uint32_t[16]" or "Material[2]"
@@ -137,12 +157,30 @@ QString indent(int depth) {
     return QString(depth * 3, ' ');
 }
 
+void appendIndent(QString& out, int depth) {
+    if (depth > 0) out.resize(out.size() + depth * 3, QLatin1Char(' '));
+}
+
 // ── Offset margin ──
 
 QString fmtOffsetMargin(uint64_t absoluteOffset, bool isContinuation, int hexDigits) {
     if (isContinuation) return QStringLiteral("  \u00B7 ");
-    return QString::number(absoluteOffset, 16).toUpper()
-               .rightJustified(hexDigits, '0') + QChar(' ');
+    // Upper-case digits, zero-padded to the tier width, built in one allocation
+    QChar buf[16];
+    int n = writeHex(buf + 16, absoluteOffset, true);
+    QString out(qMax(hexDigits, n) + 1, QLatin1Char('0'));
+    std::copy(buf + 16 - n, buf + 16, out.data() + out.size() - 1 - n);
+    out[out.size() - 1] = QLatin1Char(' ');
+    return out;
+}
+
+QString fmtOffsetMargin(const LineMeta& lm, int hexDigits) {
+    switch (lm.offsetStyle) {
+    case OffsetStyle::Address:      return fmtOffsetMargin(lm.offsetAddr, false, hexDigits);
+    case OffsetStyle::Continuation: return fmtOffsetMargin(lm.offsetAddr, true, hexDigits);
+    case OffsetStyle::None:         break;
+    }
+    return {};
 }
 
 // ── Struct type name (for width calculation) ──
@@ -190,20 +228,10 @@ QString fmtPointerHeader(const Node& node, int depth, bool collapsed,
                          const Provider& prov, uint64_t addr,
                          const QString& ptrTypeName, int colType, int colName,
                          bool compact) {
-    QString ind = indent(depth);
-    bool overflow = compact && ptrTypeName.size() > colType;
-    QString type = compact ? fitOverflow(ptrTypeName, colType) : fit(ptrTypeName, colType);
-    if (collapsed) {
-        if (overflow) {
-            // Overflow: no column padding
-            return ind + type + SEP + node.name + SEP + readValue(node, prov, addr, 0);
-        }
-        // Collapsed: show pointer value instead of brace (name padded for value alignment)
-        QString name = fit(node.name, colName);
-        QString val = fit(readValue(node, prov, addr, 0), COL_VALUE);
-        return ind + type + SEP + name + SEP + val;
-    }
-    return ind + type + SEP + node.name + SEP + QStringLiteral("{");
+    QString out;
+    appendPointerHeader(out, node, depth, collapsed, prov, addr, ptrTypeName,
+                        colType, colName, compact);
+    return out;
 }
 
 // ── Hex / ASCII preview ──
@@ -381,52 +409,190 @@ QString readValue(const Node& node, const Provider& prov,
     return readValueImpl(node, prov, addr, subLine, ValueMode::Display);
 }
 
-// ── Full node line ──
+// ── In-place line building ──
+// compose() formats straight into its output buffer. These append to `out`
+// without per-field temporaries and must render exactly what the
+// QString-returning wrappers above and below return.
 
-QString fmtNodeLine(const Node& node, const Provider& prov,
-                    uint64_t addr, int depth, int subLine,
-                    const QString& comment, int colType, int colName,
-                    const QString& typeOverride, bool compact) {
-    QString ind = indent(depth);
+static void appendHexVal(QString& out, uint64_t v) {
+    QChar buf[16];
+    int n = writeHex(buf + 16, v, false);
+    out += QLatin1String("0x");
+    out.append(buf + 16 - n, n);
+}
 
-    // Compute raw type string for overflow detection
-    QString rawType = typeOverride.isEmpty() ? typeNameRaw(node.kind) : typeOverride;
-    bool overflow = compact && rawType.size() > colType;
+static void appendPointerVal(QString& out, uint64_t v, const Provider& prov) {
+    if (v == 0) {
+        out += QLatin1String("-> NULL");
+    } else {
+        out += QLatin1String("-> ");
+        appendHexVal(out, v);
+    }
+    QString sym = prov.getSymbol(v);
+    if (!sym.isEmpty()) {
+        out += QLatin1String("  // ");
+        out += sym;
+    }
+}
+
+// Display value (readValue) for the common scalar kinds; everything else
+// goes through readValueImpl.
+static void appendValue(QString& out, const Node& node, const Provider& prov,
+                        uint64_t addr, int subLine) {
+    switch (node.kind) {
+    case NodeKind::Hex8:  case NodeKind::Int8:  case NodeKind::UInt8:
+        appendHexVal(out, prov.readU8(addr));  return;
+    case NodeKind::Hex16: case NodeKind::Int16: case NodeKind::UInt16:
+        appendHexVal(out, prov.readU16(addr)); return;
+    case NodeKind::Hex32: case NodeKind::Int32: case NodeKind::UInt32:
+        appendHexVal(out, prov.readU32(addr)); return;
+    case NodeKind::Hex64: case NodeKind::Int64: case NodeKind::UInt64:
+        appendHexVal(out, prov.readU64(addr)); return;
+    case NodeKind::Bool:
+        out += prov.readU8(addr) ? QLatin1String("true") : QLatin1String("false");
+        return;
+    case NodeKind::Pointer32:
+    case NodeKind::FuncPtr32:
+        appendPointerVal(out, prov.readU32(addr), prov);
+        return;
+    case NodeKind::FuncPtr64:
+        appendPointerVal(out, prov.readU64(addr), prov);
+        return;
+    case NodeKind::Pointer64:
+        // Primitive pointers dereference their target: keep the slow path
+        if (node.ptrDepth > 0 && isValidPrimitivePtrTarget(node.elementKind)) break;
+        appendPointerVal(out, prov.readU64(addr), prov);
+        return;
+    default:
+        break;
+    }
+    out += readValueImpl(node, prov, addr, subLine, ValueMode::Display);
+}
 
-    QString type = overflow ? fitOverflow(rawType, colType)
-                            : (typeOverride.isEmpty() ? typeName(node.kind, colType)
-                                                      : fit(typeOverride, colType));
-    QString name = overflow ? node.name : fit(node.name, colName);
+static void appendTypeNameRaw(QString& out, NodeKind kind) {
+    auto* m = kindMeta(kind);
+    out += QLatin1String(m ? m->typeName : "???");
+}
 
-    // Effective column width for this line (accounts for overflow, clamped to hard max)
-    int effectiveColType = overflow ? rawType.size() : colType;
-    // Blank prefix for continuation lines (same width as type+sep+name+sep)
-    const int prefixW = effectiveColType + (overflow ? name.size() : colName) + 2 * kSepWidth;
+static int typeNameRawLen(NodeKind kind) {
+    auto* m = kindMeta(kind);
+    return m ? (int)strlen(m->typeName) : 3;
+}
 
+static void appendComment(QString& out, const QString& comment) {
     // Comment suffix (only present when a comment is provided; no trailing padding)
-    QString cmtSuffix = comment.isEmpty() ? QString()
-                                          : fit(comment, COL_COMMENT);
+    if (comment.isEmpty()) return;
+    int from = out.size();
+    out += comment;
+    fitTail(out, from, COL_COMMENT);
+}
 
-    // Mat4x4: subLine 0..3 = rows — no truncation so large floats always display fully
-    if (node.kind == NodeKind::Mat4x4) {
-        QString val = readValue(node, prov, addr, subLine);
-        if (subLine == 0) return ind + type + SEP + name + SEP + val + cmtSuffix;
-        return ind + QString(prefixW, ' ') + val + cmtSuffix;
-    }
+void appendNodeLine(QString& out, const Node& node, const Provider& prov,
+                    uint64_t addr, int depth, int subLine,
+                    const QString& comment, int colType, int colName,
+                    const QString& typeOverride, bool compact) {
+    // Raw type length for overflow detection
+    const int rawTypeLen = typeOverride.isEmpty() ? typeNameRawLen(node.kind)
+                                                  : typeOverride.size();
+    const bool overflow = compact && rawTypeLen > colType;
+    // Effective column width for this line (accounts for overflow)
+    const int effectiveColType = overflow ? rawTypeLen : colType;
+
+    appendIndent(out, depth);
+
+    // Mat4x4: subLine 1..3 = rows under a blank prefix as wide as type+sep+name+sep
+    if (node.kind == NodeKind::Mat4x4 && subLine > 0) {
+        const int nameW = overflow ? node.name.size() : colName;
+        out.resize(out.size() + effectiveColType + nameW + 2 * kSepWidth, QLatin1Char(' '));
+        appendValue(out, node, prov, addr, subLine);
+        appendComment(out, comment);
+        return;
+    }
+
+    int from = out.size();
+    if (typeOverride.isEmpty()) appendTypeNameRaw(out, node.kind);
+    else out += typeOverride;
+    fitTail(out, from, effectiveColType);
+    out += QLatin1Char(' ');
 
     // Hex nodes: hex byte preview (ASCII padded to colName to align with value column)
     if (isHexPreview(node.kind)) {
-        const int sz = sizeForKind(node.kind);
-        QByteArray b = prov.isReadable(addr, sz)
-            ? prov.readBytes(addr, sz) : QByteArray(sz, '\0');
-        QString ascii = bytesToAscii(b, sz).leftJustified(colName, ' ');
-        QString hex = bytesToHex(b, sz).leftJustified(23, ' ');
-        return ind + type + SEP + ascii + SEP + hex + cmtSuffix;
+        const int sz = qMin(sizeForKind(node.kind), 8);
+        uint8_t b[8] = {};
+        if (!prov.isReadable(addr, sz) || !prov.read(addr, b, sz))
+            memset(b, 0, sizeof(b));
+        from = out.size();
+        for (int i = 0; i < sz; ++i)
+            out += isAsciiPrintable(b[i]) ? QChar(b[i]) : QChar('.');
+        if (out.size() - from < colName) out.resize(from + colName, QLatin1Char(' '));
+        out += QLatin1Char(' ');
+        from = out.size();
+        static const char kHexDigits[] = "0123456789ABCDEF";
+        for (int i = 0; i < sz; ++i) {
+            out += QLatin1Char(kHexDigits[b[i] >> 4]);
+            out += QLatin1Char(kHexDigits[b[i] & 0xF]);
+            if (i + 1 < sz) out += QLatin1Char(' ');
+        }
+        if (out.size() - from < 23) out.resize(from + 23, QLatin1Char(' '));
+        appendComment(out, comment);
+        return;
     }
 
-    QString val = overflow ? readValue(node, prov, addr, subLine)
-                           : fit(readValue(node, prov, addr, subLine), COL_VALUE);
-    return ind + type + SEP + name + SEP + val + cmtSuffix;
+    from = out.size();
+    out += node.name;
+    if (!overflow) fitTail(out, from, colName);
+    out += QLatin1Char(' ');
+
+    // Mat4x4 row 0 is never truncated so large floats always display fully
+    from = out.size();
+    appendValue(out, node, prov, addr, subLine);
+    if (!overflow && node.kind != NodeKind::Mat4x4)
+        fitTail(out, from, COL_VALUE);
+    appendComment(out, comment);
+}
+
+void appendPointerHeader(QString& out, const Node& node, int depth, bool collapsed,
+                         const Provider& prov, uint64_t addr,
+                         const QString& ptrTypeName, int colType, int colName,
+                         bool compact) {
+    appendIndent(out, depth);
+    bool overflow = compact && ptrTypeName.size() > colType;
+    int from = out.size();
+    out += ptrTypeName;
+    if (!overflow) fitTail(out, from, colType);
+    out += QLatin1Char(' ');
+    if (!collapsed) {
+        out += node.name;
+        out += QLatin1String(" {");
+        return;
+    }
+    if (overflow) {
+        // Overflow: no column padding
+        out += node.name;
+        out += QLatin1Char(' ');
+        appendValue(out, node, prov, addr, 0);
+        return;
+    }
+    // Collapsed: show pointer value instead of brace (name padded for value alignment)
+    from = out.size();
+    out += node.name;
+    fitTail(out, from, colName);
+    out += QLatin1Char(' ');
+    from = out.size();
+    appendValue(out, node, prov, addr, 0);
+    fitTail(out, from, COL_VALUE);
+}
+
+// ── Full node line ──
+
+QString fmtNodeLine(const Node& node, const Provider& prov,
+                    uint64_t addr, int depth, int subLine,
+                    const QString& comment, int colType, int colName,
+                    const QString& typeOverride, bool compact) {
+    QString out;
+    appendNodeLine(out, node, prov, addr, depth, subLine, comment,
+                   colType, colName, typeOverride, compact);
+    return out;
 }
 
 // ── Editable value (parse-friendly form for edit dialog) ──
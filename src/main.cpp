@@ -37,6 +37,8 @@
 #include <QStandardItemModel>
 #include <QListWidget>
 #include <QPushButton>
+#include <QSlider>
+#include <QDateTime>
 #include "workspace_model.h"
 #include <QTableWidget>
 #include <QHeaderView>
@@ -426,6 +428,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     setCentralWidget(m_mdiArea);
 
     createWorkspaceDock();
+    createHistoryDock();
     createMenus();
     createStatusBar();
 
@@ -461,6 +464,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
             this, [this](QMdiSubWindow*) {
         updateWindowTitle();
         rebuildWorkspaceModel();
+        updateHistoryDock();
     });
 
     // Track which split pane has focus (for menu-driven view switching)
@@ -592,6 +596,7 @@ void MainWindow::createMenus() {
 
     view->addSeparator();
     view->addAction(m_workspaceDock->toggleViewAction());
+    view->addAction(m_historyDock->toggleViewAction());
 
     // Plugins
     auto* plugins = m_titleBar->menuBar()->addMenu("&Plugins");
@@ -1052,6 +1057,11 @@ QMdiSubWindow* MainWindow::createTab(RcxDocument* doc) {
         if (it != m_tabs.end())
             updateAllRenderedPanes(*it);
     });
+    connect(ctrl, &RcxController::historyChanged,
+            this, [this, ctrl]() {
+        if (activeController() == ctrl)
+            updateHistoryDock();
+    });
     connect(ctrl, &RcxController::selectionChanged,
             this, [this](int count) {
         if (count == 0)
@@ -2472,6 +2482,67 @@ void MainWindow::createWorkspaceDock() {
     });
 }
 
+// ── History dock: rewind the active tab through recorded refreshes ──
+
+void MainWindow::createHistoryDock() {
+    m_historyDock = new QDockWidget("History", this);
+    m_historyDock->setObjectName("HistoryDock");
+    m_historyDock->setAllowedAreas(Qt::TopDockWidgetArea | Qt::BottomDockWidgetArea);
+    m_historyDock->setFeatures(QDockWidget::DockWidgetClosable | QDockWidget::DockWidgetMovable);
+
+    auto* body = new QWidget(m_historyDock);
+    auto* layout = new QHBoxLayout(body);
+    layout->setContentsMargins(6, 2, 6, 2);
+    m_historySlider = new QSlider(Qt::Horizontal, body);
+    m_historySlider->setEnabled(false);
+    m_historyLabel = new QLabel("Live", body);
+    m_historyLabel->setMinimumWidth(
+        m_historyLabel->fontMetrics().horizontalAdvance("00:00:00.000  (0000/0000)"));
+    auto* liveBtn = new QToolButton(body);
+    liveBtn->setText("Live");
+    liveBtn->setAutoRaise(true);
+    layout->addWidget(m_historySlider, 1);
+    layout->addWidget(m_historyLabel);
+    layout->addWidget(liveBtn);
+    m_historyDock->setWidget(body);
+    addDockWidget(Qt::BottomDockWidgetArea, m_historyDock);
+    m_historyDock->hide();
+
+    // The slider's last step is the live view
+    connect(m_historySlider, &QSlider::valueChanged, this, [this](int value) {
+        auto* ctrl = activeController();
+        if (!ctrl) return;
+        ctrl->setHistoryPosition(value >= ctrl->historySize() ? -1 : value);
+    });
+    connect(liveBtn, &QToolButton::clicked, this, [this]() {
+        if (auto* ctrl = activeController())
+            ctrl->setHistoryPosition(-1);
+    });
+    connect(m_historyDock, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) updateHistoryDock();
+    });
+}
+
+void MainWindow::updateHistoryDock() {
+    if (!m_historyDock || !m_historyDock->isVisible()) return;
+    auto* ctrl = activeController();
+    int frames = ctrl ? ctrl->historySize() : 0;
+    int pos = ctrl ? ctrl->historyPosition() : -1;
+
+    QSignalBlocker block(m_historySlider);
+    m_historySlider->setEnabled(frames > 0);
+    m_historySlider->setRange(0, frames);
+    m_historySlider->setValue(pos < 0 ? frames : pos);
+    if (pos < 0)
+        m_historyLabel->setText(frames ? QString("Live  (%1 frames)").arg(frames)
+                                       : QStringLiteral("Live"));
+    else
+        m_historyLabel->setText(QString("%1  (%2/%3)")
+            .arg(QDateTime::fromMSecsSinceEpoch(ctrl->historyTime(pos)).toString("HH:mm:ss.zzz"))
+            .arg(pos + 1)
+            .arg(frames));
+}
+
 void MainWindow::rebuildAllDocs() {
     m_allDocs.clear();
     for (auto it = m_tabs.begin(); it != m_tabs.end(); ++it)
@@ -14,6 +14,7 @@
 #include <QMap>
 #include <QButtonGroup>
 #include <QPushButton>
+#include <QSlider>
 #include <Qsci/qsciscintilla.h>
 
 namespace rcx {
@@ -136,6 +137,13 @@ private:
     void rebuildWorkspaceModel();
     void updateBorderColor(const QColor& color);
 
+    // History dock (snapshot timeline of the active tab)
+    QDockWidget*        m_historyDock    = nullptr;
+    QSlider*            m_historySlider  = nullptr;
+    QLabel*             m_historyLabel   = nullptr;
+    void createHistoryDock();
+    void updateHistoryDock();
+
 protected:
     void changeEvent(QEvent* event) override;
     void resizeEvent(QResizeEvent* event) override;
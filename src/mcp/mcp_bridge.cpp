@@ -820,7 +820,8 @@ QJsonObject McpBridge::toolHexRead(const QJsonObject& args) {
     auto* tab = resolveTab(args);
     if (!tab) return makeTextResult("No active tab", true);
 
-    auto* prov = tab->doc->provider.get();
+    // Cached: agents tend to issue runs of small reads around one spot
+    std::shared_ptr<Provider> prov = tab->ctrl->syncProvider();
     if (!prov) return makeTextResult("No provider", true);
 
     int64_t offset = static_cast<int64_t>(args.value("offset").toDouble());
@@ -0,0 +1,153 @@
+#include "pointerchase.h"
+#include <cstring>
+
+namespace rcx {
+
+namespace {
+
+constexpr uint64_t kPageSize = PagePool::kPageSize;
+constexpr uint64_t kPageMask = ~(kPageSize - 1);
+
+// A struct instance to expand: its definition and where its data lives
+struct Site {
+    uint64_t structId;
+    uint64_t base;
+    bool     fresh;     // reached through a pointer that moved this refresh
+};
+
+// Copy [addr, addr + len) out of one page table; false if a page is missing
+bool readFrom(const PageTable& table, uint64_t addr, void* out, int len) {
+    char* dst = static_cast<char*>(out);
+    while (len > 0) {
+        uint64_t page = addr & kPageMask;
+        int off = int(addr - page);
+        int chunk = qMin(len, int(kPageSize) - off);
+        const PageBuf* buf = table.find(page);
+        if (!buf) return false;
+        std::memcpy(dst, buf->constData() + off, chunk);
+        dst += chunk;
+        addr += chunk;
+        len -= chunk;
+    }
+    return true;
+}
+
+// Same sentinels compose treats as "no target"
+uint64_t pointerValue(const Node& node, const char* bytes) {
+    uint64_t v = 0;
+    if (node.kind == NodeKind::Pointer32) {
+        uint32_t v32;
+        std::memcpy(&v32, bytes, 4);
+        v = (v32 == 0xFFFFFFFFu) ? 0 : v32;
+    } else {
+        std::memcpy(&v, bytes, 8);
+        if (v == UINT64_MAX) v = 0;
+    }
+    return v;
+}
+
+void readPages(const Provider& prov, const QVector<uint64_t>& addrs, PageTable& pages) {
+    if (addrs.isEmpty()) return;
+    QVector<Provider::ReadRequest> reqs;
+    reqs.reserve(addrs.size());
+    PagePool& pool = PagePool::instance();
+    for (uint64_t p : addrs) {
+        PageBuf& page = pages.insert(p, pool.acquire());
+        reqs.append(Provider::ReadRequest{p, page.data(), int(kPageSize)});
+    }
+    prov.readBatch(reqs.data(), reqs.size());
+}
+
+} // namespace
+
+int chasePointers(const NodeTree& tree, uint64_t rootId, uint64_t baseAddress,
+                  const Provider& prov, PageTable& pages, const PageTable* prev,
+                  const PointerChaseLimits& limits) {
+    const auto& childMap = tree.childIndex();
+    QSet<QPair<uint64_t, uint64_t>> visited;
+    QHash<uint64_t, int> spans;     // one lookup per struct, however many sites
+    QVector<Site> level;
+    if (rootId != 0) {
+        level.append(Site{rootId, baseAddress, false});
+    } else {
+        // Every top-level struct, as compose lays them out (expanded or not)
+        for (int ri : childMap.value(0))
+            if (tree.nodes[ri].kind == NodeKind::Struct)
+                level.append(Site{tree.nodes[ri].id, baseAddress + tree.nodes[ri].offset, false});
+    }
+    int chased = 0;
+
+    for (int depth = 0; depth <= limits.maxDepth && !level.isEmpty(); ++depth) {
+        // The root's pages are the scheduler's business; below it, gather
+        // every target page this level needs and read them in one batch
+        if (depth > 0 && chased < limits.pageBudget) {
+            QVector<uint64_t> batch;
+            for (const Site& s : level) {
+                int span = tree.structSpan(s.structId, childMap, spans);
+                if (span <= 0 || s.base > UINT64_MAX - uint64_t(span)) continue;
+                uint64_t end = s.base + uint64_t(span);
+                for (uint64_t p = s.base & kPageMask; p < end; p += kPageSize) {
+                    if (pages.contains(p)) continue;
+                    if (!s.fresh && prev && prev->contains(p)) continue;
+                    batch.append(p);
+                }
+            }
+            std::sort(batch.begin(), batch.end());
+            batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+            if (batch.size() > limits.pageBudget - chased)
+                batch.resize(limits.pageBudget - chased);
+            readPages(prov, batch, pages);
+            chased += batch.size();
+        }
+        if (depth == limits.maxDepth) break;
+
+        // Expand this level from the bytes now in hand. Embedded structs
+        // share their parent's pages and join the level being walked.
+        QVector<Site> next;
+        for (int i = 0; i < level.size(); ++i) {
+            const Site s = level[i];
+            const QPair<uint64_t, uint64_t> key{s.structId, s.base};
+            if (visited.contains(key)) continue;
+            visited.insert(key);
+
+            auto kids = childMap.constFind(s.structId);
+            if (kids == childMap.constEnd()) {
+                int idx = tree.indexOfId(s.structId);
+                if (idx >= 0 && tree.nodes[idx].kind == NodeKind::Struct && tree.nodes[idx].refId != 0)
+                    level.append(Site{tree.nodes[idx].refId, s.base, s.fresh});
+                continue;
+            }
+            for (int ci : *kids) {
+                const Node& c = tree.nodes[ci];
+                if (c.collapsed) continue;
+                if (c.kind == NodeKind::Struct) {
+                    level.append(Site{c.id, s.base + c.offset, s.fresh});
+                    continue;
+                }
+                if ((c.kind != NodeKind::Pointer32 && c.kind != NodeKind::Pointer64) || c.refId == 0)
+                    continue;
+
+                uint64_t addr = s.base + c.offset;
+                char bytes[8] = {}, old[8] = {};
+                int size = c.byteSize();
+                bool inThisRead = readFrom(pages, addr, bytes, size);
+                if (!inThisRead && !(prev && readFrom(*prev, addr, bytes, size)))
+                    continue;
+                uint64_t target = pointerValue(c, bytes);
+                // Garbage pointers stop here when the provider knows its
+                // mappings, instead of costing a failed read
+                if (target == 0 || !prov.isReadable(target, 1)) continue;
+
+                bool moved = inThisRead
+                    && !(prev && readFrom(*prev, addr, old, size) && pointerValue(c, old) == target);
+                // Materialized pointer children lay out at the target themselves
+                uint64_t targetStruct = childMap.contains(c.id) ? c.id : c.refId;
+                next.append(Site{targetStruct, target, moved});
+            }
+        }
+        level = std::move(next);
+    }
+    return chased;
+}
+
+} // namespace rcx
@@ -0,0 +1,27 @@
+#pragma once
+#include "core.h"
+#include "providers/page_pool.h"
+
+namespace rcx {
+
+struct PointerChaseLimits {
+    int maxDepth   = 99;     // pointer hops below the root
+    int pageBudget = 1024;   // pages one refresh may add (4 MB)
+};
+
+// Follow the tree's expanded pointers through the pages a refresh just read
+// and read their targets in the same refresh, one level at a time: level N
+// is expanded from fresh bytes, then every target level N+1 needs goes out
+// in a single readBatch. A target is read when the snapshot has never held
+// it, or when its pointer was re-read this refresh and moved; targets of
+// pointers that did not move keep their own schedule. Pages missing from
+// `pages` are looked up in `prev` (the previous read).
+//
+// rootId 0 walks every top-level struct. Collapsed pointers and structs
+// below the root are not followed. Returns the number of pages added to
+// `pages` (unhashed).
+int chasePointers(const NodeTree& tree, uint64_t rootId, uint64_t baseAddress,
+                  const Provider& prov, PageTable& pages, const PageTable* prev,
+                  const PointerChaseLimits& limits = {});
+
+} // namespace rcx
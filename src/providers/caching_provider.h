@@ -0,0 +1,182 @@
+#pragma once
+#include "provider.h"
+#include "page_pool.h"
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <chrono>
+#include <list>
+#include <memory>
+
+namespace rcx {
+
+// Read-through page cache in front of any provider, for the synchronous
+// reads that bypass the refresh snapshot (hover popups, disassembly,
+// address expressions, MCP). A burst of small reads around the same
+// addresses costs one batched fetch instead of a syscall or RPC each.
+//
+// Pages are kept for at most ttlMs and at most maxPages of them, least
+// recently used first out. write() goes through to the wrapped provider
+// and drops the pages it touched; writes made to the wrapped provider
+// directly need an invalidate(). Pages the wrapped provider cannot read
+// whole (unmapped, or the tail of a file) are never cached: those reads go
+// straight through.
+class CachingProvider : public Provider {
+public:
+    using Clock = int64_t (*)();    // milliseconds, monotonic
+
+    static constexpr int kDefaultPages = 64;    // 256 KB
+    static constexpr int kDefaultTtlMs = 250;
+
+    explicit CachingProvider(std::shared_ptr<Provider> real,
+                             int maxPages = kDefaultPages, int ttlMs = kDefaultTtlMs,
+                             Clock clock = steadyMs)
+        : m_real(std::move(real))
+        , m_maxPages(qMax(1, maxPages))
+        , m_ttlMs(ttlMs)
+        , m_clock(clock) {}
+
+    const std::shared_ptr<Provider>& real() const { return m_real; }
+
+    // Drop every cached page
+    void invalidate() {
+        QMutexLocker lock(&m_mutex);
+        m_pages.clear();
+        m_lru.clear();
+    }
+
+    int cachedPages() const {
+        QMutexLocker lock(&m_mutex);
+        return m_pages.size();
+    }
+
+    bool read(uint64_t addr, void* buf, int len) const override {
+        if (!m_real || len <= 0) return false;
+        uint64_t end = addr + uint64_t(len);
+        uint64_t first = addr & kPageMask;
+        // Reads spanning more than half the cache would only evict it
+        if (end < addr || (end - first) / kPageSize > uint64_t(m_maxPages / 2))
+            return m_real->read(addr, buf, len);
+
+        QMutexLocker lock(&m_mutex);
+        const int64_t now = m_clock();
+        QVector<uint64_t> missing;
+        for (uint64_t p = first; p < end; p += kPageSize) {
+            // Pages already held move to the front, so fetching the rest
+            // cannot evict them
+            if (fresh(p, now)) touch(p);
+            else missing.append(p);
+        }
+        if (!missing.isEmpty() && !fetch(missing, now))
+            return m_real->read(addr, buf, len);
+
+        char* out = static_cast<char*>(buf);
+        for (uint64_t p = first; p < end; p += kPageSize) {
+            const Entry& e = m_pages[p];
+            uint64_t lo = qMax(p, addr), hi = qMin(p + kPageSize, end);
+            std::memcpy(out + (lo - addr), e.page.constData() + (lo - p), size_t(hi - lo));
+        }
+        return true;
+    }
+
+    bool write(uint64_t addr, const void* buf, int len) override {
+        if (!m_real) return false;
+        bool ok = m_real->write(addr, buf, len);
+        if (len > 0) {
+            QMutexLocker lock(&m_mutex);
+            uint64_t last = (addr + uint64_t(len) - 1) & kPageMask;
+            for (uint64_t p = addr & kPageMask; ; p += kPageSize) {
+                drop(p);
+                if (p == last) break;
+            }
+        }
+        return ok;
+    }
+
+    int  size() const override { return m_real ? m_real->size() : 0; }
+    bool isReadable(uint64_t addr, int len) const override {
+        return m_real ? m_real->isReadable(addr, len) : false;
+    }
+    bool isWritable() const override { return m_real ? m_real->isWritable() : false; }
+    bool isLive() const override { return m_real ? m_real->isLive() : false; }
+    QString name() const override { return m_real ? m_real->name() : QString(); }
+    QString kind() const override { return m_real ? m_real->kind() : QStringLiteral("File"); }
+    uint64_t base() const override { return m_real ? m_real->base() : 0; }
+    QString getSymbol(uint64_t addr) const override {
+        return m_real ? m_real->getSymbol(addr) : QString();
+    }
+    uint64_t symbolToAddress(const QString& n) const override {
+        return m_real ? m_real->symbolToAddress(n) : 0;
+    }
+    QVector<Region> regions() const override {
+        return m_real ? m_real->regions() : QVector<Region>();
+    }
+
+private:
+    static constexpr uint64_t kPageSize = PagePool::kPageSize;
+    static constexpr uint64_t kPageMask = ~(kPageSize - 1);
+
+    struct Entry {
+        PageBuf  page;
+        int64_t  fetchedMs = 0;
+        std::list<uint64_t>::iterator lru;     // position in m_lru
+    };
+
+    std::shared_ptr<Provider> m_real;
+    int   m_maxPages;
+    int   m_ttlMs;
+    Clock m_clock;
+
+    mutable QMutex                 m_mutex;
+    mutable QHash<uint64_t, Entry> m_pages;
+    mutable std::list<uint64_t>    m_lru;      // most recently used first
+
+    static int64_t steadyMs() {
+        using namespace std::chrono;
+        return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool fresh(uint64_t page, int64_t now) const {
+        auto it = m_pages.constFind(page);
+        return it != m_pages.constEnd() && now - it->fetchedMs < m_ttlMs;
+    }
+
+    void touch(uint64_t page) const {
+        m_lru.splice(m_lru.begin(), m_lru, m_pages[page].lru);
+    }
+
+    void drop(uint64_t page) const {
+        auto it = m_pages.find(page);
+        if (it == m_pages.end()) return;
+        m_lru.erase(it->lru);
+        m_pages.erase(it);
+    }
+
+    // One batched read for all missing pages; false if any of them could
+    // not be read whole (nothing of the batch is kept then)
+    bool fetch(const QVector<uint64_t>& missing, int64_t now) const {
+        QVector<PageBuf> bufs;
+        QVector<ReadRequest> reqs;
+        bufs.reserve(missing.size());
+        reqs.reserve(missing.size());
+        for (uint64_t p : missing) {
+            bufs.append(PagePool::instance().acquire());
+            reqs.append(ReadRequest{p, bufs.last().data(), int(kPageSize)});
+        }
+        if (!m_real->readBatch(reqs.data(), reqs.size())) return false;
+
+        for (int i = 0; i < missing.size(); ++i) {
+            drop(missing[i]);
+            while (m_pages.size() >= m_maxPages) {
+                m_pages.remove(m_lru.back());
+                m_lru.pop_back();
+            }
+            m_lru.push_front(missing[i]);
+            m_pages.insert(missing[i], Entry{std::move(bufs[i]), now, m_lru.begin()});
+        }
+        return true;
+    }
+};
+
+} // namespace rcx
@@ -0,0 +1,264 @@
+#pragma once
+#include "mapped_file_provider.h"
+#include <QHash>
+#include <QVector>
+#include <algorithm>
+
+namespace rcx {
+
+// A Linux ELF core file seen at the virtual addresses of the process that
+// dumped it. PT_LOAD segments map address ranges to file offsets; bytes
+// come straight out of the mapped file. The NT_FILE note names the mapped
+// files, which serve as modules for getSymbol()/symbolToAddress(), and
+// base() is the module holding the entry point (NT_AUXV AT_ENTRY).
+//
+// Parts of a segment the kernel did not dump (filesz < memsz, typically
+// read-only file pages) and addresses outside every segment fail to read.
+// Writes land in a private copy of the file, never on disk.
+class CoreDumpProvider : public Provider {
+public:
+    struct Segment {
+        uint64_t vaddr;
+        uint64_t fileSize;      // bytes present in the file
+        uint64_t memSize;
+        uint64_t offset;        // file offset of vaddr
+    };
+    struct Module {
+        QString  name;          // file name, without directories
+        uint64_t base;
+        uint64_t size;
+    };
+    struct Layout {
+        QVector<Segment> segments;  // sorted by vaddr
+        QVector<Module>  modules;   // sorted by base
+        uint64_t         entry = 0;
+    };
+
+    // Whether `data` starts like an ELF core file
+    static bool isCoreFile(const uchar* data, uint64_t size) {
+        return size >= 20 && std::memcmp(data, "\x7f" "ELF", 4) == 0
+            && data[5] == 1 /* little-endian */ && readU16(data + 16) == 4 /* ET_CORE */;
+    }
+
+    // Segments and modules out of a core file's bytes; false if it is not
+    // a little-endian ELF32/ELF64 core or its headers run past the end
+    static bool parse(const uchar* data, uint64_t size, Layout* out) {
+        if (!isCoreFile(data, size)) return false;
+        const bool is64 = data[4] == 2;
+        if (!is64 && data[4] != 1) return false;
+        if (size < (is64 ? 64u : 52u)) return false;
+
+        const uint64_t phoff   = is64 ? readU64(data + 32) : readU32(data + 28);
+        const uint16_t phentsz = readU16(data + (is64 ? 54 : 42));
+        const uint16_t phnum   = readU16(data + (is64 ? 56 : 44));
+        if (phentsz < (is64 ? 56 : 32) || phoff > size
+            || uint64_t(phnum) * phentsz > size - phoff)
+            return false;
+
+        Layout layout;
+        for (int i = 0; i < phnum; ++i) {
+            const uchar* ph = data + phoff + uint64_t(i) * phentsz;
+            const uint32_t type = readU32(ph);
+            uint64_t offset, vaddr, filesz, memsz;
+            if (is64) {
+                offset = readU64(ph + 8);
+                vaddr  = readU64(ph + 16);
+                filesz = readU64(ph + 32);
+                memsz  = readU64(ph + 40);
+            } else {
+                offset = readU32(ph + 4);
+                vaddr  = readU32(ph + 8);
+                filesz = readU32(ph + 16);
+                memsz  = readU32(ph + 20);
+            }
+            if (offset > size) continue;
+            filesz = qMin(filesz, size - offset);     // truncated dumps
+            if (type == 1 /* PT_LOAD */ && memsz > 0)
+                layout.segments.append(Segment{vaddr, qMin(filesz, memsz), memsz, offset});
+            else if (type == 4 /* PT_NOTE */)
+                parseNotes(data + offset, filesz, is64, &layout);
+        }
+        std::sort(layout.segments.begin(), layout.segments.end(),
+                  [](const Segment& a, const Segment& b) { return a.vaddr < b.vaddr; });
+        std::sort(layout.modules.begin(), layout.modules.end(),
+                  [](const Module& a, const Module& b) { return a.base < b.base; });
+        *out = std::move(layout);
+        return true;
+    }
+
+    explicit CoreDumpProvider(const QString& path)
+        : m_file(path)
+    {
+        if (!m_file.isOpen()) return;
+        const uchar* data = m_file.data();
+        m_valid = parse(data, m_file.fileSize(), &m_layout);
+    }
+
+    // False when the file is missing, unmappable or not an ELF core
+    bool isOpen() const { return m_valid; }
+    const Layout& layout() const { return m_layout; }
+
+    int size() const override { return m_valid ? 0x10000 : 0; }
+
+    bool isReadable(uint64_t addr, int len) const override {
+        if (!m_valid || len < 0) return false;
+        if (len == 0) return true;
+        uint64_t end = addr + uint64_t(len);
+        if (end < addr) return false;
+        while (addr < end) {
+            const Segment* s = segmentAt(addr);
+            if (!s || addr - s->vaddr >= s->fileSize) return false;
+            addr = s->vaddr + s->fileSize;
+        }
+        return true;
+    }
+
+    bool read(uint64_t addr, void* buf, int len) const override {
+        if (!isReadable(addr, len)) return false;
+        char* dst = static_cast<char*>(buf);
+        while (len > 0) {
+            const Segment* s = segmentAt(addr);
+            uint64_t rel = addr - s->vaddr;
+            int chunk = int(qMin<uint64_t>(uint64_t(len), s->fileSize - rel));
+            m_file.read(s->offset + rel, dst, chunk);
+            dst += chunk;
+            addr += uint64_t(chunk);
+            len -= chunk;
+        }
+        return true;
+    }
+
+    bool isWritable() const override { return m_valid; }
+
+    bool write(uint64_t addr, const void* buf, int len) override {
+        if (!isReadable(addr, len)) return false;
+        const char* src = static_cast<const char*>(buf);
+        while (len > 0) {
+            const Segment* s = segmentAt(addr);
+            uint64_t rel = addr - s->vaddr;
+            int chunk = int(qMin<uint64_t>(uint64_t(len), s->fileSize - rel));
+            m_file.write(s->offset + rel, src, chunk);
+            src += chunk;
+            addr += uint64_t(chunk);
+            len -= chunk;
+        }
+        return true;
+    }
+
+    QString name() const override { return m_file.name(); }
+    QString kind() const override { return QStringLiteral("CoreDump"); }
+
+    uint64_t base() const override {
+        for (const Module& m : m_layout.modules)
+            if (m_layout.entry >= m.base && m_layout.entry - m.base < m.size)
+                return m.base;
+        if (!m_layout.modules.isEmpty()) return m_layout.modules.first().base;
+        return m_layout.segments.isEmpty() ? 0 : m_layout.segments.first().vaddr;
+    }
+
+    QString getSymbol(uint64_t addr) const override {
+        auto it = std::upper_bound(m_layout.modules.cbegin(), m_layout.modules.cend(), addr,
+            [](uint64_t a, const Module& m) { return a < m.base; });
+        if (it == m_layout.modules.cbegin()) return {};
+        --it;
+        if (addr - it->base >= it->size) return {};
+        return QStringLiteral("%1+0x%2").arg(it->name).arg(addr - it->base, 0, 16, QChar('0'));
+    }
+
+    uint64_t symbolToAddress(const QString& name) const override {
+        for (const Module& m : m_layout.modules)
+            if (m.name.compare(name, Qt::CaseInsensitive) == 0)
+                return m.base;
+        return 0;
+    }
+
+private:
+    MappedFileProvider m_file;
+    Layout             m_layout;
+    bool               m_valid = false;
+
+    static uint16_t readU16(const uchar* p) { uint16_t v; std::memcpy(&v, p, 2); return v; }
+    static uint32_t readU32(const uchar* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+    static uint64_t readU64(const uchar* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+
+    // The segment whose range (memSize) holds addr
+    const Segment* segmentAt(uint64_t addr) const {
+        const auto& segs = m_layout.segments;
+        auto it = std::upper_bound(segs.cbegin(), segs.cend(), addr,
+            [](uint64_t a, const Segment& s) { return a < s.vaddr; });
+        if (it == segs.cbegin()) return nullptr;
+        --it;
+        return addr - it->vaddr < it->memSize ? &*it : nullptr;
+    }
+
+    static void parseNotes(const uchar* p, uint64_t len, bool is64, Layout* out) {
+        auto align4 = [](uint64_t n) { return (n + 3) & ~uint64_t(3); };
+        uint64_t pos = 0;
+        // pos may step past len by the last descriptor's padding
+        while (pos <= len && len - pos >= 12) {
+            const uint32_t namesz = readU32(p + pos);
+            const uint32_t descsz = readU32(p + pos + 4);
+            const uint32_t type   = readU32(p + pos + 8);
+            const uint64_t descAt = pos + 12 + align4(namesz);
+            if (descAt > len || descsz > len - descAt) return;
+            const bool core = namesz >= 4 && std::memcmp(p + pos + 12, "CORE", 4) == 0;
+            if (core && type == 0x46494c45 /* NT_FILE */)
+                parseFileNote(p + descAt, descsz, is64, out);
+            else if (core && type == 6 /* NT_AUXV */)
+                parseAuxv(p + descAt, descsz, is64, out);
+            pos = descAt + align4(descsz);
+        }
+    }
+
+    // count, page size, count x (start, end, file offset), then count
+    // NUL-terminated paths; words are the ELF class's size
+    static void parseFileNote(const uchar* p, uint64_t len, bool is64, Layout* out) {
+        const uint64_t w = is64 ? 8 : 4;
+        auto word = [&](uint64_t at) { return is64 ? readU64(p + at) : uint64_t(readU32(p + at)); };
+        if (len < 2 * w) return;
+        const uint64_t count = word(0);
+        if (count > (len - 2 * w) / (3 * w)) return;
+        uint64_t names = 2 * w + count * 3 * w;
+
+        QVector<Module> mods;
+        QHash<QString, int> byPath;
+        for (uint64_t i = 0; i < count && names < len; ++i) {
+            const uchar* s = p + names;
+            const uchar* nul = static_cast<const uchar*>(std::memchr(s, 0, len - names));
+            if (!nul) break;
+            QString path = QString::fromUtf8(reinterpret_cast<const char*>(s), int(nul - s));
+            names += uint64_t(nul - s) + 1;
+
+            const uint64_t start = word(2 * w + i * 3 * w);
+            const uint64_t end   = word(2 * w + i * 3 * w + w);
+            if (end <= start) continue;
+            // One module per file, spanning all its mappings
+            auto known = byPath.constFind(path);
+            if (known == byPath.constEnd()) {
+                byPath.insert(path, mods.size());
+                mods.append(Module{path.mid(path.lastIndexOf(QLatin1Char('/')) + 1),
+                                   start, end - start});
+            } else {
+                Module& m = mods[known.value()];
+                uint64_t modEnd = qMax(m.base + m.size, end);
+                m.base = qMin(m.base, start);
+                m.size = modEnd - m.base;
+            }
+        }
+        out->modules += mods;
+    }
+
+    static void parseAuxv(const uchar* p, uint64_t len, bool is64, Layout* out) {
+        const uint64_t w = is64 ? 8 : 4;
+        for (uint64_t at = 0; at + 2 * w <= len; at += 2 * w) {
+            uint64_t key = is64 ? readU64(p + at) : readU32(p + at);
+            if (key == 0) break;                        // AT_NULL
+            if (key == 9) {                             // AT_ENTRY
+                out->entry = is64 ? readU64(p + at + w) : readU32(p + at + w);
+                break;
+            }
+        }
+    }
+};
+
+} // namespace rcx
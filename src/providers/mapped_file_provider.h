@@ -0,0 +1,85 @@
+#pragma once
+#include "provider.h"
+#include <QFile>
+#include <QFileInfo>
+#include <climits>
+#include <cstring>
+
+namespace rcx {
+
+// A file mapped into memory instead of read into a QByteArray: opening is
+// instant whatever the size, and the OS pages bytes in as they are first
+// read. Files past 2 GB work; size() saturates at INT_MAX and fileSize()
+// has the real size.
+//
+// ReadOnly maps the file as-is and refuses writes. CopyOnWrite maps it
+// privately: writes land in this process only, the file on disk never
+// changes (the same semantics BufferProvider gives a loaded file).
+//
+// The file must not shrink while mapped; reading past its new end faults.
+class MappedFileProvider : public Provider {
+public:
+    enum class Mode { ReadOnly, CopyOnWrite };
+
+    explicit MappedFileProvider(const QString& path, Mode mode = Mode::CopyOnWrite)
+        : m_file(path)
+        , m_name(QFileInfo(path).fileName())
+        , m_mode(mode)
+    {
+        if (!m_file.open(QIODevice::ReadOnly)) return;
+        m_size = uint64_t(m_file.size());
+        if (m_size == 0) return;
+        m_data = m_file.map(0, qint64(m_size), mode == Mode::CopyOnWrite
+                                ? QFile::MapPrivateOption : QFile::NoOptions);
+        if (!m_data) m_size = 0;
+    }
+
+    ~MappedFileProvider() override {
+        if (m_data) m_file.unmap(m_data);
+    }
+
+    MappedFileProvider(const MappedFileProvider&) = delete;
+    MappedFileProvider& operator=(const MappedFileProvider&) = delete;
+
+    // False when the file could not be opened or mapped (empty files
+    // included); errorString() says why
+    bool     isOpen() const { return m_data != nullptr; }
+    QString  errorString() const { return m_file.errorString(); }
+    uint64_t fileSize() const { return m_size; }
+    const uchar* data() const { return m_data; }
+    Mode     mode() const { return m_mode; }
+
+    int size() const override {
+        return m_size > uint64_t(INT_MAX) ? INT_MAX : int(m_size);
+    }
+
+    bool isReadable(uint64_t addr, int len) const override {
+        if (len <= 0) return (len == 0);
+        return addr <= m_size && uint64_t(len) <= m_size - addr;
+    }
+
+    bool read(uint64_t addr, void* buf, int len) const override {
+        if (!isReadable(addr, len)) return false;
+        std::memcpy(buf, m_data + addr, len);
+        return true;
+    }
+
+    bool isWritable() const override { return m_mode == Mode::CopyOnWrite && m_data; }
+
+    bool write(uint64_t addr, const void* buf, int len) override {
+        if (!isWritable() || !isReadable(addr, len)) return false;
+        std::memcpy(m_data + addr, buf, len);
+        return true;
+    }
+
+    QString name() const override { return m_name; }
+
+private:
+    QFile    m_file;
+    QString  m_name;
+    Mode     m_mode;
+    uint64_t m_size = 0;
+    uchar*   m_data = nullptr;
+};
+
+} // namespace rcx
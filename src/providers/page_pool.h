@@ -0,0 +1,328 @@
+#pragma once
+#include <QByteArray>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace rcx {
+
+class PageBuf;
+
+// Fixed-size snapshot pages carved out of slabs and recycled through a free
+// list. Slots are reference counted: the page table a refresh read builds,
+// the snapshot compose reads from and the copy the next read diffs against
+// all share one slot per page. A slot returns to the free list when the
+// last of them lets go. Steady-state refreshes then ping-pong between two
+// sets of slots (the snapshot on screen and the read filling in behind it)
+// without touching the heap.
+//
+// Each acquire bumps the slot's generation; a PageBuf remembers the
+// generation it was handed, so a handle that outlived its slot is caught in
+// debug builds instead of reading someone else's page.
+class PagePool {
+public:
+    static constexpr int kPageSize  = 4096;
+    static constexpr int kSlabPages = 64;      // 256 KB per slab
+
+    // One pool per process: snapshots of every tab draw from it. Never
+    // destroyed, so pages released during static teardown stay safe.
+    static PagePool& instance() {
+        static PagePool* pool = new PagePool;
+        return *pool;
+    }
+
+    inline PageBuf acquire();
+
+    // Give fully free slabs back to the heap (after a document closes or
+    // switches source, the pool would otherwise keep its peak size)
+    void trim() {
+        QMutexLocker lock(&m_mutex);
+        QVector<int> keep;
+        keep.reserve(m_free.size());
+        for (int slot : m_free) {
+            Slab* slab = m_slabs[slot / kSlabPages].get();
+            if (slab && slab->used == 0) continue;
+            keep.append(slot);
+        }
+        for (auto& slab : m_slabs)
+            if (slab && slab->used == 0) slab.reset();
+        m_free = std::move(keep);
+    }
+
+    int slabCount() const {
+        QMutexLocker lock(&m_mutex);
+        int n = 0;
+        for (const auto& slab : m_slabs)
+            if (slab) ++n;
+        return n;
+    }
+    int freeSlots() const {
+        QMutexLocker lock(&m_mutex);
+        return m_free.size();
+    }
+
+private:
+    friend class PageBuf;
+
+    struct SlotMeta {
+        std::atomic<int> refs{0};
+        uint32_t         gen = 0;
+    };
+    struct Slab {
+        alignas(64) char bytes[kSlabPages * kPageSize];
+        SlotMeta meta[kSlabPages];
+        int      used = 0;
+    };
+
+    mutable QMutex m_mutex;
+    std::vector<std::unique_ptr<Slab>> m_slabs;
+    QVector<int> m_free;        // slot = slab * kSlabPages + index
+
+    PagePool() = default;
+    PagePool(const PagePool&) = delete;
+    PagePool& operator=(const PagePool&) = delete;
+
+    // Slabs vector may grow under the lock: resolve the slab there too
+    int takeSlot(Slab** slab) {
+        QMutexLocker lock(&m_mutex);
+        if (m_free.isEmpty()) {
+            int s = 0;
+            while (s < int(m_slabs.size()) && m_slabs[s]) ++s;
+            if (s == int(m_slabs.size())) m_slabs.emplace_back();
+            m_slabs[s].reset(new Slab);
+            // Hand out low slots first: pop from the back
+            for (int i = kSlabPages - 1; i >= 0; --i)
+                m_free.append(s * kSlabPages + i);
+        }
+        int slot = m_free.takeLast();
+        *slab = m_slabs[slot / kSlabPages].get();
+        (*slab)->used++;
+        return slot;
+    }
+    void releaseSlot(int slot) {
+        QMutexLocker lock(&m_mutex);
+        m_slabs[slot / kSlabPages]->used--;
+        m_free.append(slot);
+    }
+};
+
+// Shared handle to one pool slot. Copies share the slot (no byte copy);
+// writers call detach() first, which copies only when the slot is shared.
+class PageBuf {
+public:
+    PageBuf() = default;
+    PageBuf(const PageBuf& o) : m_data(o.m_data), m_meta(o.m_meta), m_slot(o.m_slot), m_gen(o.m_gen) {
+        if (m_meta) m_meta->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    PageBuf(PageBuf&& o) noexcept
+        : m_data(o.m_data), m_meta(o.m_meta), m_slot(o.m_slot), m_gen(o.m_gen) {
+        o.m_data = nullptr;
+        o.m_meta = nullptr;
+    }
+    PageBuf& operator=(PageBuf o) noexcept {
+        std::swap(m_data, o.m_data);
+        std::swap(m_meta, o.m_meta);
+        std::swap(m_slot, o.m_slot);
+        std::swap(m_gen, o.m_gen);
+        return *this;
+    }
+    ~PageBuf() { release(); }
+
+    // A pooled copy of up to kPageSize bytes of data, zero-padded
+    static PageBuf fromBytes(const QByteArray& data) {
+        PageBuf page = PagePool::instance().acquire();
+        int n = qMin(data.size(), int(PagePool::kPageSize));
+        std::memcpy(page.m_data, data.constData(), n);
+        std::memset(page.m_data + n, 0, PagePool::kPageSize - n);
+        return page;
+    }
+
+    bool isNull() const { return m_data == nullptr; }
+    int  size() const { return m_data ? PagePool::kPageSize : 0; }
+    bool isShared() const { return m_meta && m_meta->refs.load(std::memory_order_acquire) > 1; }
+
+    const char* constData() const { Q_ASSERT(isCurrent()); return m_data; }
+    char*       data() { Q_ASSERT(isCurrent()); return m_data; }
+
+    // Make the slot exclusive before writing into it
+    void detach() {
+        if (!isShared()) return;
+        PageBuf copy = PagePool::instance().acquire();
+        std::memcpy(copy.m_data, m_data, PagePool::kPageSize);
+        *this = std::move(copy);
+    }
+
+private:
+    friend class PagePool;
+
+    char*               m_data = nullptr;
+    PagePool::SlotMeta* m_meta = nullptr;
+    int                 m_slot = -1;
+    uint32_t            m_gen  = 0;
+
+    bool isCurrent() const { return !m_meta || m_meta->gen == m_gen; }
+
+    void release() {
+        if (!m_meta) return;
+        if (m_meta->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            PagePool::instance().releaseSlot(m_slot);
+        m_data = nullptr;
+        m_meta = nullptr;
+    }
+};
+
+inline PageBuf PagePool::acquire() {
+    Slab* slab = nullptr;
+    int slot = takeSlot(&slab);
+    int i = slot % kSlabPages;
+    PageBuf page;
+    page.m_data = slab->bytes + size_t(i) * kPageSize;
+    page.m_meta = &slab->meta[i];
+    page.m_slot = slot;
+    page.m_gen  = ++page.m_meta->gen;
+    page.m_meta->refs.store(1, std::memory_order_relaxed);
+    return page;
+}
+
+// Open-addressing page table: page-aligned address -> pooled page, plus
+// the page's fingerprint (0 = not hashed). Linear probing over one flat
+// array; clear() and copy-assignment keep the capacity, so a table reused
+// from tick to tick stops allocating once it has grown to the document.
+class PageTable {
+public:
+    struct Entry {
+        uint64_t addr = kEmpty;
+        uint64_t hash = 0;
+        PageBuf  page;
+    };
+
+    class const_iterator {
+    public:
+        const_iterator(const Entry* e, const Entry* end) : m_e(e), m_end(end) { skip(); }
+        uint64_t       key() const { return m_e->addr; }
+        const PageBuf& value() const { return m_e->page; }
+        uint64_t       hash() const { return m_e->hash; }
+        const_iterator& operator++() { ++m_e; skip(); return *this; }
+        bool operator==(const const_iterator& o) const { return m_e == o.m_e; }
+        bool operator!=(const const_iterator& o) const { return m_e != o.m_e; }
+    private:
+        const Entry* m_e;
+        const Entry* m_end;
+        void skip() { while (m_e != m_end && m_e->addr == kEmpty) ++m_e; }
+    };
+
+    PageTable() = default;
+    PageTable(const PageTable&) = default;
+    PageTable& operator=(const PageTable&) = default;
+    PageTable(PageTable&& o) noexcept
+        : m_entries(std::move(o.m_entries)), m_size(o.m_size) {
+        o.m_entries.clear();
+        o.m_size = 0;
+    }
+    PageTable& operator=(PageTable&& o) noexcept {
+        m_entries = std::move(o.m_entries);
+        m_size = o.m_size;
+        o.m_entries.clear();
+        o.m_size = 0;
+        return *this;
+    }
+    PageTable(std::initializer_list<std::pair<uint64_t, QByteArray>> pages) {
+        reserve(int(pages.size()));
+        for (const auto& p : pages)
+            insert(p.first, PageBuf::fromBytes(p.second));
+    }
+
+    int  size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    int  capacity() const { return int(m_entries.size()); }
+
+    void clear() {
+        for (Entry& e : m_entries)
+            if (e.addr != kEmpty) e = Entry{};
+        m_size = 0;
+    }
+
+    void reserve(int n) {
+        size_t want = 16;
+        while (want < size_t(n) * 2) want *= 2;
+        if (want > m_entries.size()) rehash(want);
+    }
+
+    // Insert or replace; returns the stored page
+    PageBuf& insert(uint64_t addr, PageBuf page, uint64_t hash = 0) {
+        if (size_t(m_size + 1) * 2 > m_entries.size())
+            rehash(qMax<size_t>(16, m_entries.size() * 2));
+        Entry& e = m_entries[probe(addr)];
+        if (e.addr == kEmpty) { e.addr = addr; ++m_size; }
+        e.page = std::move(page);
+        e.hash = hash;
+        return e.page;
+    }
+
+    void setHash(uint64_t addr, uint64_t hash) {
+        if (m_entries.empty()) return;
+        Entry& e = m_entries[probe(addr)];
+        if (e.addr != kEmpty) e.hash = hash;
+    }
+
+    const PageBuf* find(uint64_t addr) const {
+        if (m_entries.empty()) return nullptr;
+        const Entry& e = m_entries[probe(addr)];
+        return e.addr == kEmpty ? nullptr : &e.page;
+    }
+    PageBuf* find(uint64_t addr) {
+        return const_cast<PageBuf*>(static_cast<const PageTable*>(this)->find(addr));
+    }
+    bool contains(uint64_t addr) const { return find(addr) != nullptr; }
+
+    // Fingerprint stored with the page, or 0 when absent or not hashed
+    uint64_t hashOf(uint64_t addr) const {
+        if (m_entries.empty()) return 0;
+        const Entry& e = m_entries[probe(addr)];
+        return e.addr == kEmpty ? 0 : e.hash;
+    }
+
+    const_iterator begin() const { return {m_entries.data(), m_entries.data() + m_entries.size()}; }
+    const_iterator end() const {
+        const Entry* e = m_entries.data() + m_entries.size();
+        return {e, e};
+    }
+    const_iterator constBegin() const { return begin(); }
+    const_iterator constEnd() const { return end(); }
+
+private:
+    // Page addresses are 4 KB aligned, so all-ones never names a page
+    static constexpr uint64_t kEmpty = ~uint64_t(0);
+
+    std::vector<Entry> m_entries;
+    int m_size = 0;
+
+    size_t probe(uint64_t addr) const {
+        const size_t mask = m_entries.size() - 1;
+        size_t i = size_t((addr >> 12) * 0x9E3779B97F4A7C15ull >> 32) & mask;
+        while (m_entries[i].addr != kEmpty && m_entries[i].addr != addr)
+            i = (i + 1) & mask;
+        return i;
+    }
+
+    void rehash(size_t cap) {
+        std::vector<Entry> old(cap);
+        old.swap(m_entries);
+        m_size = 0;
+        for (Entry& e : old)
+            if (e.addr != kEmpty) {
+                Entry& dst = m_entries[probe(e.addr)];
+                dst = std::move(e);
+                ++m_size;
+            }
+    }
+};
+
+} // namespace rcx
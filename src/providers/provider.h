@@ -1,6 +1,7 @@
 #pragma once
 #include <QByteArray>
 #include <QString>
+#include <QVector>
 #include <cstdint>
 #include <cstring>
 
@@ -10,6 +11,14 @@ class Provider {
 public:
     virtual ~Provider() = default;
 
+    // One range of a readBatch() call. ok is set by the provider.
+    struct ReadRequest {
+        uint64_t addr;
+        void*    buf;
+        int      len;
+        bool     ok = false;
+    };
+
     // --- Subclasses MUST implement these two ---
     virtual bool read(uint64_t addr, void* buf, int len) const = 0;
     virtual int  size() const = 0;
@@ -54,6 +63,37 @@ public:
         return 0;
     }
 
+    // One mapped range of the source's address space
+    struct Region {
+        enum Perm : uint32_t { Read = 1, Write = 2, Exec = 4 };
+        uint64_t start = 0;
+        uint64_t size  = 0;
+        uint32_t perms = 0;     // Perm bits
+        QString  module;        // backing file name; empty for anonymous memory
+    };
+
+    // Mapped ranges, sorted by start and disjoint. Empty when the provider
+    // does not know its layout (any address may then be tried). Providers
+    // that know it also answer isReadable() from it, without touching the
+    // target.
+    virtual QVector<Region> regions() const { return {}; }
+
+    // Vectored read: fill every request, setting its ok flag. Ranges that
+    // fail read as zeros. Returns true if all of them succeeded.
+    // Providers with a per-call cost (syscall, IPC round trip) override
+    // this to serve the whole batch at once; the default reads one by one.
+    virtual bool readBatch(ReadRequest* reqs, int count) const {
+        bool all = true;
+        for (int i = 0; i < count; i++) {
+            ReadRequest& r = reqs[i];
+            r.ok = r.len >= 0 && (r.len == 0 || read(r.addr, r.buf, r.len));
+            if (!r.ok && r.len > 0)
+                std::memset(r.buf, 0, r.len);
+            all = all && r.ok;
+        }
+        return all;
+    }
+
     // --- Derived convenience (non-virtual, never override) ---
 
     bool isValid() const { return size() > 0; }
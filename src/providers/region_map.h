@@ -0,0 +1,134 @@
+#pragma once
+#include "provider.h"
+#include <algorithm>
+#include <cstring>
+
+namespace rcx {
+
+// Address -> region lookup over a provider's mapped ranges. Regions are
+// disjoint, so a sorted array searched by start is all the interval tree
+// that is needed: every query is one binary search, O(log n).
+class RegionMap {
+public:
+    using Region = Provider::Region;
+
+    RegionMap() = default;
+    // Regions in any order; overlapping ones are trimmed to their
+    // predecessor's end
+    explicit RegionMap(QVector<Region> regions) : m_regions(std::move(regions)) {
+        std::sort(m_regions.begin(), m_regions.end(),
+                  [](const Region& a, const Region& b) { return a.start < b.start; });
+        int w = 0;
+        uint64_t prevEnd = 0;
+        for (int r = 0; r < m_regions.size(); ++r) {
+            Region reg = m_regions[r];
+            if (w > 0 && reg.start < prevEnd) {
+                uint64_t end = reg.start + reg.size;
+                if (end <= prevEnd) continue;
+                reg.size = end - prevEnd;
+                reg.start = prevEnd;
+            }
+            if (reg.size == 0) continue;
+            prevEnd = reg.start + reg.size;
+            m_regions[w++] = reg;
+        }
+        m_regions.resize(w);
+    }
+
+    bool isEmpty() const { return m_regions.isEmpty(); }
+    int  size() const { return m_regions.size(); }
+    const QVector<Region>& regions() const { return m_regions; }
+
+    // The region holding addr, or nullptr
+    const Region* find(uint64_t addr) const {
+        auto it = std::upper_bound(m_regions.cbegin(), m_regions.cend(), addr,
+            [](uint64_t a, const Region& r) { return a < r.start; });
+        if (it == m_regions.cbegin()) return nullptr;
+        --it;
+        return addr - it->start < it->size ? &*it : nullptr;
+    }
+
+    // Whether [addr, addr + len) lies in regions that all carry `perms`
+    // (back-to-back regions count as one range)
+    bool covers(uint64_t addr, int len, uint32_t perms = Region::Read) const {
+        if (len <= 0) return len == 0;
+        uint64_t end = addr + uint64_t(len);
+        if (end < addr) return false;
+        const Region* r = find(addr);
+        if (!r) return false;
+        for (int i = int(r - m_regions.constData()); i < m_regions.size(); ++i) {
+            const Region& reg = m_regions[i];
+            if ((reg.perms & perms) != perms) return false;
+            uint64_t rEnd = reg.start + reg.size;
+            if (rEnd >= end) return true;
+            if (i + 1 < m_regions.size() && m_regions[i + 1].start != rEnd) return false;
+        }
+        return false;
+    }
+
+    // Lines of /proc/<pid>/maps:
+    //   7f3a1c000000-7f3a1c021000 rw-p 00000000 00:00 0      [heap]
+    //   55d0c3a00000-55d0c3a2c000 r-xp 00002000 08:02 173521 /usr/bin/foo
+    // Pseudo paths ("[heap]", "[stack]") count as anonymous.
+    static QVector<Region> parseProcMaps(const QByteArray& text) {
+        QVector<Region> out;
+        const char* p = text.constData();
+        const char* end = p + text.size();
+        while (p < end) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)));
+            if (!eol) eol = end;
+            Region r;
+            if (parseMapsLine(p, eol, &r)) out.append(r);
+            p = eol + 1;
+        }
+        return out;
+    }
+
+private:
+    QVector<Region> m_regions;
+
+    static bool parseHex(const char*& p, const char* end, uint64_t* out) {
+        uint64_t v = 0;
+        const char* start = p;
+        for (; p < end; ++p) {
+            char c = *p;
+            int d = (c >= '0' && c <= '9') ? c - '0'
+                  : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                  : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+            if (d < 0) break;
+            v = (v << 4) | uint64_t(d);
+        }
+        *out = v;
+        return p != start;
+    }
+
+    static void skipField(const char*& p, const char* end) {
+        while (p < end && *p != ' ') ++p;
+        while (p < end && *p == ' ') ++p;
+    }
+
+    static bool parseMapsLine(const char* p, const char* end, Region* r) {
+        uint64_t lo, hi;
+        if (!parseHex(p, end, &lo) || p >= end || *p++ != '-') return false;
+        if (!parseHex(p, end, &hi) || hi <= lo || p >= end || *p++ != ' ') return false;
+        if (end - p < 4) return false;
+        r->start = lo;
+        r->size = hi - lo;
+        r->perms = (p[0] == 'r' ? Region::Read : 0)
+                 | (p[1] == 'w' ? Region::Write : 0)
+                 | (p[2] == 'x' ? Region::Exec : 0);
+        // perms, offset, dev, inode, then the path (may hold spaces)
+        for (int i = 0; i < 4; ++i) skipField(p, end);
+        if (p < end && *p == '/') {
+            const char* slash = p;
+            for (const char* q = p; q < end; ++q)
+                if (*q == '/') slash = q;
+            r->module = QString::fromUtf8(slash + 1, int(end - slash - 1));
+            if (r->module.endsWith(QLatin1String(" (deleted)")))
+                r->module.chop(10);
+        }
+        return true;
+    }
+};
+
+} // namespace rcx
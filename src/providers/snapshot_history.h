@@ -0,0 +1,247 @@
+#pragma once
+#include "page_pool.h"
+#include "snapshot_provider.h"
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <algorithm>
+
+namespace rcx {
+
+// Bounded ring of past snapshots, for scrubbing the view back in time.
+//
+// Frames are stored in groups. The first frame of a group is a keyframe:
+// the whole page table. Every later frame in the group keeps only what
+// differs from that keyframe: byte runs for pages that changed a little,
+// whole pages for pages that changed a lot or that the keyframe lacks,
+// and the keyframe's pages the frame no longer has.
+// Whole pages are interned by content, so a page that flips between a few
+// values is stored once per value, and pages still in the live snapshot
+// are shared pool slots rather than copies.
+//
+// Once the stored bytes exceed the budget, the oldest group is dropped
+// whole (its deltas mean nothing without its keyframe). The newest group
+// is always kept.
+class SnapshotHistory {
+public:
+    static constexpr int kKeyframeInterval = 32;                     // frames per group
+    static constexpr int kMaxDeltaBytes = PagePool::kPageSize / 4;   // beyond this, store the page
+    static constexpr int kRunGap = 16;      // join runs closer than one run's overhead
+
+    void setBudget(int64_t bytes) { m_budget = bytes; evict(); }
+    int64_t budget() const { return m_budget; }
+    int64_t bytesUsed() const { return int64_t(m_interned.size()) * PagePool::kPageSize + m_deltaBytes; }
+
+    int  size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    int  groupCount() const { return m_groups.size(); }
+
+    // Timestamp the frame was recorded with (0 = oldest frame)
+    int64_t timeOf(int frame) const {
+        int g = 0, i = 0;
+        if (!locate(frame, &g, &i)) return 0;
+        return i == 0 ? m_groups[g].keyTime : m_groups[g].deltas[i - 1].timeMs;
+    }
+
+    // Append a frame. Pages should carry their fingerprints (refresh reads
+    // do); unhashed pages are hashed here. Returns how many old frames were
+    // dropped to stay within the budget, so callers can shift indices.
+    int record(const PageTable& pages, int64_t timeMs) {
+        if (m_groups.isEmpty() || m_groups.last().deltas.size() + 1 >= kKeyframeInterval)
+            startGroup(pages, timeMs);
+        else
+            appendDelta(pages, timeMs);
+        ++m_size;
+        return evict();
+    }
+
+    // The page table as it was at `frame`. Pages the frame did not touch
+    // share the keyframe's slots; patched pages are private copies with no
+    // fingerprint.
+    PageTable pagesAt(int frame) const {
+        int g = 0, i = 0;
+        if (!locate(frame, &g, &i)) return {};
+        const Group& group = m_groups[g];
+        if (i == 0) return group.key;
+
+        const Frame& f = group.deltas[i - 1];
+        PageTable table;
+        if (f.dropped.isEmpty()) {
+            table = group.key;
+        } else {
+            table.reserve(group.key.size());
+            for (auto it = group.key.constBegin(); it != group.key.constEnd(); ++it) {
+                if (!std::binary_search(f.dropped.cbegin(), f.dropped.cend(), it.key()))
+                    table.insert(it.key(), it.value(), it.hash());
+            }
+        }
+        for (const auto& w : f.whole)
+            table.insert(w.first, w.second.page, w.second.hash);
+        for (const Run& r : f.runs) {
+            PageBuf* page = table.find(r.page);
+            if (!page) continue;
+            page->detach();
+            std::memcpy(page->data() + r.offset, f.runBytes.constData() + r.data, r.length);
+            table.setHash(r.page, 0);
+        }
+        return table;
+    }
+
+    void clear() {
+        m_groups.clear();
+        m_interned.clear();
+        m_deltaBytes = 0;
+        m_size = 0;
+    }
+
+private:
+    struct Stored {
+        PageBuf  page;
+        uint64_t hash = 0;
+    };
+    struct Run {
+        uint64_t page;
+        uint16_t offset;
+        uint16_t length;
+        int      data;          // into Frame::runBytes
+    };
+    struct Frame {
+        int64_t timeMs = 0;
+        QVector<Run> runs;
+        QByteArray   runBytes;
+        QVector<QPair<uint64_t, Stored>> whole;
+        QVector<uint64_t> dropped;      // keyframe pages gone by this frame, sorted
+    };
+    struct Group {
+        PageTable key;
+        int64_t   keyTime = 0;
+        QVector<Frame> deltas;
+        int64_t   bytes = 0;    // tables, runs and uninterned pages
+    };
+
+    QVector<Group> m_groups;
+    QHash<uint64_t, PageBuf> m_interned;   // content hash -> one copy of the page
+    int64_t m_budget = 64ll * 1024 * 1024;
+    int64_t m_deltaBytes = 0;
+    int     m_size = 0;
+
+    bool locate(int frame, int* group, int* index) const {
+        if (frame < 0 || frame >= m_size) return false;
+        for (int g = 0; g < m_groups.size(); ++g) {
+            int n = 1 + m_groups[g].deltas.size();
+            if (frame < n) { *group = g; *index = frame; return true; }
+            frame -= n;
+        }
+        return false;
+    }
+
+    static uint64_t hashOf(const PageTable::const_iterator& it) {
+        return it.hash() ? it.hash() : SnapshotProvider::pageHash(it.value());
+    }
+
+    // The stored copy of a page with this content. A fingerprint collision
+    // keeps the page as given and charges it to the group.
+    PageBuf intern(const PageBuf& page, uint64_t hash, Group& group) {
+        auto it = m_interned.constFind(hash);
+        if (it == m_interned.constEnd()) {
+            m_interned.insert(hash, page);
+            return page;
+        }
+        if (std::memcmp(it->constData(), page.constData(), PagePool::kPageSize) == 0)
+            return *it;
+        group.bytes += PagePool::kPageSize;
+        m_deltaBytes += PagePool::kPageSize;
+        return page;
+    }
+
+    void startGroup(const PageTable& pages, int64_t timeMs) {
+        m_groups.append(Group{});
+        Group& group = m_groups.last();
+        group.keyTime = timeMs;
+        group.key.reserve(pages.size());
+        for (auto it = pages.constBegin(); it != pages.constEnd(); ++it) {
+            uint64_t h = hashOf(it);
+            group.key.insert(it.key(), intern(it.value(), h, group), h);
+        }
+        group.bytes += int64_t(group.key.capacity()) * int64_t(sizeof(PageTable::Entry));
+        m_deltaBytes += group.bytes;
+    }
+
+    void appendDelta(const PageTable& pages, int64_t timeMs) {
+        Group& group = m_groups.last();
+        Frame f;
+        f.timeMs = timeMs;
+        int kept = 0;           // keyframe pages still present
+        for (auto it = pages.constBegin(); it != pages.constEnd(); ++it) {
+            uint64_t h = hashOf(it);
+            const PageBuf* base = group.key.find(it.key());
+            if (base) ++kept;
+            if (base && group.key.hashOf(it.key()) == h) continue;
+            if (base && appendRuns(*base, it.value(), it.key(), f)) continue;
+            f.whole.append({it.key(), Stored{intern(it.value(), h, group), h}});
+        }
+        if (kept < group.key.size()) {
+            for (auto it = group.key.constBegin(); it != group.key.constEnd(); ++it)
+                if (!pages.contains(it.key())) f.dropped.append(it.key());
+            std::sort(f.dropped.begin(), f.dropped.end());
+        }
+        int64_t bytes = int64_t(sizeof(Frame)) + f.runBytes.size()
+                      + int64_t(f.runs.size()) * int64_t(sizeof(Run))
+                      + int64_t(f.whole.size()) * int64_t(sizeof(QPair<uint64_t, Stored>))
+                      + int64_t(f.dropped.size()) * int64_t(sizeof(uint64_t));
+        group.bytes += bytes;
+        m_deltaBytes += bytes;
+        group.deltas.append(std::move(f));
+    }
+
+    // Record `now` as runs over `base`; false when too much changed
+    bool appendRuns(const PageBuf& base, const PageBuf& now, uint64_t addr, Frame& f) {
+        ChangedRanges diff;
+        SnapshotProvider::diffPage(base.constData(), now.constData(), PagePool::kPageSize, 0, diff);
+        // Close gaps cheaper to copy than to describe
+        QVector<ChangedRanges::Range> runs;
+        int total = 0;
+        for (const auto& r : diff.ranges()) {
+            if (!runs.isEmpty() && r.start - runs.last().end < kRunGap) {
+                total += int(r.end - runs.last().end);
+                runs.last().end = r.end;
+            } else {
+                total += int(r.end - r.start);
+                runs.append(r);
+            }
+            if (total > kMaxDeltaBytes) return false;
+        }
+        for (const auto& r : runs) {
+            f.runs.append(Run{addr, uint16_t(r.start), uint16_t(r.end - r.start), int(f.runBytes.size())});
+            f.runBytes.append(now.constData() + r.start, int(r.end - r.start));
+        }
+        return true;
+    }
+
+    // Drop the oldest groups until within budget. Returns the number of
+    // frames dropped.
+    int evict() {
+        if (bytesUsed() <= m_budget) return 0;
+        prune();
+        int dropped = 0;
+        while (m_groups.size() > 1 && bytesUsed() > m_budget) {
+            const Group& oldest = m_groups.first();
+            dropped += 1 + oldest.deltas.size();
+            m_deltaBytes -= oldest.bytes;
+            m_groups.removeFirst();
+            prune();
+        }
+        m_size -= dropped;
+        return dropped;
+    }
+
+    // Forget interned pages no frame (nor the live snapshot) refers to
+    void prune() {
+        for (auto it = m_interned.begin(); it != m_interned.end();) {
+            if (it->isShared()) ++it;
+            else it = m_interned.erase(it);
+        }
+    }
+};
+
+} // namespace rcx
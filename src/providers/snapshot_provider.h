@@ -1,27 +1,97 @@
 #pragma once
 #include "provider.h"
+#include "page_pool.h"
 #include <QHash>
+#include <QMutex>
+#include <QVector>
+#include <algorithm>
 #include <memory>
 
 namespace rcx {
 
+// Absolute byte ranges [start, end) that changed between two snapshots,
+// kept sorted and non-overlapping so lookups are a binary search.
+class ChangedRanges {
+public:
+    struct Range { int64_t start, end; };
+
+    bool isEmpty() const { return m_ranges.isEmpty(); }
+    int  size() const { return m_ranges.size(); }
+    const QVector<Range>& ranges() const { return m_ranges; }
+    void clear() { m_ranges.clear(); }
+
+    // Ranges must arrive in ascending order; touching ones are coalesced.
+    void append(int64_t start, int64_t end) {
+        if (!m_ranges.isEmpty() && start <= m_ranges.last().end) {
+            m_ranges.last().end = qMax(m_ranges.last().end, end);
+            return;
+        }
+        m_ranges.append(Range{start, end});
+    }
+
+    void unite(const ChangedRanges& other) {
+        if (other.isEmpty()) return;
+        if (isEmpty()) { m_ranges = other.m_ranges; return; }
+        ChangedRanges merged;
+        merged.m_ranges.reserve(m_ranges.size() + other.m_ranges.size());
+        auto a = m_ranges.cbegin(), b = other.m_ranges.cbegin();
+        while (a != m_ranges.cend() || b != other.m_ranges.cend()) {
+            bool takeA = b == other.m_ranges.cend()
+                         || (a != m_ranges.cend() && a->start <= b->start);
+            const Range& r = takeA ? *a++ : *b++;
+            merged.append(r.start, r.end);
+        }
+        m_ranges = std::move(merged.m_ranges);
+    }
+
+    // Does [start, start + len) overlap any changed byte?
+    bool intersects(int64_t start, int64_t len) const {
+        if (len <= 0) return false;
+        auto it = firstEndingAfter(start);
+        return it != m_ranges.cend() && it->start < start + len;
+    }
+
+    // Bit b set if byte start + b changed (n <= 8, one hex preview line)
+    uint8_t byteMask(int64_t start, int n) const {
+        uint8_t mask = 0;
+        int64_t end = start + n;
+        for (auto it = firstEndingAfter(start); it != m_ranges.cend() && it->start < end; ++it) {
+            int64_t lo = qMax(it->start, start), hi = qMin(it->end, end);
+            for (int64_t b = lo; b < hi; ++b)
+                mask |= uint8_t(1u << (b - start));
+        }
+        return mask;
+    }
+
+private:
+    QVector<Range> m_ranges;
+
+    QVector<Range>::const_iterator firstEndingAfter(int64_t pos) const {
+        return std::upper_bound(m_ranges.cbegin(), m_ranges.cend(), pos,
+                                [](int64_t p, const Range& r) { return p < r.end; });
+    }
+};
+
 // Page-based snapshot provider.
 //
 // During async refresh the controller reads pages for the main struct and
 // every reachable pointer target.  Compose reads entirely from this page
 // table — no fallback to the real provider, no blocking I/O on the UI
 // thread.  Pages that were never fetched (truly invalid pointers) simply
-// read as zeros.
+// read as zeros.  Reads only touch the page table, so several compose
+// threads may share one snapshot; symbol lookups go to the real provider
+// one at a time.
 class SnapshotProvider : public Provider {
     std::shared_ptr<Provider> m_real;
-    QHash<uint64_t, QByteArray> m_pages;   // page-aligned addr → 4096-byte page
+    PageTable m_pages;                     // page-aligned addr → pooled 4096-byte page
     int m_mainExtent = 0;                  // logical size of the main struct range
+    mutable QMutex m_symbolMutex;          // serializes getSymbol() on m_real
 
-    static constexpr uint64_t kPageSize = 4096;
+    static constexpr uint64_t kPageSize = PagePool::kPageSize;
     static constexpr uint64_t kPageMask = ~(kPageSize - 1);
 
 public:
-    using PageMap = QHash<uint64_t, QByteArray>;
+    using PageMap = PageTable;
 
     SnapshotProvider(std::shared_ptr<Provider> real, PageMap pages, int mainExtent)
         : m_real(std::move(real))
@@ -37,9 +107,8 @@ public:
             uint64_t pageAddr = cur & kPageMask;
             int pageOff = static_cast<int>(cur - pageAddr);
             int chunk = qMin(remaining, static_cast<int>(kPageSize - pageOff));
-            auto it = m_pages.constFind(pageAddr);
-            if (it != m_pages.constEnd()) {
-                std::memcpy(out, it->constData() + pageOff, chunk);
+            if (const PageBuf* page = m_pages.find(pageAddr)) {
+                std::memcpy(out, page->constData() + pageOff, chunk);
             } else {
                 std::memset(out, 0, chunk);
             }
@@ -65,11 +134,16 @@ public:
     QString name() const override { return m_real ? m_real->name() : QString(); }
     QString kind() const override { return m_real ? m_real->kind() : QStringLiteral("File"); }
     QString getSymbol(uint64_t addr) const override {
-        return m_real ? m_real->getSymbol(addr) : QString();
+        if (!m_real) return {};
+        QMutexLocker lock(&m_symbolMutex);
+        return m_real->getSymbol(addr);
     }
     uint64_t symbolToAddress(const QString& n) const override {
         return m_real ? m_real->symbolToAddress(n) : 0;
     }
+    QVector<Region> regions() const override {
+        return m_real ? m_real->regions() : QVector<Region>();
+    }
 
     bool write(uint64_t addr, const void* buf, int len) override {
         if (!m_real) return false;
@@ -78,10 +152,12 @@ public:
         return ok;
     }
 
-    // Replace the entire page table (called after async read completes)
-    void updatePages(PageMap pages, int mainExtent) {
-        m_pages = std::move(pages);
+    // Replace the entire page table (called after async read completes).
+    // Hands back the old table so the caller can reuse its storage.
+    PageMap updatePages(PageMap pages, int mainExtent) {
+        std::swap(m_pages, pages);
         m_mainExtent = mainExtent;
+        return pages;
     }
 
     // Patch specific bytes in existing pages (called after user writes a value)
@@ -93,9 +169,10 @@ public:
             uint64_t pageAddr = cur & kPageMask;
             int pageOff = static_cast<int>(cur - pageAddr);
             int chunk = qMin(remaining, static_cast<int>(kPageSize - pageOff));
-            auto it = m_pages.find(pageAddr);
-            if (it != m_pages.end()) {
-                std::memcpy(it->data() + pageOff, src, chunk);
+            // Pages may be shared with older snapshots: copy before writing
+            if (PageBuf* page = m_pages.find(pageAddr)) {
+                page->detach();
+                std::memcpy(page->data() + pageOff, src, chunk);
             }
             src += chunk;
             cur += chunk;
@@ -104,6 +181,79 @@ public:
     }
 
     const PageMap& pages() const { return m_pages; }
+
+    // 64-bit page fingerprint: four independent multiply-rotate lanes over
+    // 8-byte words, cheap enough to run on every page read. Two reads of a
+    // page with equal fingerprints are treated as identical.
+    static uint64_t pageHash(const char* p, int len) {
+        constexpr uint64_t kP1 = 0x9E3779B185EBCA87ull, kP2 = 0xC2B2AE3D27D4EB4Full;
+        auto round = [](uint64_t acc, uint64_t w) {
+            acc += w * kP2;
+            acc = (acc << 31) | (acc >> 33);
+            return acc * kP1;
+        };
+        uint64_t v[4] = {kP1 + kP2, kP2, 0, 0 - kP1};
+        int i = 0;
+        for (; i + 32 <= len; i += 32) {
+            for (int l = 0; l < 4; ++l) {
+                uint64_t w;
+                std::memcpy(&w, p + i + l * 8, 8);
+                v[l] = round(v[l], w);
+            }
+        }
+        uint64_t h = uint64_t(len) ^ v[0] ^ round(0, v[1]) ^ round(0, v[2] ^ v[3]);
+        for (; i < len; ++i)
+            h = round(h, uint8_t(p[i]));
+        h ^= h >> 33; h *= kP2; h ^= h >> 29; h *= kP1; h ^= h >> 32;
+        return h;
+    }
+    static uint64_t pageHash(const PageBuf& page) { return pageHash(page.constData(), page.size()); }
+    static uint64_t pageHash(const QByteArray& page) { return pageHash(page.constData(), page.size()); }
+
+    // Byte ranges that differ between two page tables. Pages present in only
+    // one of them are skipped (nothing to compare), and so are pages whose
+    // stored fingerprints match when both tables carry them.
+    static ChangedRanges changedRanges(const PageMap& before, const PageMap& after) {
+        QVector<uint64_t> dirty;
+        for (auto it = after.constBegin(); it != after.constEnd(); ++it) {
+            uint64_t oldHash = before.hashOf(it.key());
+            if (oldHash != 0 && oldHash == it.hash()) continue;
+            if (before.contains(it.key())) dirty.append(it.key());
+        }
+        std::sort(dirty.begin(), dirty.end());
+
+        ChangedRanges changed;
+        for (uint64_t key : dirty) {
+            const PageBuf& oldPage = *before.find(key);
+            const PageBuf& newPage = *after.find(key);
+            diffPage(oldPage.constData(), newPage.constData(),
+                     qMin(oldPage.size(), newPage.size()), int64_t(key), changed);
+        }
+        return changed;
+    }
+
+    // Append the ranges where a and b differ, offset by base. Equal 64-byte
+    // blocks are skipped with memcmp (vectorized by the C library); inside
+    // a dirty block, 8-byte XORs find the words that actually differ.
+    static void diffPage(const char* a, const char* b, int len, int64_t base,
+                         ChangedRanges& out) {
+        if (a == b || std::memcmp(a, b, len) == 0) return;
+        constexpr int kBlock = 64;
+        int i = 0;
+        for (; i + kBlock <= len; i += kBlock) {
+            if (std::memcmp(a + i, b + i, kBlock) == 0) continue;
+            for (int w = i; w < i + kBlock; w += 8) {
+                uint64_t x, y;
+                std::memcpy(&x, a + w, 8);
+                std::memcpy(&y, b + w, 8);
+                if (x == y) continue;
+                for (int k = w; k < w + 8; ++k)
+                    if (a[k] != b[k]) out.append(base + k, base + k + 1);
+            }
+        }
+        for (; i < len; ++i)
+            if (a[i] != b[i]) out.append(base + i, base + i + 1);
+    }
 };
 
 } // namespace rcx
@@ -0,0 +1,291 @@
+#pragma once
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace rcx {
+
+// Address -> "module!symbol+0xoff" for a process's loaded modules.
+// Modules are disjoint intervals searched by base, so every lookup is a
+// binary search. Modules with an on-disk ELF image also resolve function
+// and object names from its .symtab/.dynsym; each table is parsed the first
+// time an address in that module is looked up, on the thread pool, and
+// until it is ready lookups there answer "module+0xoff".
+//
+// Indexes are immutable apart from those tables, so one index serves every
+// document attached to the same process (see shared()).
+class SymbolIndex {
+public:
+    struct Module {
+        QString  name;          // shown in symbols, matched by moduleBase()
+        uint64_t base = 0;
+        uint64_t size = 0;
+        QString  path;          // ELF image on disk; empty for none
+    };
+    // Link-time address (st_value) and size of one function or object
+    struct Symbol {
+        uint64_t addr;
+        uint64_t size;
+        QString  name;
+    };
+    struct SymbolTable {
+        QVector<Symbol> symbols;    // sorted by addr, one per addr
+        uint64_t linkBase = 0;      // vaddr the first PT_LOAD is linked at
+    };
+
+    // Background parses on the thread pool; Inline parses on the looking-up
+    // thread (tests, one-shot tools)
+    enum class Load { Background, Inline };
+
+    explicit SymbolIndex(QVector<Module> modules, Load load = Load::Background)
+        : m_load(load)
+    {
+        std::sort(modules.begin(), modules.end(),
+                  [](const Module& a, const Module& b) { return a.base < b.base; });
+        for (Module& m : modules) {
+            if (m.size == 0) continue;
+            if (!m_modules.isEmpty()) {
+                const Module& prev = m_modules.last();
+                if (m.base < prev.base + prev.size) continue;   // overlaps: first wins
+            }
+            QString key = m.name.toLower();
+            if (!m_byName.contains(key)) m_byName.insert(key, m_modules.size());
+            m_modules.append(std::move(m));
+            m_tables.append(std::make_shared<TableSlot>());
+        }
+    }
+
+    // The index for pid's current modules, shared with every other caller
+    // passing the same list; a changed list (modules loaded or unloaded,
+    // or a new process under a recycled pid) gets a new index
+    static std::shared_ptr<SymbolIndex> shared(uint32_t pid, const QVector<Module>& modules) {
+        static QMutex mutex;
+        static QHash<uint32_t, std::weak_ptr<SymbolIndex>> registry;
+
+        QMutexLocker lock(&mutex);
+        for (auto it = registry.begin(); it != registry.end();) {
+            if (it->expired()) it = registry.erase(it);
+            else ++it;
+        }
+
+        auto index = std::make_shared<SymbolIndex>(modules);
+        if (auto known = registry.value(pid).lock())
+            if (known->sameModules(*index)) return known;
+        registry.insert(pid, index);
+        return index;
+    }
+
+    bool isEmpty() const { return m_modules.isEmpty(); }
+    const QVector<Module>& modules() const { return m_modules; }
+
+    // The module holding addr, or nullptr
+    const Module* moduleAt(uint64_t addr) const {
+        int i = moduleIndex(addr);
+        return i < 0 ? nullptr : &m_modules[i];
+    }
+
+    // Base of the module named `name` (any case), 0 if none
+    uint64_t moduleBase(const QString& name) const {
+        auto it = m_byName.constFind(name.toLower());
+        return it == m_byName.constEnd() ? 0 : m_modules[*it].base;
+    }
+
+    // "libfoo.so!function+0x12", "libfoo.so!function" or "libfoo.so+0x1234";
+    // empty outside every module
+    QString symbolize(uint64_t addr) const {
+        int i = moduleIndex(addr);
+        if (i < 0) return {};
+        const Module& mod = m_modules[i];
+        if (const SymbolTable* table = symbolTable(i)) {
+            uint64_t linkAddr = addr - mod.base + table->linkBase;
+            if (const Symbol* sym = symbolAt(*table, linkAddr)) {
+                uint64_t off = linkAddr - sym->addr;
+                if (off == 0) return mod.name + QLatin1Char('!') + sym->name;
+                return QStringLiteral("%1!%2+0x%3").arg(mod.name, sym->name)
+                    .arg(off, 0, 16, QChar('0'));
+            }
+        }
+        return QStringLiteral("%1+0x%2").arg(mod.name).arg(addr - mod.base, 0, 16, QChar('0'));
+    }
+
+    // Functions and objects of an ELF image (little-endian ELF32/ELF64),
+    // from .symtab and .dynsym both; false if `data` is not such an image
+    static bool parseElfSymbols(const uchar* data, uint64_t size, SymbolTable* out) {
+        if (size < 52 || std::memcmp(data, "\x7f" "ELF", 4) != 0 || data[5] != 1) return false;
+        const bool is64 = data[4] == 2;
+        if (!is64 && data[4] != 1) return false;
+        if (is64 && size < 64) return false;
+        auto word = [&](uint64_t at) { return is64 ? readU64(data + at) : uint64_t(readU32(data + at)); };
+
+        SymbolTable table;
+        // Lowest PT_LOAD, page-aligned: what the module's base maps to
+        const uint64_t phoff = word(is64 ? 32 : 28);
+        const uint16_t phentsz = readU16(data + (is64 ? 54 : 42));
+        const uint16_t phnum = readU16(data + (is64 ? 56 : 44));
+        if (phentsz >= (is64 ? 56 : 32) && phoff <= size
+            && uint64_t(phnum) * phentsz <= size - phoff) {
+            uint64_t low = ~uint64_t(0);
+            for (int i = 0; i < phnum; ++i) {
+                const uint64_t ph = phoff + uint64_t(i) * phentsz;
+                if (readU32(data + ph) != 1) continue;         // PT_LOAD
+                low = qMin(low, word(ph + (is64 ? 16 : 8)));
+            }
+            if (low != ~uint64_t(0)) table.linkBase = low & ~uint64_t(0xFFF);
+        }
+
+        const uint64_t shoff = word(is64 ? 40 : 32);
+        const uint16_t shentsz = readU16(data + (is64 ? 58 : 46));
+        const uint16_t shnum = readU16(data + (is64 ? 60 : 48));
+        if (shentsz < (is64 ? 64 : 40) || shoff > size || uint64_t(shnum) * shentsz > size - shoff) {
+            *out = std::move(table);
+            return true;                    // stripped of section headers
+        }
+        auto section = [&](int i) { return shoff + uint64_t(i) * shentsz; };
+        for (int s = 0; s < shnum; ++s) {
+            const uint64_t sh = section(s);
+            const uint32_t type = readU32(data + sh + 4);
+            if (type != 2 /* SHT_SYMTAB */ && type != 11 /* SHT_DYNSYM */) continue;
+            const uint64_t off = word(sh + (is64 ? 24 : 16));
+            const uint64_t len = word(sh + (is64 ? 32 : 20));
+            const uint32_t link = readU32(data + sh + (is64 ? 40 : 24));
+            const uint64_t entsz = word(sh + (is64 ? 56 : 36));
+            if (link >= shnum || entsz < (is64 ? 24u : 16u) || off > size || len > size - off)
+                continue;
+            const uint64_t strSh = section(int(link));
+            const uint64_t strOff = word(strSh + (is64 ? 24 : 16));
+            const uint64_t strLen = word(strSh + (is64 ? 32 : 20));
+            if (strOff > size || strLen > size - strOff) continue;
+            const char* strs = reinterpret_cast<const char*>(data + strOff);
+
+            for (uint64_t e = off; e + entsz <= off + len; e += entsz) {
+                const uint32_t nameOff = readU32(data + e);
+                const uint8_t info = data[e + (is64 ? 4 : 12)];
+                const uint16_t shndx = readU16(data + e + (is64 ? 6 : 14));
+                const uint64_t value = is64 ? readU64(data + e + 8) : readU32(data + e + 4);
+                const uint64_t symSize = is64 ? readU64(data + e + 16) : readU32(data + e + 8);
+                const int symType = info & 0xF;
+                if (symType != 1 && symType != 2 && symType != 10) continue; // OBJECT, FUNC, IFUNC
+                if (shndx == 0 || value == 0 || nameOff == 0 || nameOff >= strLen) continue;
+                const char* name = strs + nameOff;
+                const void* nul = std::memchr(name, 0, size_t(strLen - nameOff));
+                if (!nul) continue;
+                table.symbols.append(Symbol{value, symSize, QString::fromUtf8(
+                    name, int(static_cast<const char*>(nul) - name))});
+            }
+        }
+
+        // .symtab and .dynsym repeat each other, and aliases share an
+        // address: keep one symbol per address, preferring one with a size,
+        // then the shortest name (fopen over _IO_fopen)
+        std::sort(table.symbols.begin(), table.symbols.end(),
+                  [](const Symbol& a, const Symbol& b) {
+                      if (a.addr != b.addr) return a.addr < b.addr;
+                      if ((a.size > 0) != (b.size > 0)) return a.size > 0;
+                      if (a.name.size() != b.name.size()) return a.name.size() < b.name.size();
+                      return a.name < b.name;
+                  });
+        table.symbols.erase(std::unique(table.symbols.begin(), table.symbols.end(),
+                                        [](const Symbol& a, const Symbol& b) { return a.addr == b.addr; }),
+                            table.symbols.end());
+        *out = std::move(table);
+        return true;
+    }
+
+    // The symbol covering a link-time address: inside its size, or exactly
+    // at a symbol without one
+    static const Symbol* symbolAt(const SymbolTable& table, uint64_t linkAddr) {
+        auto it = std::upper_bound(table.symbols.cbegin(), table.symbols.cend(), linkAddr,
+            [](uint64_t a, const Symbol& s) { return a < s.addr; });
+        if (it == table.symbols.cbegin()) return nullptr;
+        --it;
+        uint64_t off = linkAddr - it->addr;
+        return (off < it->size || off == 0) ? &*it : nullptr;
+    }
+
+private:
+    enum { Unloaded, Loading, Ready };
+    struct TableSlot {
+        std::atomic<int> state{Unloaded};
+        SymbolTable      table;         // written once, before state = Ready
+    };
+
+    class LoadJob : public QRunnable {
+    public:
+        LoadJob(std::shared_ptr<TableSlot> slot, QString path)
+            : m_slot(std::move(slot)), m_path(std::move(path)) {}
+        void run() override { load(*m_slot, m_path); }
+    private:
+        std::shared_ptr<TableSlot> m_slot;
+        QString m_path;
+    };
+
+    QVector<Module>                         m_modules;  // sorted, disjoint
+    QVector<std::shared_ptr<TableSlot>>     m_tables;   // parallel to m_modules
+    QHash<QString, int>                     m_byName;   // lower-case name -> module
+    Load                                    m_load;
+
+    static uint16_t readU16(const uchar* p) { uint16_t v; std::memcpy(&v, p, 2); return v; }
+    static uint32_t readU32(const uchar* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+    static uint64_t readU64(const uchar* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+
+    int moduleIndex(uint64_t addr) const {
+        auto it = std::upper_bound(m_modules.cbegin(), m_modules.cend(), addr,
+            [](uint64_t a, const Module& m) { return a < m.base; });
+        if (it == m_modules.cbegin()) return -1;
+        --it;
+        return addr - it->base < it->size ? int(it - m_modules.cbegin()) : -1;
+    }
+
+    bool sameModules(const SymbolIndex& o) const {
+        if (m_modules.size() != o.m_modules.size()) return false;
+        for (int i = 0; i < m_modules.size(); ++i) {
+            const Module& a = m_modules[i];
+            const Module& b = o.m_modules[i];
+            if (a.base != b.base || a.size != b.size || a.name != b.name || a.path != b.path)
+                return false;
+        }
+        return true;
+    }
+
+    // Module i's table once parsed; the first call starts the parse
+    const SymbolTable* symbolTable(int i) const {
+        TableSlot& slot = *m_tables[i];
+        int state = slot.state.load(std::memory_order_acquire);
+        if (state == Ready) return &slot.table;
+        if (state == Loading || m_modules[i].path.isEmpty()) return nullptr;
+        if (!slot.state.compare_exchange_strong(state, Loading)) {
+            return slot.state.load(std::memory_order_acquire) == Ready ? &slot.table : nullptr;
+        }
+        if (m_load == Load::Inline) {
+            load(slot, m_modules[i].path);
+            return &slot.table;
+        }
+        QThreadPool::globalInstance()->start(new LoadJob(m_tables[i], m_modules[i].path));
+        return nullptr;
+    }
+
+    // Maps the image for as long as the parse takes; only the headers and
+    // symbol sections are paged in
+    static void load(TableSlot& slot, const QString& path) {
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly) && file.size() > 0) {
+            if (uchar* data = file.map(0, file.size())) {
+                parseElfSymbols(data, uint64_t(file.size()), &slot.table);
+                file.unmap(data);
+            }
+        }
+        slot.state.store(Ready, std::memory_order_release);
+    }
+};
+
+} // namespace rcx
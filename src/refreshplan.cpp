@@ -0,0 +1,88 @@
+#include "refreshplan.h"
+#include <algorithm>
+
+namespace rcx {
+
+namespace {
+
+// Bytes a composed line shows from memory (0 for lines that show none of
+// their own: struct headers, footers, containers, and lines rendered as
+// zeros under a null or unreadable pointer)
+int lineDataSpan(const LineMeta& lm, const NodeTree& tree) {
+    if (lm.nullValues) return 0;
+    if (lm.lineKind != LineKind::Field && lm.lineKind != LineKind::Header) return 0;
+    if (lm.lineByteCount > 0) return lm.lineByteCount;
+    if (lm.nodeIdx < 0 || lm.nodeIdx >= tree.nodes.size()) return 0;
+    const Node& node = tree.nodes[lm.nodeIdx];
+    if (lm.isArrayElement) return sizeForKind(lm.elementKind);
+    bool isPointer = node.kind == NodeKind::Pointer32 || node.kind == NodeKind::Pointer64;
+    if (lm.lineKind == LineKind::Header && !isPointer) return 0;
+    if (node.kind == NodeKind::Struct || node.kind == NodeKind::Array) return 0;
+    return node.byteSize();
+}
+
+// An expanded pointer whose target resolved to nothing: its children are
+// laid out at base 0 and read no memory
+bool isNullExpansion(const LineMeta& lm) {
+    return lm.lineKind == LineKind::Header && lm.foldHead && !lm.foldCollapsed
+        && (lm.nodeKind == NodeKind::Pointer32 || lm.nodeKind == NodeKind::Pointer64)
+        && lm.ptrTarget == 0;
+}
+
+} // namespace
+
+int mainDataExtent(const NodeTree& tree, int providerSize) {
+    static constexpr int64_t kMaxMainExtent = 16 * 1024 * 1024; // 16 MB cap
+
+    int64_t treeExtent = tree.dataExtent();
+    if (treeExtent > 0) return static_cast<int>(qMin(treeExtent, kMaxMainExtent));
+    return qMax(0, providerSize);
+}
+
+RefreshPlan planRefresh(const NodeTree& tree, const QVector<LineMeta>& meta,
+                        const ComposeWindow& window, int providerSize,
+                        int64_t pageSize) {
+    const uint64_t pageMask = ~uint64_t(pageSize - 1);
+    RefreshPlan plan;
+    plan.extent = mainDataExtent(tree, providerSize);
+
+    if (meta.size() > 1) {
+        // Sorted and deduplicated at the end: neighbouring lines mostly sit
+        // in the same page, so the vectors stay short
+        uint64_t lastPage = ~uint64_t(0), lastShown = ~uint64_t(0);
+        int nullDepth = -1;     // inside a null expansion opened at this depth
+        for (int ln = 0; ln < meta.size(); ++ln) {
+            const LineMeta& lm = meta[ln];
+            if (nullDepth >= 0) {
+                if (lm.depth > nullDepth) continue;
+                nullDepth = -1;
+            }
+            if (isNullExpansion(lm)) nullDepth = lm.depth;
+            int len = lineDataSpan(lm, tree);
+            if (len <= 0) continue;
+            bool onScreen = !window.isFull() && window.contains(ln);
+            uint64_t end = lm.offsetAddr + len;
+            for (uint64_t p = lm.offsetAddr & pageMask; p < end; p += uint64_t(pageSize)) {
+                if (p != lastPage) plan.wanted.append(p);
+                if (onScreen && p != lastShown) plan.visible.append(p);
+                lastPage = p;
+                if (onScreen) lastShown = p;
+            }
+        }
+        std::sort(plan.wanted.begin(), plan.wanted.end());
+        plan.wanted.erase(std::unique(plan.wanted.begin(), plan.wanted.end()), plan.wanted.end());
+        std::sort(plan.visible.begin(), plan.visible.end());
+        plan.visible.erase(std::unique(plan.visible.begin(), plan.visible.end()), plan.visible.end());
+    }
+    if (!plan.wanted.isEmpty() || plan.extent <= 0) return plan;
+
+    // No layout yet: the whole main struct. The read chases pointer
+    // targets itself.
+    uint64_t start = tree.baseAddress;
+    uint64_t end = start + uint64_t(plan.extent);
+    for (uint64_t p = start & pageMask; p < end; p += uint64_t(pageSize))
+        plan.wanted.append(p);
+    return plan;
+}
+
+} // namespace rcx
@@ -0,0 +1,26 @@
+#pragma once
+#include "core.h"
+
+namespace rcx {
+
+// What an auto-refresh tick needs to read, worked out on the read worker
+// from a copy of the tree and of the composed layout
+struct RefreshPlan {
+    QVector<uint64_t> wanted;    // page addresses the document reads, sorted
+    QVector<uint64_t> visible;   // the subset behind on-screen lines, sorted; empty = all
+    int               extent = 0;   // bytes of the main struct (snapshot size)
+};
+
+// Bytes of the main struct: the tree's data extent (capped at 16 MB), or
+// the provider's size for a tree that covers nothing yet
+int mainDataExtent(const NodeTree& tree, int providerSize);
+
+// Pages behind the lines of `meta` (the layout composed for `tree`; empty
+// when there is none matching the tree), on-screen ones as given by
+// `window`. Collapsed subtrees emit no lines, so they cost nothing. Without
+// a layout, the whole main struct from tree.baseAddress.
+RefreshPlan planRefresh(const NodeTree& tree, const QVector<LineMeta>& meta,
+                        const ComposeWindow& window, int providerSize,
+                        int64_t pageSize);
+
+} // namespace rcx
@@ -0,0 +1,174 @@
+#pragma once
+#include <QHash>
+#include <QVector>
+#include <algorithm>
+#include <cstdint>
+
+namespace rcx {
+
+// Decides which snapshot pages an auto-refresh tick re-reads.
+//
+// Every page carries its own poll interval. A page that changed since its
+// last read halves its interval (down to kMinIntervalMs); one that did not
+// doubles it (up to kMaxBackoff x the base interval). Hot fields end up
+// polled every few tens of milliseconds while a large static structure
+// settles to one read every few seconds.
+//
+// Pages the viewport shows come first: new visible pages are always
+// fetched, and due visible pages are paid for before any off-screen one.
+// Off-screen pages poll kOffscreenSlowdown x slower than their interval,
+// and even their first read waits for budget, so a huge document only
+// costs what is displayed. Due pages share a token bucket of budget()
+// bytes per second, most overdue first.
+class RefreshScheduler {
+public:
+    static constexpr int     kMinIntervalMs = 30;
+    static constexpr int     kMaxBackoff    = 8;
+    static constexpr int     kOffscreenSlowdown = 4;
+    static constexpr int64_t kPageSize      = 4096;
+
+    void setBaseInterval(int ms) { m_baseMs = qMax(1, ms); }
+    int  baseInterval() const { return m_baseMs; }
+    int  minInterval() const { return qMin(kMinIntervalMs, m_baseMs); }
+    int  maxInterval() const { return m_baseMs * kMaxBackoff; }
+
+    void    setBudget(int64_t bytesPerSec) { m_budget = qMax<int64_t>(kPageSize, bytesPerSec); }
+    int64_t budget() const { return m_budget; }
+
+    // Pages to read now, out of the pages the document currently needs
+    // (page-aligned addresses). `visible` is the subset on screen, sorted;
+    // empty means the whole document is. Forgets pages no longer wanted.
+    // The result is sorted by address.
+    QVector<uint64_t> plan(const QVector<uint64_t>& wanted, int64_t nowMs,
+                           const QVector<uint64_t>& visible = {}) {
+        refill(nowMs);
+        m_nextWalkMs = nowMs + m_baseMs;
+
+        QHash<uint64_t, PageState> kept;
+        kept.reserve(wanted.size());
+        QVector<uint64_t> fetch;
+        QVector<QPair<int64_t, uint64_t>> due;   // (due time, page), visible first
+        QVector<QPair<int64_t, uint64_t>> dueOffscreen;
+        for (uint64_t page : wanted) {
+            bool onScreen = visible.isEmpty()
+                || std::binary_search(visible.begin(), visible.end(), page);
+            auto it = m_pages.constFind(page);
+            PageState st = it == m_pages.constEnd()
+                ? PageState{m_baseMs, nowMs, false, onScreen} : *it;
+            st.visible = onScreen;
+            kept.insert(page, st);
+            if (!st.fetched && onScreen) {
+                fetch.append(page);
+                continue;
+            }
+            int64_t dueMs = effectiveDue(st);
+            if (dueMs <= nowMs)
+                (onScreen ? due : dueOffscreen).append({dueMs, page});
+        }
+        m_pages = std::move(kept);
+        for (uint64_t page : fetch)
+            markFetched(m_pages[page], nowMs);
+
+        std::sort(due.begin(), due.end());
+        std::sort(dueOffscreen.begin(), dueOffscreen.end());
+        due += dueOffscreen;
+        for (const auto& d : due) {
+            if (m_tokens < kPageSize) break;
+            m_tokens -= kPageSize;
+            markFetched(m_pages[d.second], nowMs);
+            fetch.append(d.second);
+        }
+        std::sort(fetch.begin(), fetch.end());
+        return fetch;
+    }
+
+    // Pick up a new set of wanted pages on the next tick instead of at the
+    // next periodic walk (the layout or the viewport changed)
+    void wake() { m_nextWalkMs = 0; m_woken = true; }
+
+    // Planning on a worker: fork() hands it a copy to plan() with, join()
+    // takes the copy's page states back. Settings changed and wake() calls
+    // made on this one in between stay in effect.
+    RefreshScheduler fork() {
+        m_woken = false;
+        return *this;
+    }
+    void join(RefreshScheduler&& planned) {
+        m_pages = std::move(planned.m_pages);
+        m_tokens = planned.m_tokens;
+        m_lastRefillMs = planned.m_lastRefillMs;
+        if (!m_woken) m_nextWalkMs = planned.m_nextWalkMs;
+    }
+
+    // Feed back a completed read of a page that had been read before
+    void record(uint64_t page, bool changed, int64_t nowMs) {
+        auto it = m_pages.find(page);
+        if (it == m_pages.end()) return;
+        it->intervalMs = changed ? qMax(minInterval(), it->intervalMs / 2)
+                                 : qMin(maxInterval(), it->intervalMs * 2);
+        it->dueMs = nowMs + it->intervalMs;
+    }
+
+    // Earliest time a tick can have work: a due page the budget can pay
+    // for, or the periodic walk that picks up new pointer targets
+    int64_t nextDueMs(int64_t nowMs) const {
+        int64_t next = m_nextWalkMs;
+        for (auto it = m_pages.constBegin(); it != m_pages.constEnd(); ++it)
+            next = qMin(next, effectiveDue(*it));
+        double tokens = tokensAt(nowMs);
+        if (next <= nowMs && tokens < kPageSize && next < m_nextWalkMs) {
+            int64_t wait = int64_t((kPageSize - tokens) * 1000.0 / m_budget) + 1;
+            next = qMin(m_nextWalkMs, nowMs + wait);
+        }
+        return next;
+    }
+
+    int intervalOf(uint64_t page) const {
+        auto it = m_pages.constFind(page);
+        return it == m_pages.constEnd() ? 0 : it->intervalMs;
+    }
+
+    void clear() {
+        m_pages.clear();
+        m_nextWalkMs = 0;
+        m_lastRefillMs = -1;
+    }
+
+private:
+    struct PageState {
+        int     intervalMs;
+        int64_t dueMs;
+        bool    fetched;    // some read has been issued for it
+        bool    visible;
+    };
+
+    static int64_t effectiveDue(const PageState& st) {
+        if (!st.fetched || st.visible) return st.dueMs;
+        return st.dueMs + int64_t(st.intervalMs) * (kOffscreenSlowdown - 1);
+    }
+    static void markFetched(PageState& st, int64_t nowMs) {
+        st.fetched = true;
+        st.dueMs = nowMs + st.intervalMs;    // until record() says otherwise
+    }
+
+    QHash<uint64_t, PageState> m_pages;
+    int     m_baseMs = 660;
+    int64_t m_budget = 8 * 1024 * 1024;
+    double  m_tokens = 0;
+    int64_t m_lastRefillMs = -1;
+    int64_t m_nextWalkMs = 0;
+    bool    m_woken = false;        // wake() since the last fork()
+
+    // The bucket holds at most one second of budget
+    double tokensAt(int64_t nowMs) const {
+        if (m_lastRefillMs < 0) return double(m_budget);
+        double t = m_tokens + double(m_budget) * double(nowMs - m_lastRefillMs) / 1000.0;
+        return qMin(t, double(m_budget));
+    }
+    void refill(int64_t nowMs) {
+        m_tokens = tokensAt(nowMs);
+        m_lastRefillMs = nowMs;
+    }
+};
+
+} // namespace rcx
@@ -0,0 +1,215 @@
+#include "samplerdialog.h"
+#include "themes/thememanager.h"
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QMessageBox>
+#include <QPainter>
+#include <QVBoxLayout>
+
+namespace rcx {
+
+// ── Sparklines: one row per field over the last few seconds ──
+
+class SparklineView : public QWidget {
+public:
+    static constexpr int64_t kWindowNs = 2000000000LL;
+    static constexpr int kRowHeight = 28;
+    static constexpr int kNameWidth = 160;
+    static constexpr int kValueWidth = 120;
+
+    SparklineView(const QVector<SampledField>& fields, const SampleLog& log, QWidget* parent)
+        : QWidget(parent), m_fields(fields), m_log(log) {
+        setMinimumSize(kNameWidth + kValueWidth + 200, kRowHeight * qMax(1, fields.size()));
+    }
+
+protected:
+    void paintEvent(QPaintEvent*) override {
+        const auto& t = ThemeManager::instance().current();
+        QPainter p(this);
+        p.fillRect(rect(), t.background);
+
+        const int n = m_log.size();
+        const int plotX = kNameWidth;
+        const int plotW = qMax(1, width() - kNameWidth - kValueWidth);
+        const QVector<int64_t>& times = m_log.times();
+        // First sample inside the window
+        int first = 0;
+        if (n > 0) {
+            const int64_t from = times.last() - kWindowNs;
+            first = int(std::lower_bound(times.cbegin(), times.cend(), from) - times.cbegin());
+        }
+        const int64_t t0 = n > 0 ? times.last() - kWindowNs : 0;
+
+        for (int f = 0; f < m_fields.size(); ++f) {
+            const QRect row(0, f * kRowHeight, width(), kRowHeight);
+            p.setPen(t.border);
+            p.drawLine(row.bottomLeft(), row.bottomRight());
+            p.setPen(t.text);
+            p.drawText(row.adjusted(6, 0, 0, 0), Qt::AlignVCenter | Qt::AlignLeft, m_fields[f].name);
+            if (n == 0) continue;
+
+            const SampledField& field = m_fields[f];
+            const QVector<uint64_t>& col = m_log.column(f);
+            p.setPen(t.syntaxNumber);
+            p.drawText(QRect(width() - kValueWidth, row.top(), kValueWidth - 6, kRowHeight),
+                       Qt::AlignVCenter | Qt::AlignRight,
+                       formatSample(field.kind, field.size, col.last()));
+
+            // Scale to the window's range, then draw one min..max bar per
+            // pixel column so a one-sample blip still shows
+            double lo = sampleValue(field.kind, field.size, col[first]), hi = lo;
+            for (int i = first; i < n; ++i) {
+                double v = sampleValue(field.kind, field.size, col[i]);
+                lo = qMin(lo, v);
+                hi = qMax(hi, v);
+            }
+            const double span = hi > lo ? hi - lo : 1.0;
+            const int top = row.top() + 4, h = kRowHeight - 8;
+            auto yOf = [&](double v) { return top + h - int((v - lo) / span * h); };
+
+            p.setPen(t.indHoverSpan);
+            int i = first;
+            for (int x = 0; x < plotW && i < n; ++x) {
+                const int64_t colEnd = t0 + (kWindowNs * (x + 1)) / plotW;
+                if (times[i] >= colEnd) continue;
+                double cmin = sampleValue(field.kind, field.size, col[i]), cmax = cmin;
+                for (; i < n && times[i] < colEnd; ++i) {
+                    double v = sampleValue(field.kind, field.size, col[i]);
+                    cmin = qMin(cmin, v);
+                    cmax = qMax(cmax, v);
+                }
+                p.drawLine(plotX + x, yOf(cmin), plotX + x, yOf(cmax));
+            }
+        }
+    }
+
+private:
+    const QVector<SampledField>& m_fields;
+    const SampleLog& m_log;
+};
+
+// ── Dialog ──
+
+SamplerDialog::SamplerDialog(std::shared_ptr<Provider> prov, QVector<SampledField> fields,
+                             QWidget* parent)
+    : QDialog(parent)
+    , m_prov(std::move(prov))
+    , m_fields(std::move(fields))
+    , m_log(m_fields.size())
+{
+    setWindowTitle(QStringLiteral("Sample Fields"));
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    auto* mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(8);
+    mainLayout->setContentsMargins(10, 10, 10, 10);
+
+    auto* controls = new QHBoxLayout;
+    controls->addWidget(new QLabel(QStringLiteral("Rate:")));
+    m_rateSpin = new QSpinBox;
+    m_rateSpin->setRange(1, FieldSampler::kMaxRateHz);
+    m_rateSpin->setSuffix(QStringLiteral(" Hz"));
+    m_rateSpin->setValue(1000);
+    controls->addWidget(m_rateSpin);
+    m_startBtn = new QPushButton(QStringLiteral("Start"));
+    controls->addWidget(m_startBtn);
+    controls->addStretch();
+    m_csvBtn = new QPushButton(QStringLiteral("Export CSV..."));
+    m_binBtn = new QPushButton(QStringLiteral("Export Binary..."));
+    controls->addWidget(m_csvBtn);
+    controls->addWidget(m_binBtn);
+    mainLayout->addLayout(controls);
+
+    m_view = new SparklineView(m_fields, m_log, this);
+    mainLayout->addWidget(m_view, 1);
+
+    m_status = new QLabel;
+    mainLayout->addWidget(m_status);
+    updateStatus();
+
+    connect(m_startBtn, &QPushButton::clicked, this, &SamplerDialog::toggleSampling);
+    connect(m_csvBtn, &QPushButton::clicked, this, [this]() { exportSamples(false); });
+    connect(m_binBtn, &QPushButton::clicked, this, [this]() { exportSamples(true); });
+
+    // The GUI drains at screen rate; the ring absorbs everything in between
+    m_drainTimer = new QTimer(this);
+    m_drainTimer->setInterval(33);
+    connect(m_drainTimer, &QTimer::timeout, this, &SamplerDialog::drain);
+}
+
+SamplerDialog::~SamplerDialog() {
+    stopSampling();
+}
+
+void SamplerDialog::toggleSampling() {
+    if (m_sampler) {
+        stopSampling();
+        return;
+    }
+    m_log.clear();
+    m_dropped = 0;
+    m_failed = 0;
+    m_sampler = std::make_unique<FieldSampler>(m_prov, m_fields, m_rateSpin->value());
+    m_sampler->start();
+    m_drainTimer->start();
+    m_startBtn->setText(QStringLiteral("Stop"));
+    m_rateSpin->setEnabled(false);
+}
+
+void SamplerDialog::stopSampling() {
+    if (!m_sampler) return;
+    m_sampler->stop();
+    drain();
+    m_dropped += m_sampler->ring().dropped();
+    m_failed += m_sampler->failedReads();
+    m_sampler.reset();
+    m_drainTimer->stop();
+    m_startBtn->setText(QStringLiteral("Start"));
+    m_rateSpin->setEnabled(true);
+    updateStatus();
+}
+
+void SamplerDialog::drain() {
+    if (!m_sampler) return;
+    m_sampler->ring().drain([this](int64_t t, const uint64_t* values) {
+        m_log.append(t, values);
+    });
+    updateStatus();
+    m_view->update();
+}
+
+void SamplerDialog::updateStatus() {
+    uint64_t dropped = m_dropped + (m_sampler ? m_sampler->ring().dropped() : 0);
+    uint64_t failed = m_failed + (m_sampler ? m_sampler->failedReads() : 0);
+    double seconds = m_log.size() > 0 ? double(m_log.times().last()) / 1e9 : 0.0;
+    QString text = QStringLiteral("%1 fields, %2 samples over %3 s")
+        .arg(m_fields.size()).arg(m_log.size()).arg(seconds, 0, 'f', 2);
+    if (m_sampler)
+        text += QStringLiteral(", %1 read(s) per sample").arg(m_sampler->spanCount());
+    if (dropped)
+        text += QStringLiteral(", %1 dropped").arg(dropped);
+    if (failed)
+        text += QStringLiteral(", %1 failed").arg(failed);
+    m_status->setText(text);
+    m_csvBtn->setEnabled(m_log.size() > 0);
+    m_binBtn->setEnabled(m_log.size() > 0);
+}
+
+void SamplerDialog::exportSamples(bool binary) {
+    QString path = QFileDialog::getSaveFileName(this,
+        binary ? QStringLiteral("Export Samples") : QStringLiteral("Export Samples as CSV"),
+        QString(),
+        binary ? QStringLiteral("Sample files (*.rcxsamples);;All files (*)")
+               : QStringLiteral("CSV files (*.csv);;All files (*)"));
+    if (path.isEmpty()) return;
+
+    QFile file(path);
+    bool ok = file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        && (binary ? m_log.writeBinary(file, m_fields) : m_log.writeCsv(file, m_fields));
+    if (!ok)
+        QMessageBox::warning(this, QStringLiteral("Export Samples"),
+                             QStringLiteral("Could not write %1:\n%2").arg(path, file.errorString()));
+}
+
+} // namespace rcx
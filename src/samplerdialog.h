@@ -0,0 +1,46 @@
+#pragma once
+#include "fieldsampler.h"
+#include <QDialog>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTimer>
+#include <memory>
+
+namespace rcx {
+
+class SparklineView;
+
+// Non-modal window around a FieldSampler: pick a rate, start and stop, watch
+// one sparkline per field, export what was captured
+class SamplerDialog : public QDialog {
+    Q_OBJECT
+public:
+    SamplerDialog(std::shared_ptr<Provider> prov, QVector<SampledField> fields,
+                  QWidget* parent = nullptr);
+    ~SamplerDialog() override;
+
+private:
+    void toggleSampling();
+    void stopSampling();
+    void drain();
+    void updateStatus();
+    void exportSamples(bool binary);
+
+    std::shared_ptr<Provider>     m_prov;
+    QVector<SampledField>         m_fields;
+    std::unique_ptr<FieldSampler> m_sampler;
+    SampleLog                     m_log;
+    uint64_t                      m_dropped = 0;    // by samplers already stopped
+    uint64_t                      m_failed = 0;     // likewise, samples not read
+
+    QSpinBox*      m_rateSpin  = nullptr;
+    QPushButton*   m_startBtn  = nullptr;
+    QPushButton*   m_csvBtn    = nullptr;
+    QPushButton*   m_binBtn    = nullptr;
+    QLabel*        m_status    = nullptr;
+    SparklineView* m_view      = nullptr;
+    QTimer*        m_drainTimer = nullptr;
+};
+
+} // namespace rcx
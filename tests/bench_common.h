@@ -0,0 +1,246 @@
+#pragma once
+// Shared helpers for the headless benchmarks (bench_compose, bench_refresh):
+// synthetic tree builders, heap allocation counting and peak-RSS probes.
+//
+// Include from exactly one translation unit per executable: on glibc it
+// interposes malloc/calloc/realloc to count every heap allocation,
+// including the ones Qt containers make behind operator new's back.
+#include "core.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtTest/QtTest>
+#include <atomic>
+#include <cstring>
+
+#if defined(__GLIBC__)
+#include <sys/resource.h>
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+}
+#endif
+
+namespace bench {
+
+inline std::atomic<uint64_t> g_allocs{0};
+
+} // namespace bench
+
+#if defined(__GLIBC__)
+extern "C" void* malloc(size_t n) {
+    bench::g_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(n);
+}
+extern "C" void* calloc(size_t n, size_t sz) {
+    bench::g_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, sz);
+}
+extern "C" void* realloc(void* p, size_t n) {
+    bench::g_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, n);
+}
+#endif
+
+namespace bench {
+
+using namespace rcx;
+
+inline bool allocCountingAvailable() {
+#if defined(__GLIBC__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Reset the kernel's peak-RSS mark so the next peakRssKb() covers only what
+// runs in between (Linux >= 4.0; elsewhere the peak is process-wide).
+inline void resetPeakRss() {
+    QFile f(QStringLiteral("/proc/self/clear_refs"));
+    if (f.open(QIODevice::WriteOnly))
+        f.write("5");
+}
+
+inline long peakRssKb() {
+    QFile f(QStringLiteral("/proc/self/status"));
+    if (f.open(QIODevice::ReadOnly)) {
+        for (const QByteArray& line : f.readAll().split('\n')) {
+            if (line.startsWith("VmHWM:"))
+                return line.mid(6).trimmed().split(' ').value(0).toLong();
+        }
+    }
+#if defined(__GLIBC__)
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0)
+        return ru.ru_maxrss;
+#endif
+    return -1;
+}
+
+// One measured run: wall time, heap allocations and peak RSS over the span
+// between construction and report().
+class Probe {
+    QElapsedTimer m_timer;
+    uint64_t      m_allocs0;
+public:
+    Probe() {
+        resetPeakRss();
+        m_allocs0 = g_allocs.load(std::memory_order_relaxed);
+        m_timer.start();
+    }
+
+    qint64 elapsedNs() const { return m_timer.nsecsElapsed(); }
+
+    void report(const char* what, int lines) const {
+        qint64 ns = m_timer.nsecsElapsed();
+        uint64_t allocs = g_allocs.load(std::memory_order_relaxed) - m_allocs0;
+        QString allocText = allocCountingAvailable() ? QString::number(allocs)
+                                                     : QStringLiteral("n/a");
+        qDebug().noquote() << QStringLiteral("  %1: %2 ms, %3 lines, %4 ns/line, %5 allocs, peak %6 MB")
+            .arg(QString::fromLatin1(what))
+            .arg(ns / 1e6, 0, 'f', 2)
+            .arg(lines)
+            .arg(lines > 0 ? double(ns) / lines : 0.0, 0, 'f', 1)
+            .arg(allocText)
+            .arg(peakRssKb() / 1024.0, 0, 'f', 1);
+    }
+};
+
+// ── Synthetic trees ──
+// Every builder returns a tree rooted at baseAddress 0 (not the NodeTree
+// default, which would put every read past the end of the buffer) and the
+// backing bytes for a BufferProvider, filled with a deterministic pattern.
+
+struct Synthetic {
+    NodeTree   tree;
+    QByteArray data;
+    uint64_t   rootId = 0;
+};
+
+inline uint64_t addStruct(NodeTree& tree, uint64_t parentId, int offset,
+                          const QString& name, const QString& typeName = {}) {
+    Node n;
+    n.kind = NodeKind::Struct;
+    n.name = name;
+    n.structTypeName = typeName;
+    n.parentId = parentId;
+    n.offset = offset;
+    return tree.nodes[tree.addNode(n)].id;
+}
+
+inline void addField(NodeTree& tree, uint64_t parentId, int offset,
+                     NodeKind kind, const QString& name) {
+    Node n;
+    n.kind = kind;
+    n.name = name;
+    n.parentId = parentId;
+    n.offset = offset;
+    tree.addNode(n);
+}
+
+inline void fillPattern(QByteArray& data) {
+    for (int i = 0; i < data.size(); i++)
+        data[i] = char((i * 131 + 7) & 0xFF);
+}
+
+// `count` leaf fields split into 16-field sub-structs under one root
+inline Synthetic makeNested(int count) {
+    static const NodeKind kKinds[] = {
+        NodeKind::Hex64, NodeKind::UInt32, NodeKind::Int32, NodeKind::Float,
+        NodeKind::Hex32, NodeKind::UInt16, NodeKind::Double, NodeKind::Bool
+    };
+    Synthetic s;
+    s.tree.baseAddress = 0;
+    s.rootId = addStruct(s.tree, 0, 0, QStringLiteral("Root"), QStringLiteral("Root"));
+    const int kGroup = 16;
+    int groups = (count + kGroup - 1) / kGroup;
+    int groupSize = kGroup * 8;
+    for (int g = 0; g < groups; g++) {
+        uint64_t sid = addStruct(s.tree, s.rootId, g * groupSize,
+                                 QStringLiteral("group%1").arg(g),
+                                 QStringLiteral("Group%1").arg(g % 64));
+        for (int f = 0; f < kGroup && g * kGroup + f < count; f++)
+            addField(s.tree, sid, f * 8, kKinds[f % 8], QStringLiteral("field_%1").arg(f));
+    }
+    s.data = QByteArray(groups * groupSize, '\0');
+    fillPattern(s.data);
+    return s;
+}
+
+// `depth` structs linked by expanded typed pointers: Link0.next -> Link1 -> ...
+// Every link is a root of its own, so compose from rootId to get one chain
+// (composing all roots expands the rest of the chain under each of them).
+inline Synthetic makePointerChain(int depth) {
+    const int kLinkSize = 32;
+    Synthetic s;
+    s.tree.baseAddress = 0;
+    s.data = QByteArray((depth + 1) * kLinkSize, '\0');
+    fillPattern(s.data);
+
+    QVector<uint64_t> linkIds;
+    for (int i = 0; i < depth; i++) {
+        uint64_t id = addStruct(s.tree, 0, i * kLinkSize,
+                                QStringLiteral("Link%1").arg(i), QStringLiteral("Link%1").arg(i));
+        addField(s.tree, id, 8, NodeKind::UInt64, QStringLiteral("value"));
+        addField(s.tree, id, 16, NodeKind::Float, QStringLiteral("weight"));
+        linkIds.append(id);
+    }
+    s.rootId = linkIds.first();
+    for (int i = 0; i < depth; i++) {
+        Node ptr;
+        ptr.kind = NodeKind::Pointer64;
+        ptr.name = QStringLiteral("next");
+        ptr.parentId = linkIds[i];
+        ptr.offset = 0;
+        ptr.refId = linkIds[(i + 1) % depth];
+        ptr.collapsed = false;
+        s.tree.addNode(ptr);
+        // Link i lives at i * kLinkSize in the buffer and points to the next one
+        uint64_t next = uint64_t(i + 1) * kLinkSize;
+        std::memcpy(s.data.data() + i * kLinkSize, &next, sizeof(next));
+    }
+    return s;
+}
+
+// One primitive array with `count` uint32 elements
+inline Synthetic makeBigArray(int count) {
+    Synthetic s;
+    s.tree.baseAddress = 0;
+    s.rootId = addStruct(s.tree, 0, 0, QStringLiteral("Root"), QStringLiteral("Root"));
+    Node arr;
+    arr.kind = NodeKind::Array;
+    arr.name = QStringLiteral("elements");
+    arr.parentId = s.rootId;
+    arr.elementKind = NodeKind::UInt32;
+    arr.arrayLen = count;
+    s.tree.addNode(arr);
+    s.data = QByteArray(count * 4, '\0');
+    fillPattern(s.data);
+    return s;
+}
+
+// A union with `count` overlapping members of mixed kinds at offset 0
+inline Synthetic makeWideUnion(int count) {
+    static const NodeKind kKinds[] = {
+        NodeKind::UInt8, NodeKind::UInt16, NodeKind::UInt32, NodeKind::UInt64,
+        NodeKind::Float, NodeKind::Double, NodeKind::Hex64, NodeKind::Vec4
+    };
+    Synthetic s;
+    s.tree.baseAddress = 0;
+    s.rootId = addStruct(s.tree, 0, 0, QStringLiteral("Root"), QStringLiteral("Root"));
+    uint64_t uid = addStruct(s.tree, s.rootId, 0, QStringLiteral("u"), QStringLiteral("Wide"));
+    s.tree.nodes[s.tree.indexOfId(uid)].classKeyword = QStringLiteral("union");
+    for (int i = 0; i < count; i++)
+        addField(s.tree, uid, 0, kKinds[i % 8], QStringLiteral("as_%1").arg(i));
+    s.data = QByteArray(64, '\0');
+    fillPattern(s.data);
+    return s;
+}
+
+// 1M-node rows take seconds and gigabytes; run them on demand only
+inline bool largeRowsEnabled() {
+    return qEnvironmentVariableIsSet("RCX_BENCH_1M");
+}
+
+} // namespace bench
@@ -0,0 +1,149 @@
+#include "bench_common.h"
+#include "generator.h"
+
+using namespace rcx;
+using namespace bench;
+
+// Headless compose benchmarks on synthetic trees. Each row prints wall time,
+// ns/line, heap allocations and peak RSS; the QVERIFYs only guard against
+// a benchmark silently measuring an empty compose.
+class BenchCompose : public QObject {
+    Q_OBJECT
+private slots:
+    void benchFullCompose_data();
+    void benchFullCompose();
+    void benchWindowedCompose_data();
+    void benchWindowedCompose();
+    void benchCachedRecompose_data();
+    void benchCachedRecompose();
+    void benchRenderCppAll_data();
+    void benchRenderCppAll();
+};
+
+enum class Shape { Nested, PointerChain, BigArray, WideUnion };
+Q_DECLARE_METATYPE(Shape)
+
+static Synthetic build(Shape shape, int n) {
+    switch (shape) {
+    case Shape::Nested:       return makeNested(n);
+    case Shape::PointerChain: return makePointerChain(n);
+    case Shape::BigArray:     return makeBigArray(n);
+    case Shape::WideUnion:    return makeWideUnion(n);
+    }
+    return {};
+}
+
+static void addShapeRows() {
+    QTest::addColumn<Shape>("shape");
+    QTest::addColumn<int>("n");
+    QTest::addColumn<bool>("large");
+
+    QTest::newRow("nested 10k")       << Shape::Nested << 10000 << false;
+    QTest::newRow("nested 100k")      << Shape::Nested << 100000 << false;
+    QTest::newRow("nested 1M")        << Shape::Nested << 1000000 << true;
+    // Compose recurses once per link followed: keep chains within the
+    // smallest default stack (1 MB on Windows)
+    QTest::newRow("ptr chain 100")    << Shape::PointerChain << 100 << false;
+    QTest::newRow("ptr chain 300")    << Shape::PointerChain << 300 << false;
+    QTest::newRow("array 100k")       << Shape::BigArray << 100000 << false;
+    QTest::newRow("array 1M")         << Shape::BigArray << 1000000 << true;
+    QTest::newRow("wide union 10k")   << Shape::WideUnion << 10000 << false;
+}
+
+#define SKIP_LARGE_ROW() \
+    do { if (large && !largeRowsEnabled()) QSKIP("set RCX_BENCH_1M=1 to run 1M rows"); } while (0)
+
+void BenchCompose::benchFullCompose_data() { addShapeRows(); }
+
+void BenchCompose::benchFullCompose() {
+    QFETCH(Shape, shape);
+    QFETCH(int, n);
+    QFETCH(bool, large);
+    SKIP_LARGE_ROW();
+
+    Synthetic s = build(shape, n);
+    BufferProvider prov(s.data);
+
+    Probe probe;
+    ComposeResult r = compose(s.tree, prov, s.rootId);
+    probe.report("full compose", r.meta.size());
+    QVERIFY(r.meta.size() > 0);
+    // Every link followed adds its header, two fields and its next pointer;
+    // a chain that never expands composes to a handful of lines
+    if (shape == Shape::PointerChain)
+        QVERIFY(r.meta.size() >= 4 * n);
+}
+
+void BenchCompose::benchWindowedCompose_data() { addShapeRows(); }
+
+void BenchCompose::benchWindowedCompose() {
+    QFETCH(Shape, shape);
+    QFETCH(int, n);
+    QFETCH(bool, large);
+    SKIP_LARGE_ROW();
+
+    Synthetic s = build(shape, n);
+    BufferProvider prov(s.data);
+
+    // A 60-line viewport in the middle of the document
+    int total = compose(s.tree, prov, s.rootId).meta.size();
+    ComposeWindow window;
+    window.add(total / 2, total / 2 + 59);
+
+    Probe probe;
+    ComposeResult r = compose(s.tree, prov, s.rootId, false, window);
+    probe.report("windowed compose", r.meta.size());
+    QCOMPARE(r.meta.size(), total);
+}
+
+void BenchCompose::benchCachedRecompose_data() { addShapeRows(); }
+
+void BenchCompose::benchCachedRecompose() {
+    QFETCH(Shape, shape);
+    QFETCH(int, n);
+    QFETCH(bool, large);
+    SKIP_LARGE_ROW();
+
+    Synthetic s = build(shape, n);
+    BufferProvider prov(s.data);
+    ComposeCache cache;
+    compose(s.tree, prov, s.rootId, false, {}, &cache);
+
+    // Rename the last node: only its container should be recomposed
+    Node& last = s.tree.nodes.last();
+    last.name = QStringLiteral("renamed");
+    cache.markDirty(last.id);
+
+    Probe probe;
+    ComposeResult r = compose(s.tree, prov, s.rootId, false, {}, &cache);
+    probe.report("cached recompose", r.meta.size());
+    qDebug() << "  fragments replayed:" << cache.replayed;
+    QVERIFY(r.text.contains(QStringLiteral("renamed")));
+}
+
+void BenchCompose::benchRenderCppAll_data() {
+    QTest::addColumn<Shape>("shape");
+    QTest::addColumn<int>("n");
+    QTest::addColumn<bool>("large");
+
+    QTest::newRow("nested 10k")     << Shape::Nested << 10000 << false;
+    QTest::newRow("nested 100k")    << Shape::Nested << 100000 << false;
+    QTest::newRow("ptr chain 10k")  << Shape::PointerChain << 10000 << false;
+}
+
+void BenchCompose::benchRenderCppAll() {
+    QFETCH(Shape, shape);
+    QFETCH(int, n);
+    QFETCH(bool, large);
+    SKIP_LARGE_ROW();
+
+    Synthetic s = build(shape, n);
+
+    Probe probe;
+    QString text = renderCppAll(s.tree);
+    probe.report("renderCppAll", text.count(QLatin1Char('\n')));
+    QVERIFY(!text.isEmpty());
+}
+
+QTEST_MAIN(BenchCompose)
+#include "bench_compose.moc"
@@ -0,0 +1,164 @@
+#include "bench_common.h"
+#include "providers/snapshot_provider.h"
+#include <cstring>
+
+using namespace rcx;
+using namespace bench;
+
+// Headless benchmarks for the per-tick refresh path: the value-only pass
+// against a full compose, page fingerprinting and diffing, page table and
+// pool reuse across ticks, and the data-extent walk.
+class BenchRefresh : public QObject {
+    Q_OBJECT
+private slots:
+    void benchValuePass_data();
+    void benchValuePass();
+    void benchChangedRanges_data();
+    void benchChangedRanges();
+    void benchPageRecycle_data();
+    void benchPageRecycle();
+    void benchDataExtent_data();
+    void benchDataExtent();
+};
+
+static void addSizeRows() {
+    QTest::addColumn<int>("n");
+    QTest::addColumn<bool>("large");
+    QTest::newRow("10k")  << 10000 << false;
+    QTest::newRow("100k") << 100000 << false;
+    QTest::newRow("1M")   << 1000000 << true;
+}
+
+#define SKIP_LARGE_ROW() \
+    do { if (large && !largeRowsEnabled()) QSKIP("set RCX_BENCH_1M=1 to run 1M rows"); } while (0)
+
+// Flip every 64th byte, roughly what a live target does between ticks
+static void mutate(QByteArray& data) {
+    for (int i = 0; i < data.size(); i += 64)
+        data[i] = char(data[i] + 1);
+}
+
+void BenchRefresh::benchValuePass_data() { addSizeRows(); }
+
+void BenchRefresh::benchValuePass() {
+    QFETCH(int, n);
+    QFETCH(bool, large);
+    SKIP_LARGE_ROW();
+
+    Synthetic s = makeNested(n);
+    ComposeResult r = compose(s.tree, BufferProvider(s.data));
+    mutate(s.data);
+    BufferProvider prov(s.data);
+
+    {
+        Probe probe;
+        ComposeResult full = compose(s.tree, prov);
+        probe.report("full compose", full.meta.size());
+    }
+    {
+        Probe probe;
+        bool ok = recomposeValues(r, s.tree, prov);
+        probe.report("value pass", r.meta.size());
+        QVERIFY(ok);
+    }
+}
+
+void BenchRefresh::benchChangedRanges_data() {
+    QTest::addColumn<int>("pages");
+    QTest::addColumn<int>("dirtyEvery");
+    QTest::newRow("256 pages, all clean")   << 256 << 0;
+    QTest::newRow("256 pages, 1 in 16")     << 256 << 16;
+    QTest::newRow("4096 pages, all clean")  << 4096 << 0;
+    QTest::newRow("4096 pages, 1 in 16")    << 4096 << 16;
+    QTest::newRow("4096 pages, all dirty")  << 4096 << 1;
+}
+
+void BenchRefresh::benchChangedRanges() {
+    QFETCH(int, pages);
+    QFETCH(int, dirtyEvery);
+
+    const int kPage = 4096;
+    SnapshotProvider::PageMap before, after;
+    for (int p = 0; p < pages; p++) {
+        QByteArray page(kPage, '\0');
+        fillPattern(page);
+        before.insert(uint64_t(p) * kPage, PageBuf::fromBytes(page));
+        if (dirtyEvery > 0 && p % dirtyEvery == 0)
+            mutate(page);
+        after.insert(uint64_t(p) * kPage, PageBuf::fromBytes(page));
+    }
+
+    {
+        Probe probe;
+        for (auto it = after.constBegin(); it != after.constEnd(); ++it)
+            after.setHash(it.key(), SnapshotProvider::pageHash(it.value()));
+        probe.report("pageHash", pages);
+    }
+    for (auto it = before.constBegin(); it != before.constEnd(); ++it)
+        before.setHash(it.key(), SnapshotProvider::pageHash(it.value()));
+
+    Probe probe;
+    ChangedRanges changed = SnapshotProvider::changedRanges(before, after);
+    probe.report("changedRanges", pages);
+    qDebug() << "  changed ranges:" << changed.size();
+    if (dirtyEvery == 0)
+        QVERIFY(changed.isEmpty());
+    else
+        QVERIFY(!changed.isEmpty());
+}
+
+void BenchRefresh::benchPageRecycle_data() {
+    QTest::addColumn<int>("pages");
+    QTest::newRow("256 pages")  << 256;
+    QTest::newRow("4096 pages") << 4096;
+}
+
+// The refresh tick's page bookkeeping: fill a recycled table from the pool,
+// keep a copy to diff the next tick against, hand the old table back. Once
+// warm, ticks should not touch the heap.
+void BenchRefresh::benchPageRecycle() {
+    QFETCH(int, pages);
+    const int kTicks = 50;
+    PagePool& pool = PagePool::instance();
+    SnapshotProvider::PageMap spare, prev, snapshot;
+
+    auto tick = [&]() {
+        SnapshotProvider::PageMap read = std::move(spare);
+        read.reserve(pages);
+        for (int p = 0; p < pages; p++) {
+            PageBuf& page = read.insert(uint64_t(p) * 4096, pool.acquire());
+            std::memset(page.data(), p & 0xFF, 4096);
+        }
+        prev = read;
+        std::swap(snapshot, read);
+        read.clear();
+        spare = std::move(read);
+    };
+    tick();
+    tick();
+
+    int slabs = pool.slabCount();
+    Probe probe;
+    for (int t = 0; t < kTicks; t++)
+        tick();
+    probe.report("recycled tick", pages * kTicks);
+    QCOMPARE(pool.slabCount(), slabs);
+}
+
+void BenchRefresh::benchDataExtent_data() { addSizeRows(); }
+
+void BenchRefresh::benchDataExtent() {
+    QFETCH(int, n);
+    QFETCH(bool, large);
+    SKIP_LARGE_ROW();
+
+    Synthetic s = makeNested(n);
+
+    Probe probe;
+    int64_t extent = s.tree.dataExtent();
+    probe.report("dataExtent", s.tree.nodes.size());
+    QCOMPARE(extent, int64_t(s.data.size()));
+}
+
+QTEST_MAIN(BenchRefresh)
+#include "bench_refresh.moc"
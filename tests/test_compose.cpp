@@ -50,8 +50,8 @@ private slots:
         QCOMPARE(result.meta[2].depth, 1);
 
         // Offset text
-        QCOMPARE(result.meta[1].offsetText, QString("0000 "));
-        QCOMPARE(result.meta[2].offsetText, QString("0004 "));
+        QCOMPARE(fmt::fmtOffsetMargin(result.meta[1], result.layout.offsetHexDigits), QString("0000 "));
+        QCOMPARE(fmt::fmtOffsetMargin(result.meta[2], result.layout.offsetHexDigits), QString("0004 "));
 
         // Line 3 is root footer
         QCOMPARE(result.meta[3].lineKind, LineKind::Footer);
@@ -83,7 +83,7 @@ private slots:
 
         // Line 1: single Vec3 line, not continuation, depth 1
         QVERIFY(!result.meta[1].isContinuation);
-        QCOMPARE(result.meta[1].offsetText, QString("0000 "));
+        QCOMPARE(fmt::fmtOffsetMargin(result.meta[1], result.layout.offsetHexDigits), QString("0000 "));
         QCOMPARE(result.meta[1].depth, 1);
         QCOMPARE(result.meta[1].nodeKind, NodeKind::Vec3);
 
@@ -959,6 +959,472 @@ private slots:
                  qPrintable("Collapsed header should not have '{': " + lines[arrLine]));
     }
 
+    void testComposeWindowMaterializesOnlyRange() {
+        // Large primitive array: lines outside the window keep their mapping
+        // (node, element index, address, fold level) but have no text
+        NodeTree tree;
+        tree.baseAddress = 0x1000;
+
+        Node root;
+        root.kind = NodeKind::Struct;
+        root.name = "Root";
+        root.parentId = 0;
+        int ri = tree.addNode(root);
+        uint64_t rootId = tree.nodes[ri].id;
+
+        Node arr;
+        arr.kind = NodeKind::Array;
+        arr.name = "samples";
+        arr.parentId = rootId;
+        arr.offset = 0;
+        arr.elementKind = NodeKind::UInt32;
+        arr.arrayLen = 5000;
+        tree.addNode(arr);
+
+        Node tail;
+        tail.kind = NodeKind::Hex32;
+        tail.name = "tail";
+        tail.parentId = rootId;
+        tail.offset = 5000 * 4;
+        tree.addNode(tail);
+
+        NullProvider prov;
+        ComposeResult full = compose(tree, prov);
+
+        ComposeWindow window;
+        window.add(2000, 2050);
+        ComposeResult part = compose(tree, prov, 0, false, window);
+
+        // Same line index as the full compose
+        QCOMPARE(part.meta.size(), full.meta.size());
+        QStringList fullLines = full.text.split('\n');
+        QStringList partLines = part.text.split('\n');
+        QCOMPARE(partLines.size(), fullLines.size());
+
+        int materialized = 0;
+        for (int i = 0; i < part.meta.size(); i++) {
+            const LineMeta& a = full.meta[i];
+            const LineMeta& b = part.meta[i];
+            QCOMPARE(b.nodeId, a.nodeId);
+            QCOMPARE(b.offsetAddr, a.offsetAddr);
+            QCOMPARE(b.foldLevel, a.foldLevel);
+            QCOMPARE(b.arrayElementIdx, a.arrayElementIdx);
+            if (b.materialized) {
+                materialized++;
+                QCOMPARE(partLines[i], fullLines[i]);
+                QCOMPARE(fmt::fmtOffsetMargin(b, part.layout.offsetHexDigits),
+                         fmt::fmtOffsetMargin(a, full.layout.offsetHexDigits));
+            } else {
+                QVERIFY(b.offsetStyle == OffsetStyle::None);
+                QCOMPARE(partLines[i].trimmed(), QString());
+            }
+        }
+        // Window lines plus the always-materialized command row/headers/footers
+        QVERIFY(materialized >= 51);
+        QVERIFY(materialized < 60);
+        QVERIFY(part.meta[2000].materialized);
+        QVERIFY(!part.meta[1999].materialized);
+
+        // Leaf fields outside the window are placeholders too
+        int tailLine = -1;
+        for (int i = 0; i < part.meta.size(); i++)
+            if (part.meta[i].nodeKind == NodeKind::Hex32 && !part.meta[i].isArrayElement)
+                tailLine = i;
+        QVERIFY(tailLine > 2050);
+        QVERIFY(!part.meta[tailLine].materialized);
+
+        // Empty window is the full document
+        ComposeResult all = compose(tree, prov, 0, false, ComposeWindow{});
+        QCOMPARE(all.text, full.text);
+    }
+
+    void testComposeCacheMatchesFullCompose() {
+        // Cached recompose must produce the same output as a fresh compose
+        // after each edit, and only recompose the dirty containers
+        NodeTree tree;
+        tree.baseAddress = 0x1000;
+
+        Node root;
+        root.kind = NodeKind::Struct;
+        root.name = "Root";
+        root.structTypeName = "Root";
+        int ri = tree.addNode(root);
+        uint64_t rootId = tree.nodes[ri].id;
+
+        Node target;
+        target.kind = NodeKind::Struct;
+        target.name = "Target";
+        target.structTypeName = "Target";
+        int ti = tree.addNode(target);
+        uint64_t targetId = tree.nodes[ti].id;
+
+        Node tf;
+        tf.kind = NodeKind::UInt32;
+        tf.name = "t0";
+        tf.parentId = targetId;
+        tree.addNode(tf);
+
+        uint64_t innerIds[3] = {};
+        for (int s = 0; s < 3; s++) {
+            Node inner;
+            inner.kind = NodeKind::Struct;
+            inner.name = QString("inner%1").arg(s);
+            inner.structTypeName = QString("Inner%1").arg(s);
+            inner.parentId = rootId;
+            inner.offset = s * 16;
+            int ii = tree.addNode(inner);
+            innerIds[s] = tree.nodes[ii].id;
+            for (int f = 0; f < 2; f++) {
+                Node n;
+                n.kind = NodeKind::Hex32;
+                n.name = QString("f%1").arg(f);
+                n.parentId = innerIds[s];
+                n.offset = f * 4;
+                tree.addNode(n);
+            }
+        }
+        // inner2 holds a pointer to Target: renaming Target must reach it
+        Node ptr;
+        ptr.kind = NodeKind::Pointer64;
+        ptr.name = "ptr";
+        ptr.parentId = innerIds[2];
+        ptr.offset = 8;
+        ptr.refId = targetId;
+        ptr.collapsed = true;
+        int pi = tree.addNode(ptr);
+        uint64_t ptrId = tree.nodes[pi].id;
+
+        NullProvider prov;
+        ComposeCache cache;
+
+        auto check = [&](const char* what) {
+            ComposeResult fresh = compose(tree, prov);
+            ComposeResult cached = compose(tree, prov, 0, false, {}, &cache);
+            QVERIFY2(cached.text == fresh.text, what);
+            QCOMPARE(cached.meta.size(), fresh.meta.size());
+            for (int i = 0; i < fresh.meta.size(); i++) {
+                QCOMPARE(cached.meta[i].nodeIdx, fresh.meta[i].nodeIdx);
+                QCOMPARE(cached.meta[i].nodeId, fresh.meta[i].nodeId);
+            }
+        };
+
+        check("initial");
+        QVERIFY(cache.fragments.contains(innerIds[0]));
+        QVERIFY(cache.fragments.contains(rootId));
+
+        // Rename a field in inner0: inner0 and root recompose, inner1 is replayed
+        int fi = tree.subtreeIndices(innerIds[0]).last();
+        tree.nodes[fi].name = "renamed";
+        cache.markDirty(tree.nodes[fi].id);
+        check("rename");
+        // Target, inner1 and inner2 replayed; root and inner0 recomposed
+        QCOMPARE(cache.replayed, 3);
+
+        // Collapse toggle
+        tree.nodes[tree.indexOfId(innerIds[1])].collapsed = true;
+        cache.markDirty(innerIds[1]);
+        check("collapse");
+
+        // Renaming the pointer target invalidates inner2 through its ref
+        tree.nodes[tree.indexOfId(targetId)].structTypeName = "Tgt";
+        cache.markDirty(targetId);
+        check("ref rename");
+        QVERIFY(cache.fragments.value(innerIds[2]).refs.contains(targetId));
+        QCOMPARE(cache.replayed, 2);  // inner0, inner1
+
+        // Removing a node shifts indices; replayed lines must be remapped
+        cache.markDirty(tree.nodes[tree.indexOfId(ptrId)].parentId);
+        cache.markDirty(ptrId);
+        tree.removeSubtree(ptrId);
+        check("remove");
+
+        // Partial window: placement-sensitive fragments only replay in place
+        ComposeWindow window;
+        window.add(0, 4);
+        ComposeResult freshWin = compose(tree, prov, 0, false, window);
+        ComposeResult cachedWin = compose(tree, prov, 0, false, window, &cache);
+        QCOMPARE(cachedWin.text, freshWin.text);
+        cachedWin = compose(tree, prov, 0, false, window, &cache);
+        QCOMPARE(cachedWin.text, freshWin.text);
+        check("window back to full");
+    }
+
+    void testCachedColumnWidthsFollowEdits() {
+        // Widths kept in the cache must track renames, kind changes and
+        // pointer target renames in other scopes, and survive clearFragments()
+        NodeTree tree;
+
+        Node target;
+        target.kind = NodeKind::Struct;
+        target.name = "T";
+        target.structTypeName = "T";
+        uint64_t targetId = tree.nodes[tree.addNode(target)].id;
+
+        Node root;
+        root.kind = NodeKind::Struct;
+        root.name = "Root";
+        root.structTypeName = "Root";
+        uint64_t rootId = tree.nodes[tree.addNode(root)].id;
+
+        Node field;
+        field.kind = NodeKind::UInt32;
+        field.name = "a";
+        field.parentId = rootId;
+        uint64_t fieldId = tree.nodes[tree.addNode(field)].id;
+
+        Node ptr;
+        ptr.kind = NodeKind::Pointer64;
+        ptr.name = "p";
+        ptr.parentId = rootId;
+        ptr.offset = 8;
+        ptr.refId = targetId;
+        ptr.collapsed = true;
+        tree.addNode(ptr);
+
+        NullProvider prov;
+        ComposeCache cache;
+
+        auto check = [&](const char* what) {
+            ComposeResult fresh = compose(tree, prov);
+            ComposeResult cached = compose(tree, prov, 0, false, {}, &cache);
+            QVERIFY2(cached.text == fresh.text, what);
+            QCOMPARE(cached.layout.typeW, fresh.layout.typeW);
+            QCOMPARE(cached.layout.nameW, fresh.layout.nameW);
+            for (int i = 0; i < fresh.meta.size(); i++) {
+                QCOMPARE(cached.meta[i].effectiveTypeW, fresh.meta[i].effectiveTypeW);
+                QCOMPARE(cached.meta[i].effectiveNameW, fresh.meta[i].effectiveNameW);
+            }
+        };
+
+        check("initial");
+        QVERIFY(cache.widths.valid);
+        QVERIFY(cache.widths.scopes.contains(rootId));
+
+        // Longer field name widens Root's name column
+        tree.nodes[tree.indexOfId(fieldId)].name = "a_much_longer_field_name";
+        cache.markDirty(fieldId);
+        check("rename");
+
+        // Renaming the pointer target widens Root's type column ("LongTarget*")
+        tree.nodes[tree.indexOfId(targetId)].structTypeName = "AVeryLongTargetTypeName";
+        cache.markDirty(targetId);
+        check("target rename");
+
+        // Kind change
+        tree.nodes[tree.indexOfId(fieldId)].kind = NodeKind::Hex32;
+        cache.markDirty(fieldId);
+        check("kind change");
+
+        // A data-only clear keeps the measured widths
+        cache.clearFragments();
+        QVERIFY(cache.widths.valid);
+        check("after clearFragments");
+
+        cache.clear();
+        QVERIFY(!cache.widths.valid);
+        check("after clear");
+    }
+
+    void testTypeAliasesAreComposeInputs() {
+        // Aliases reach leaf lines, primitive array elements and the column
+        // widths through ComposeOptions, with no process-wide state
+        NodeTree tree;
+        Node root;
+        root.kind = NodeKind::Struct;
+        root.name = "Root";
+        uint64_t rootId = tree.nodes[tree.addNode(root)].id;
+
+        Node f;
+        f.kind = NodeKind::Int32;
+        f.name = "count";
+        f.parentId = rootId;
+        tree.addNode(f);
+
+        Node arr;
+        arr.kind = NodeKind::Array;
+        arr.name = "vals";
+        arr.parentId = rootId;
+        arr.offset = 4;
+        arr.elementKind = NodeKind::Int32;
+        arr.arrayLen = 2;
+        tree.addNode(arr);
+
+        QHash<NodeKind, QString> aliases;
+        aliases[NodeKind::Int32] = "SOME_LONG_LONG_ALIAS";
+        ComposeOptions opts;
+        opts.typeAliases = &aliases;
+
+        NullProvider prov;
+        ComposeResult plain = compose(tree, prov);
+        ComposeResult aliased = compose(tree, prov, 0, false, {}, nullptr, opts);
+        QVERIFY(!plain.text.contains("SOME_LONG_LONG_ALIAS"));
+        QVERIFY(aliased.text.contains("SOME_LONG_LONG_ALIAS count"));
+        QVERIFY(aliased.text.contains("SOME_LONG_LONG_ALIAS[1]"));
+        QVERIFY(aliased.layout.typeW > plain.layout.typeW);
+
+        // The value pass keeps the alias
+        BufferProvider buf(QByteArray(16, '\x01'));
+        ComposeResult r = compose(tree, buf, 0, false, {}, nullptr, opts);
+        QVERIFY(recomposeValues(r, tree, buf, opts));
+        QCOMPARE(r.text, compose(tree, buf, 0, false, {}, nullptr, opts).text);
+    }
+
+    void testParallelRootsMatchSequential() {
+        // Root structs composed on the thread pool must stitch back into
+        // exactly the sequential output, with and without the cache
+        NodeTree tree;
+        tree.baseAddress = 0x10000;
+        QVector<uint64_t> rootIds;
+        for (int r = 0; r < 24; r++) {
+            Node root;
+            root.kind = NodeKind::Struct;
+            root.name = QString("Root%1").arg(r);
+            root.structTypeName = QString("Root%1").arg(r);
+            root.offset = r * 0x400;
+            uint64_t rid = tree.nodes[tree.addNode(root)].id;
+            rootIds.append(rid);
+            for (int i = 0; i < 200; i++) {
+                Node n;
+                n.kind = (i % 3 == 0) ? NodeKind::Hex32 : NodeKind::UInt32;
+                n.name = QString("f%1").arg(i);
+                n.parentId = rid;
+                n.offset = i * 4;
+                tree.addNode(n);
+            }
+        }
+        // An expanded pointer across roots
+        Node ptr;
+        ptr.kind = NodeKind::Pointer64;
+        ptr.name = "next";
+        ptr.parentId = rootIds[3];
+        ptr.offset = 0x3F8;
+        ptr.refId = rootIds[5];
+        ptr.collapsed = false;
+        tree.addNode(ptr);
+
+        QByteArray data(24 * 0x400, '\0');
+        for (int i = 0; i < data.size(); i++) data[i] = char(i * 7);
+        BufferProvider prov(data);
+
+        ComposeOptions par;
+        par.parallel = true;
+        ComposeResult seq = compose(tree, prov);
+        ComposeResult pr = compose(tree, prov, 0, false, {}, nullptr, par);
+        QCOMPARE(pr.text, seq.text);
+        QCOMPARE(pr.meta.size(), seq.meta.size());
+        for (int i = 0; i < seq.meta.size(); i++) {
+            QCOMPARE(pr.meta[i].nodeId, seq.meta[i].nodeId);
+            QCOMPARE(pr.meta[i].isRootHeader, seq.meta[i].isRootHeader);
+        }
+
+        ComposeCache cache;
+        QCOMPARE(compose(tree, prov, 0, false, {}, &cache, par).text, seq.text);
+        QCOMPARE(cache.fragments.size(), 24);
+        int fi = tree.subtreeIndices(rootIds[10]).last();
+        tree.nodes[fi].name = "renamed";
+        cache.markDirty(tree.nodes[fi].id);
+        ComposeResult again = compose(tree, prov, 0, false, {}, &cache, par);
+        QCOMPARE(again.text, compose(tree, prov).text);
+        QCOMPARE(cache.replayed, 23);
+    }
+
+    void testValuePassMatchesFullCompose() {
+        // recomposeValues keeps the layout and re-reads only value text; it
+        // must match a fresh compose and refuse when a pointer target moves
+        NodeTree tree;
+        tree.baseAddress = 0;
+
+        Node root;
+        root.kind = NodeKind::Struct;
+        root.name = "Root";
+        root.structTypeName = "Root";
+        int ri = tree.addNode(root);
+        uint64_t rootId = tree.nodes[ri].id;
+
+        Node target;
+        target.kind = NodeKind::Struct;
+        target.name = "Target";
+        target.structTypeName = "Target";
+        target.offset = 0x100;
+        int ti = tree.addNode(target);
+        uint64_t targetId = tree.nodes[ti].id;
+
+        Node tf;
+        tf.kind = NodeKind::UInt32;
+        tf.name = "t0";
+        tf.parentId = targetId;
+        tree.addNode(tf);
+
+        Node a;
+        a.kind = NodeKind::UInt32;
+        a.name = "a";
+        a.parentId = rootId;
+        a.offset = 0;
+        tree.addNode(a);
+
+        Node h;
+        h.kind = NodeKind::Hex64;
+        h.name = "h";
+        h.parentId = rootId;
+        h.offset = 8;
+        tree.addNode(h);
+
+        Node arr;
+        arr.kind = NodeKind::Array;
+        arr.name = "arr";
+        arr.parentId = rootId;
+        arr.offset = 16;
+        arr.elementKind = NodeKind::UInt16;
+        arr.arrayLen = 4;
+        tree.addNode(arr);
+
+        Node ptr;
+        ptr.kind = NodeKind::Pointer64;
+        ptr.name = "ptr";
+        ptr.parentId = rootId;
+        ptr.offset = 32;
+        ptr.refId = targetId;
+        tree.addNode(ptr);
+
+        Node raw;
+        raw.kind = NodeKind::Pointer64;
+        raw.name = "raw";
+        raw.parentId = rootId;
+        raw.offset = 40;
+        tree.addNode(raw);
+
+        QByteArray data(0x80, '\0');
+        auto put64 = [&](int off, uint64_t v) { memcpy(data.data() + off, &v, 8); };
+        put64(32, 0x40);
+        put64(40, 0x1234);
+
+        ComposeResult layout = compose(tree, BufferProvider(data));
+        QVERIFY(layout.meta.size() > 8);
+
+        // Bytes change everywhere except the expanded pointer
+        data[0] = 7;
+        data[9] = 'A';
+        data[18] = 3;
+        data[0x40] = 42;
+        put64(40, 0x5678);
+        BufferProvider changed(data);
+        ComposeResult fresh = compose(tree, changed);
+        QVERIFY(layout.text != fresh.text);
+        QVERIFY(recomposeValues(layout, tree, changed));
+        QCOMPARE(layout.text, fresh.text);
+
+        // Moving the expanded pointer invalidates the layout
+        put64(32, 0x50);
+        QString before = layout.text;
+        QVERIFY(!recomposeValues(layout, tree, BufferProvider(data)));
+        QCOMPARE(layout.text, before);
+
+        // So does a tree edit that shifts node indices
+        ComposeResult stale = compose(tree, changed);
+        tree.removeSubtree(tree.nodes[tree.indexOfId(targetId)].id);
+        QVERIFY(!recomposeValues(stale, tree, changed));
+    }
+
     void testArrayCountRecompose() {
         // After changing arrayLen and recomposing, the text shows the new count
         NodeTree tree;
@@ -1215,7 +1681,8 @@ private slots:
                  qPrintable("Pointer with no refId should show 'void*': " + text));
 
         // pointerTargetName should be empty (void)
-        QVERIFY(result.meta[ptrLine].pointerTargetName.isEmpty());
+        QCOMPARE(result.meta[ptrLine].ptrTargetId, (uint64_t)0);
+        QVERIFY(pointerTargetName(tree, result.meta[ptrLine]).isEmpty());
 
         // Should NOT be a fold head (no deref expansion for void*)
         QVERIFY(!result.meta[ptrLine].foldHead);
@@ -1309,7 +1776,7 @@ private slots:
                  qPrintable("Should show 'PlayerData*': " + lines[ptrLine]));
 
         // pointerTargetName metadata
-        QCOMPARE(result.meta[ptrLine].pointerTargetName, QString("PlayerData"));
+        QCOMPARE(pointerTargetName(tree, result.meta[ptrLine]), QString("PlayerData"));
 
         // Pointer with refId is a fold head (even if collapsed)
         QVERIFY(result.meta[ptrLine].foldHead);
@@ -2060,8 +2527,8 @@ private slots:
                 memberLines.append(i);
         }
         QCOMPARE(memberLines.size(), 2);
-        QCOMPARE(result.meta[memberLines[0]].offsetText,
-                 result.meta[memberLines[1]].offsetText);
+        QCOMPARE(fmt::fmtOffsetMargin(result.meta[memberLines[0]], result.layout.offsetHexDigits),
+                 fmt::fmtOffsetMargin(result.meta[memberLines[1]], result.layout.offsetHexDigits));
     }
 
     void testUnionCollapsed() {
@@ -3,6 +3,8 @@
 #include <QApplication>
 #include <QSplitter>
 #include <Qsci/qsciscintilla.h>
+#include <QRegularExpression>
+#include <atomic>
 #include "controller.h"
 #include "core.h"
 
@@ -27,6 +29,24 @@ public:
     QString kind() const override { return QStringLiteral("Process"); }
 };
 
+// Live provider whose bytes change on every read, so each refresh tick
+// produces a new snapshot and a recompose
+class TickingProvider : public Provider {
+    int m_size;
+    mutable std::atomic<int> m_reads{0};
+public:
+    explicit TickingProvider(int size) : m_size(size) {}
+    bool read(uint64_t addr, void* buf, int len) const override {
+        if (addr + len > (uint64_t)m_size) return false;
+        std::memset(buf, m_reads++ & 0xFF, len);
+        return true;
+    }
+    int size() const override { return m_size; }
+    bool isLive() const override { return true; }
+    QString name() const override { return QStringLiteral("ticking"); }
+    QString kind() const override { return QStringLiteral("Process"); }
+};
+
 // Small tree: one root struct with a few typed fields at known offsets.
 // Keeps tests fast and deterministic (no giant PEB tree).
 static void buildSmallTree(NodeTree& tree) {
@@ -474,11 +494,10 @@ private slots:
         QVERIFY(idx >= 0);
         uint64_t nodeId = tree.nodes[idx].id;
 
-        QHash<uint64_t, ValueHistory> history;
-        history[nodeId].record("100");
-        history[nodeId].record("200");
-        history[nodeId].record("300");
-        QVERIFY(history[nodeId].uniqueCount() > 1);
+        ValueHistory history;
+        for (uint32_t v : {100u, 200u, 300u})
+            history.record(nodeId, &v, sizeof(v), 0);
+        QVERIFY(history.sampleCount(nodeId) > 1);
 
         m_editor->setValueHistoryRef(&history);
 
@@ -562,19 +581,18 @@ private slots:
         QVERIFY2(!shiftedIds.isEmpty(), "Should have siblings after field_u32");
 
         // Seed value history for shifted siblings (simulate accumulated heat)
-        auto& history = const_cast<QHash<uint64_t, ValueHistory>&>(m_ctrl->valueHistory());
+        auto& history = const_cast<ValueHistory&>(m_ctrl->valueHistory());
         for (uint64_t id : shiftedIds) {
-            history[id].record("old_val_1");
-            history[id].record("old_val_2");
-            history[id].record("old_val_3");
-            QVERIFY2(history[id].heatLevel() >= 2,
+            for (uint32_t v : {1u, 2u, 3u})
+                history.record(id, &v, sizeof(v), 0);
+            QVERIFY2(history.heatLevel(id) >= 2,
                      qPrintable(QString("Pre-delete: %1 should have heat>=2")
                                 .arg(nameMap[id])));
         }
 
         // Also seed the to-be-deleted node
-        history[delId].record("del_1");
-        history[delId].record("del_2");
+        for (uint32_t v : {1u, 2u})
+            history.record(delId, &v, sizeof(v), 0);
         QVERIFY(history.contains(delId));
 
         // Delete field_u32 — this shifts all subsequent siblings
@@ -589,8 +607,7 @@ private slots:
         // With a live provider, refresh() inside removeNode re-records one new
         // value at the new offset → count=1 → heatLevel=0.
         for (uint64_t id : shiftedIds) {
-            int heat = m_ctrl->valueHistory().contains(id)
-                ? m_ctrl->valueHistory()[id].heatLevel() : 0;
+            int heat = m_ctrl->valueHistory().heatLevel(id);
             QVERIFY2(heat == 0,
                      qPrintable(QString("Shifted node '%1' (id=%2) should have heat=0, got %3")
                                 .arg(nameMap[id]).arg(id).arg(heat)));
@@ -600,43 +617,48 @@ private slots:
     // ── Test: value history records and cycles correctly ──
     void testValueHistoryRingBuffer() {
         ValueHistory vh;
-        QCOMPARE(vh.count, 0);
-        QCOMPARE(vh.heatLevel(), 0);
+        const uint64_t id = 1;
+        auto rec = [&](uint32_t v) { vh.record(id, &v, sizeof(v), v); };
+        QCOMPARE(vh.count(id), 0);
+        QCOMPARE(vh.heatLevel(id), 0);
 
-        vh.record("10");
-        QCOMPARE(vh.count, 1);
-        QCOMPARE(vh.heatLevel(), 0);  // 1 unique = static
+        rec(10);
+        QCOMPARE(vh.count(id), 1);
+        QCOMPARE(vh.heatLevel(id), 0);  // 1 value = static
 
         // Duplicate should not increase count
-        vh.record("10");
-        QCOMPARE(vh.count, 1);
-
-        vh.record("20");
-        QCOMPARE(vh.count, 2);
-        QCOMPARE(vh.heatLevel(), 1);  // cold
+        rec(10);
+        QCOMPARE(vh.count(id), 1);
 
-        vh.record("30");
-        QCOMPARE(vh.count, 3);
-        QCOMPARE(vh.heatLevel(), 2);  // warm
+        rec(20);
+        QCOMPARE(vh.count(id), 2);
+        QCOMPARE(vh.heatLevel(id), 1);  // cold
 
-        vh.record("40");
-        vh.record("50");
-        QCOMPARE(vh.count, 5);
-        QCOMPARE(vh.heatLevel(), 3);  // hot
+        rec(30);
+        QCOMPARE(vh.count(id), 3);
+        QCOMPARE(vh.heatLevel(id), 2);  // warm
 
-        QCOMPARE(vh.last(), QString("50"));
+        rec(40);
+        rec(50);
+        QCOMPARE(vh.count(id), 5);
+        QCOMPARE(vh.heatLevel(id), 3);  // hot
 
-        // Ring buffer: uniqueCount() caps at kCapacity
-        for (int i = 0; i < 20; i++)
-            vh.record(QString::number(100 + i));
-        QCOMPARE(vh.uniqueCount(), ValueHistory::kCapacity);
-        QVERIFY(vh.count > ValueHistory::kCapacity);
+        // Ring buffer: sampleCount() caps at kCapacity
+        for (int i = 0; i < ValueHistory::kCapacity + 20; i++)
+            rec(uint32_t(100 + i));
+        QCOMPARE(vh.sampleCount(id), ValueHistory::kCapacity);
+        QVERIFY(vh.count(id) > ValueHistory::kCapacity);
 
         // forEach iterates oldest→newest within ring
-        QStringList vals;
-        vh.forEach([&](const QString& v) { vals.append(v); });
+        QVector<uint32_t> vals;
+        vh.forEach(id, [&](const char* b, int, int64_t t) {
+            uint32_t v;
+            std::memcpy(&v, b, 4);
+            QCOMPARE(int64_t(v), t);
+            vals.append(v);
+        });
         QCOMPARE(vals.size(), ValueHistory::kCapacity);
-        QCOMPARE(vals.last(), vh.last());
+        QCOMPARE(vals.last(), uint32_t(100 + ValueHistory::kCapacity + 19));
     }
     // ── Test: inline edit "int32_t[4]" on primitive converts to array ──
     void testInlineEditPrimitiveArray() {
@@ -668,6 +690,37 @@ private slots:
         QVERIFY(newIdx >= 0);
         QCOMPARE(m_doc->tree.nodes[newIdx].kind, NodeKind::UInt32);
     }
+
+    // ── Test: an edit made while a worker compose is in flight wins ──
+    void testAsyncComposeDropsStaleResult() {
+        // Large enough for data ticks to compose off the GUI thread
+        auto& tree = m_doc->tree;
+        uint64_t rootId = tree.nodes[0].id;
+        const int kFields = 4096;
+        for (int i = 0; i < kFields; i++) {
+            Node n;
+            n.kind = NodeKind::Hex64;
+            n.name = QStringLiteral("f%1").arg(i);
+            n.parentId = rootId;
+            n.offset = 16 + i * 8;
+            tree.addNode(n);
+        }
+        m_doc->provider = std::make_shared<TickingProvider>(16 + kFields * 8);
+        m_ctrl->refresh();
+        QTest::qWait(1500);  // a few ticks: snapshots and worker composes
+
+        int idx = -1;
+        for (int i = 0; i < tree.nodes.size(); i++)
+            if (tree.nodes[i].name == "f100") { idx = i; break; }
+        QVERIFY(idx >= 0);
+        m_ctrl->renameNode(idx, QStringLiteral("renamed_field"));
+        QVERIFY(m_editor->scintilla()->text().contains("renamed_field"));
+
+        // Results composed against the pre-rename tree must not land
+        QTest::qWait(1500);
+        QVERIFY(m_editor->scintilla()->text().contains("renamed_field"));
+        QVERIFY(!m_editor->scintilla()->text().contains(QRegularExpression("\\bf100\\b")));
+    }
 };
 
 QTEST_MAIN(TestController)
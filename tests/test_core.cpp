@@ -294,6 +294,74 @@ private slots:
         QCOMPARE(off, (int64_t)0x7FFFFFFF);
     }
 
+    void testNodeTree_cachesTrackMutations() {
+        using namespace rcx;
+        NodeTree tree;
+        Node root; root.kind = NodeKind::Struct; root.name = "R"; root.offset = 0x10;
+        int ri = tree.addNode(root);
+        uint64_t rootId = tree.nodes[ri].id;
+        Node inner; inner.kind = NodeKind::Struct; inner.name = "I";
+        inner.parentId = rootId; inner.offset = 0x20;
+        int ii = tree.addNode(inner);
+        uint64_t innerId = tree.nodes[ii].id;
+        Node leaf; leaf.kind = NodeKind::UInt32; leaf.name = "f";
+        leaf.parentId = innerId; leaf.offset = 4;
+        int li = tree.addNode(leaf);
+
+        // Warm every cache
+        QCOMPARE(tree.computeOffset(li), (int64_t)0x34);
+        QCOMPARE(tree.depthOf(li), 2);
+        QCOMPARE(tree.childrenOf(innerId).size(), 1);
+
+        // Offset change propagates to descendants only
+        tree.setNodeOffset(ii, 0x40);
+        QCOMPARE(tree.computeOffset(li), (int64_t)0x54);
+        QCOMPARE(tree.computeOffset(ri), (int64_t)0x10);
+
+        // Added node shows up in child index and offset cache
+        Node leaf2; leaf2.kind = NodeKind::UInt32; leaf2.name = "g";
+        leaf2.parentId = innerId; leaf2.offset = 8;
+        int l2 = tree.addNode(leaf2);
+        QCOMPARE(tree.childrenOf(innerId), (QVector<int>{li, l2}));
+        QCOMPARE(tree.computeOffset(l2), (int64_t)0x58);
+        QCOMPARE(tree.depthOf(l2), 2);
+
+        // Subtree removal remaps surviving indices
+        Node sib; sib.kind = NodeKind::Hex64; sib.name = "s";
+        sib.parentId = rootId; sib.offset = 0;
+        uint64_t sibId = tree.nodes[tree.addNode(sib)].id;
+        tree.removeSubtree(innerId);
+        QCOMPARE(tree.nodes.size(), 2);
+        int si = tree.indexOfId(sibId);
+        QCOMPARE(si, 1);
+        QCOMPARE(tree.indexOfId(innerId), -1);
+        QCOMPARE(tree.childrenOf(rootId), (QVector<int>{si}));
+        QCOMPARE(tree.computeOffset(si), (int64_t)0x10);
+        QVERIFY(tree.childrenOf(innerId).isEmpty());
+    }
+
+    void testNodeTree_removeParentOrphansChildren() {
+        using namespace rcx;
+        NodeTree tree;
+        Node a; a.kind = NodeKind::Struct; a.name = "A"; a.offset = 0x100;
+        uint64_t aId = tree.nodes[tree.addNode(a)].id;
+        Node b; b.kind = NodeKind::UInt8; b.name = "b"; b.parentId = aId; b.offset = 2;
+        uint64_t bId = tree.nodes[tree.addNode(b)].id;
+        QCOMPARE(tree.computeOffset(tree.indexOfId(bId)), (int64_t)0x102);
+
+        tree.removeIndices({tree.indexOfId(aId)});
+        int bi = tree.indexOfId(bId);
+        QCOMPARE(bi, 0);
+        QCOMPARE(tree.computeOffset(bi), (int64_t)2);
+        QCOMPARE(tree.depthOf(bi), 0);
+
+        // Re-adding the parent re-attaches the orphan
+        a.id = aId;
+        tree.addNode(a);
+        QCOMPARE(tree.computeOffset(tree.indexOfId(bId)), (int64_t)0x102);
+        QCOMPARE(tree.depthOf(tree.indexOfId(bId)), 1);
+    }
+
     void testKindMetaCompleteness() {
         // Every NodeKind enum value must have a KindMeta entry
         for (int i = 0; i <= static_cast<int>(rcx::NodeKind::Array); i++) {
@@ -507,6 +575,46 @@ private slots:
         // Container span = array offset (8) + array size (80) = 88
         QCOMPARE(tree5.structSpan(containerId), 88);
     }
+    void testStructSpan_memoized() {
+        using namespace rcx;
+        // Two embedded references to one definition, and a self-reference
+        NodeTree tree;
+        Node def;
+        def.kind = NodeKind::Struct;
+        def.name = "Vec";
+        uint64_t defId = tree.nodes[tree.addNode(def)].id;
+        Node x;
+        x.kind = NodeKind::Double;
+        x.parentId = defId;
+        x.offset = 8;
+        tree.addNode(x);
+
+        Node owner;
+        owner.kind = NodeKind::Struct;
+        owner.name = "Owner";
+        uint64_t ownerId = tree.nodes[tree.addNode(owner)].id;
+        for (int off : {0, 16}) {
+            Node e;
+            e.kind = NodeKind::Struct;
+            e.parentId = ownerId;
+            e.offset = off;
+            e.refId = defId;
+            tree.addNode(e);
+        }
+        Node loop;
+        loop.kind = NodeKind::Struct;
+        loop.name = "Loop";
+        int li = tree.addNode(loop);
+        tree.nodes[li].refId = tree.nodes[li].id;
+
+        QHash<uint64_t, int> memo;
+        const auto& childMap = tree.childIndex();
+        QCOMPARE(tree.structSpan(ownerId, childMap, memo), 32);
+        QCOMPARE(memo.value(defId), 16);
+        QCOMPARE(tree.structSpan(defId, childMap, memo), tree.structSpan(defId));
+        QCOMPARE(tree.structSpan(tree.nodes[li].id, childMap, memo), 0);
+        QCOMPARE(tree.dataExtent(), int64_t(32));
+    }
     void testNormalizePreferAncestors() {
         using namespace rcx;
         NodeTree tree;
@@ -586,90 +694,135 @@ private slots:
 
     // ── ValueHistory tests ──
 
+    static bool recordU32(rcx::ValueHistory& h, uint64_t id, uint32_t v, int64_t t = 0) {
+        return h.record(id, &v, sizeof(v), t);
+    }
+
     void testValueHistory_empty() {
         rcx::ValueHistory h;
-        QCOMPARE(h.heatLevel(), 0);
-        QCOMPARE(h.uniqueCount(), 0);
-        QCOMPARE(h.last(), QString());
+        QVERIFY(h.isEmpty());
+        QCOMPARE(h.heatLevel(1), 0);
+        QCOMPARE(h.sampleCount(1), 0);
+        int calls = 0;
+        h.forEach(1, [&](const char*, int, int64_t) { calls++; });
+        QCOMPARE(calls, 0);
     }
 
     void testValueHistory_singleValue() {
         rcx::ValueHistory h;
-        h.record("42");
-        QCOMPARE(h.heatLevel(), 0);  // only 1 unique → static
-        QCOMPARE(h.uniqueCount(), 1);
-        QCOMPARE(h.last(), QString("42"));
+        QVERIFY(recordU32(h, 1, 42));
+        QCOMPARE(h.heatLevel(1), 0);  // only 1 value → static
+        QCOMPARE(h.sampleCount(1), 1);
+        QVERIFY(h.contains(1));
+        QVERIFY(!h.contains(2));
     }
 
     void testValueHistory_duplicateIgnored() {
         rcx::ValueHistory h;
-        h.record("42");
-        h.record("42");
-        h.record("42");
-        QCOMPARE(h.count, 1);
-        QCOMPARE(h.heatLevel(), 0);
+        QVERIFY(recordU32(h, 1, 42));
+        QVERIFY(!recordU32(h, 1, 42));
+        QVERIFY(!recordU32(h, 1, 42));
+        QCOMPARE(h.count(1), 1);
+        QCOMPARE(h.heatLevel(1), 0);
     }
 
     void testValueHistory_heatLevels() {
         rcx::ValueHistory h;
-        h.record("a");
-        QCOMPARE(h.heatLevel(), 0);  // 1 unique
+        recordU32(h, 1, 'a');
+        QCOMPARE(h.heatLevel(1), 0);  // 1 value
 
-        h.record("b");
-        QCOMPARE(h.heatLevel(), 1);  // 2 unique → cold
+        recordU32(h, 1, 'b');
+        QCOMPARE(h.heatLevel(1), 1);  // 2 values → cold
 
-        h.record("c");
-        QCOMPARE(h.heatLevel(), 2);  // 3 unique → warm
+        recordU32(h, 1, 'c');
+        QCOMPARE(h.heatLevel(1), 2);  // 3 values → warm
 
-        h.record("d");
-        QCOMPARE(h.heatLevel(), 2);  // 4 unique → warm
+        recordU32(h, 1, 'd');
+        QCOMPARE(h.heatLevel(1), 2);  // 4 values → warm
 
-        h.record("e");
-        QCOMPARE(h.heatLevel(), 3);  // 5 unique → hot
+        recordU32(h, 1, 'e');
+        QCOMPARE(h.heatLevel(1), 3);  // 5 values → hot
     }
 
     void testValueHistory_ringWrap() {
         rcx::ValueHistory h;
+        const int cap = rcx::ValueHistory::kCapacity;
         // Fill beyond capacity
-        for (int i = 0; i < 15; i++)
-            h.record(QString::number(i));
-
-        QCOMPARE(h.count, 15);
-        QCOMPARE(h.uniqueCount(), 10);  // capped at kCapacity
-        QCOMPARE(h.heatLevel(), 3);     // hot
-        QCOMPARE(h.last(), QString("14"));
-
-        // Verify oldest values were pushed out, newest 10 remain
-        QStringList collected;
-        h.forEach([&](const QString& v) { collected.append(v); });
-        QCOMPARE(collected.size(), 10);
-        QCOMPARE(collected.first(), QString("5"));   // oldest surviving
-        QCOMPARE(collected.last(), QString("14"));    // newest
+        for (int i = 0; i < cap + 5; i++)
+            recordU32(h, 1, uint32_t(i), i * 10);
+
+        QCOMPARE(h.count(1), cap + 5);
+        QCOMPARE(h.sampleCount(1), cap);   // capped at kCapacity
+        QCOMPARE(h.heatLevel(1), 3);       // hot
+
+        // Oldest values were pushed out, the newest kCapacity remain in order
+        QVector<uint32_t> values;
+        QVector<int64_t> times;
+        h.forEach(1, [&](const char* bytes, int size, int64_t t) {
+            QCOMPARE(size, 4);
+            uint32_t v;
+            std::memcpy(&v, bytes, 4);
+            values.append(v);
+            times.append(t);
+        });
+        QCOMPARE(values.size(), cap);
+        QCOMPARE(values.first(), uint32_t(5));         // oldest surviving
+        QCOMPARE(values.last(), uint32_t(cap + 4));    // newest
+        QCOMPARE(times.first(), int64_t(50));
+        for (int i = 1; i < values.size(); i++)
+            QCOMPARE(values[i], values[i - 1] + 1);
     }
 
     void testValueHistory_forEach() {
         rcx::ValueHistory h;
-        h.record("x");
-        h.record("y");
-        h.record("z");
+        h.record(7, "x", 1, 100);
+        h.record(7, "y", 1, 200);
+        h.record(7, "z", 1, 300);
 
-        QStringList items;
-        h.forEach([&](const QString& v) { items.append(v); });
-        QCOMPARE(items.size(), 3);
-        QCOMPARE(items[0], QString("x"));
-        QCOMPARE(items[1], QString("y"));
-        QCOMPARE(items[2], QString("z"));
+        QString items;
+        QVector<int64_t> times;
+        h.forEach(7, [&](const char* b, int n, int64_t t) {
+            items += QString::fromLatin1(b, n);
+            times.append(t);
+        });
+        QCOMPARE(items, QString("xyz"));
+        QCOMPARE(times, (QVector<int64_t>{100, 200, 300}));
     }
 
     void testValueHistory_oscillation() {
-        // Values that oscillate (A → B → A → B) should still count each unique transition
+        // Values that oscillate (A → B → A → B) should still count each transition
+        rcx::ValueHistory h;
+        recordU32(h, 1, 'A');
+        recordU32(h, 1, 'B');
+        recordU32(h, 1, 'A');
+        recordU32(h, 1, 'B');
+        QCOMPARE(h.count(1), 4);       // 4 transitions
+        QCOMPARE(h.heatLevel(1), 2);   // warm (count=4 → 3-4 range)
+    }
+
+    void testValueHistory_widthChangeStartsOver() {
+        // The node changed type: old samples no longer line up
+        rcx::ValueHistory h;
+        recordU32(h, 1, 1);
+        recordU32(h, 1, 2);
+        uint64_t wide = 2;
+        QVERIFY(h.record(1, &wide, sizeof(wide), 0));
+        QCOMPARE(h.count(1), 1);
+        QCOMPARE(h.heatLevel(1), 0);
+    }
+
+    void testValueHistory_nodesIndependent() {
         rcx::ValueHistory h;
-        h.record("A");
-        h.record("B");
-        h.record("A");
-        h.record("B");
-        QCOMPARE(h.count, 4);       // 4 transitions
-        QCOMPARE(h.heatLevel(), 2); // warm (count=4 → 3-4 range)
+        recordU32(h, 1, 1);
+        recordU32(h, 1, 2);
+        recordU32(h, 2, 1);
+        QCOMPARE(h.heatLevel(1), 1);
+        QCOMPARE(h.heatLevel(2), 0);
+        h.remove(1);
+        QVERIFY(!h.contains(1));
+        QCOMPARE(h.size(), 1);
+        h.clear();
+        QVERIFY(h.isEmpty());
     }
 };
 
@@ -0,0 +1,159 @@
+#include <QTest>
+#include <QBuffer>
+#include <cstring>
+#include <thread>
+#include "fieldsampler.h"
+#include "providers/buffer_provider.h"
+
+using namespace rcx;
+
+class TestFieldSampler : public QObject {
+    Q_OBJECT
+
+private:
+    static SampledField field(const char* name, NodeKind kind, uint64_t addr, int size) {
+        SampledField f;
+        f.name = QString::fromLatin1(name);
+        f.kind = kind;
+        f.addr = addr;
+        f.size = size;
+        return f;
+    }
+
+    template<typename T>
+    static void put(BufferProvider& p, uint64_t addr, T v) {
+        p.write(addr, &v, int(sizeof(v)));
+    }
+
+private slots:
+    void testRingDrainsInOrderAndDropsWhenFull() {
+        SampleRing ring(2, 3);                  // rounds up to 4
+        QCOMPARE(ring.capacity(), 4);
+        for (int i = 0; i < 6; ++i) {
+            uint64_t v[2] = {uint64_t(i), uint64_t(i * 10)};
+            ring.push(i, v);
+        }
+        QCOMPARE(ring.dropped(), uint64_t(2));
+
+        QVector<int64_t> times;
+        int n = ring.drain([&](int64_t t, const uint64_t* v) {
+            QCOMPARE(v[1], uint64_t(t * 10));
+            times.append(t);
+        });
+        QCOMPARE(n, 4);
+        QCOMPARE(times, (QVector<int64_t>{0, 1, 2, 3}));
+        // Room again after a drain
+        uint64_t v[2] = {7, 70};
+        QVERIFY(ring.push(7, v));
+        QCOMPARE(ring.drain([](int64_t, const uint64_t*) {}), 1);
+    }
+
+    void testNeighbouringFieldsShareARead() {
+        auto prov = std::make_shared<BufferProvider>(QByteArray(0x1000, '\0'));
+        FieldSampler near(prov, {field("a", NodeKind::Int32, 0x100, 4),
+                                 field("b", NodeKind::Int32, 0x108, 4),
+                                 field("c", NodeKind::Int32, 0x104, 4)}, 100);
+        QCOMPARE(near.spanCount(), 1);
+        FieldSampler far(prov, {field("a", NodeKind::Int32, 0x100, 4),
+                                field("b", NodeKind::Int32, 0x800, 4)}, 100);
+        QCOMPARE(far.spanCount(), 2);
+    }
+
+    void testSampleOnceReadsCurrentValues() {
+        auto prov = std::make_shared<BufferProvider>(QByteArray(0x1000, '\0'));
+        // Listed out of address order, overlapping, and far apart
+        FieldSampler s(prov, {field("d", NodeKind::Double, 0x800, 8),
+                              field("i", NodeKind::Int16, 0x102, 2),
+                              field("u", NodeKind::UInt32, 0x100, 4)}, 100);
+        put(*prov, 0x800, 2.5);
+        put(*prov, 0x100, uint32_t(0xFFFE1234));
+        s.sampleOnce(1);
+        put(*prov, 0x800, -1.0);
+        s.sampleOnce(2);
+
+        SampleLog log(3);
+        s.ring().drain([&](int64_t t, const uint64_t* v) { log.append(t, v); });
+        QCOMPARE(log.size(), 2);
+        QCOMPARE(sampleValue(NodeKind::Double, 8, log.column(0)[0]), 2.5);
+        QCOMPARE(sampleValue(NodeKind::Double, 8, log.column(0)[1]), -1.0);
+        QCOMPARE(sampleValue(NodeKind::Int16, 2, log.column(1)[0]), -2.0);
+        QCOMPARE(log.column(2)[1], uint64_t(0xFFFE1234));
+        QCOMPARE(s.failedReads(), uint64_t(0));
+    }
+
+    void testFailedReadPushesNothing() {
+        auto prov = std::make_shared<BufferProvider>(QByteArray(0x1000, '\0'));
+        FieldSampler s(prov, {field("in", NodeKind::UInt32, 0x100, 4),
+                              field("out", NodeKind::UInt32, 0x2000, 4)}, 100);
+        put(*prov, 0x100, uint32_t(7));
+        s.sampleOnce(1);
+        QCOMPARE(s.failedReads(), uint64_t(1));
+        QCOMPARE(s.ring().drain([](int64_t, const uint64_t*) {}), 0);
+    }
+
+    void testFormatSample() {
+        QCOMPARE(formatSample(NodeKind::Int8, 1, 0xFF), QStringLiteral("-1"));
+        QCOMPARE(formatSample(NodeKind::UInt16, 2, 0xFFFF), QStringLiteral("65535"));
+        QCOMPARE(formatSample(NodeKind::Hex32, 4, 0xBEEF), QStringLiteral("0xBEEF"));
+        QCOMPARE(formatSample(NodeKind::Bool, 1, 1), QStringLiteral("true"));
+        uint32_t bits;
+        float f = 1.5f;
+        std::memcpy(&bits, &f, 4);
+        QCOMPARE(formatSample(NodeKind::Float, 4, bits), QStringLiteral("1.5"));
+    }
+
+    void testExportCsvAndBinary() {
+        QVector<SampledField> fields{field("Player.hp", NodeKind::Int32, 0x10, 4),
+                                     field("Player.flags", NodeKind::Hex8, 0x14, 1)};
+        SampleLog log(2);
+        uint64_t a[2] = {100, 0x3}, b[2] = {uint64_t(uint32_t(-5)), 0x80};
+        log.append(1000, a);
+        log.append(2000, b);
+
+        QBuffer csv;
+        csv.open(QIODevice::WriteOnly);
+        QVERIFY(log.writeCsv(csv, fields));
+        QCOMPARE(csv.data(), QByteArray("time_ns,\"Player.hp\",\"Player.flags\"\n"
+                                        "1000,100,0x3\n"
+                                        "2000,-5,0x80\n"));
+
+        QBuffer bin;
+        bin.open(QIODevice::WriteOnly);
+        QVERIFY(log.writeBinary(bin, fields));
+        const QByteArray& d = bin.data();
+        QVERIFY(d.startsWith("RCXSMPL1"));
+        int header = 8 + 4 + 8;
+        for (const auto& f : fields) header += 8 + 1 + 1 + 2 + f.name.toUtf8().size();
+        QCOMPARE(d.size(), header + 2 * 8 * 3);
+        uint64_t count;
+        std::memcpy(&count, d.constData() + 12, 8);
+        QCOMPARE(count, uint64_t(2));
+        int64_t t;
+        std::memcpy(&t, d.constData() + header + 24, 8);
+        QCOMPARE(t, int64_t(2000));
+    }
+
+    void testThreadCollectsSamples() {
+        auto prov = std::make_shared<BufferProvider>(QByteArray(0x100, '\0'));
+        put(*prov, 0x10, uint32_t(42));
+        FieldSampler s(prov, {field("v", NodeKind::UInt32, 0x10, 4)}, 2000);
+        s.start();
+        QVERIFY(s.isRunning());
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        s.stop();
+        QVERIFY(!s.isRunning());
+
+        int n = 0;
+        int64_t last = -1;
+        s.ring().drain([&](int64_t t, const uint64_t* v) {
+            QCOMPARE(v[0], uint64_t(42));
+            QVERIFY(t > last);
+            last = t;
+            ++n;
+        });
+        QVERIFY(n > 10);
+    }
+};
+
+QTEST_MAIN(TestFieldSampler)
+#include "test_fieldsampler.moc"
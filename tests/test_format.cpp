@@ -248,6 +248,39 @@ private slots:
         QCOMPARE(fmt::readValue(n, prov, 0, 0).count(','), 3);
     }
 
+    void testAppendNodeLineInPlace() {
+        // In-place builder appends after existing text and renders the same
+        // value column as readValue for every fast-path kind
+        QByteArray data(16, '\0');
+        data[0] = (char)0xAB;
+        data[1] = 0x12;
+        data[5] = 0x7F;
+        BufferProvider prov(data);
+
+        const NodeKind kinds[] = {
+            NodeKind::Int8, NodeKind::UInt8, NodeKind::UInt16, NodeKind::Int32,
+            NodeKind::UInt64, NodeKind::Bool, NodeKind::Pointer32,
+            NodeKind::Pointer64, NodeKind::FuncPtr64, NodeKind::Float
+        };
+        for (NodeKind k : kinds) {
+            Node n;
+            n.kind = k;
+            n.name = "field";
+            QString out = QStringLiteral("prefix|");
+            fmt::appendNodeLine(out, n, prov, 0, 1);
+            QVERIFY(out.startsWith("prefix|   "));
+            QCOMPARE(out.mid(7), fmt::fmtNodeLine(n, prov, 0, 1));
+            QVERIFY(out.contains(fmt::readValue(n, prov, 0, 0)));
+        }
+
+        // Hex preview: ASCII column then upper-case byte pairs
+        Node h;
+        h.kind = NodeKind::Hex16;
+        h.name = "h";
+        QString line = fmt::fmtNodeLine(h, prov, 0, 0);
+        QVERIFY(line.contains("AB 12"));
+    }
+
     void testEditableValueBasic() {
         QByteArray data(16, '\0');
         // Write a known float value
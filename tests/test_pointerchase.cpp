@@ -0,0 +1,134 @@
+#include <QTest>
+#include <cstring>
+#include "pointerchase.h"
+
+using namespace rcx;
+
+// Root at 0 holds `a` (-> A at 0x4000); A holds a field and `b` (-> B at
+// 0x8000). Memory is 64 KB of a BufferProvider.
+class TestPointerChase : public QObject {
+    Q_OBJECT
+
+private:
+    QByteArray m_mem;
+    NodeTree   m_tree;
+    uint64_t   m_rootId = 0;
+    uint64_t   m_ptrA = 0;
+
+    void put64(uint64_t addr, uint64_t v) { std::memcpy(m_mem.data() + addr, &v, 8); }
+
+    uint64_t addStruct(const QString& name, uint64_t parentId, int offset) {
+        Node n;
+        n.kind = NodeKind::Struct;
+        n.name = name;
+        n.parentId = parentId;
+        n.offset = offset;
+        return m_tree.nodes[m_tree.addNode(n)].id;
+    }
+    uint64_t addField(NodeKind kind, const QString& name, uint64_t parentId, int offset,
+                      uint64_t refId = 0) {
+        Node n;
+        n.kind = kind;
+        n.name = name;
+        n.parentId = parentId;
+        n.offset = offset;
+        n.refId = refId;
+        return m_tree.nodes[m_tree.addNode(n)].id;
+    }
+
+    // The pages `prov` holds at the given addresses, as one refresh read them
+    PageTable readNow(const Provider& prov, std::initializer_list<uint64_t> addrs) {
+        PageTable t;
+        for (uint64_t a : addrs) {
+            PageBuf& page = t.insert(a, PagePool::instance().acquire());
+            prov.read(a, page.data(), PagePool::kPageSize);
+        }
+        return t;
+    }
+
+private slots:
+    void init() {
+        m_mem = QByteArray(0x10000, '\0');
+        m_tree = NodeTree();
+        m_rootId = addStruct("Root", 0, 0);
+        uint64_t a = addStruct("A", 0, 0x100);
+        uint64_t b = addStruct("B", 0, 0x200);
+        m_ptrA = addField(NodeKind::Pointer64, "a", m_rootId, 0, a);
+        addField(NodeKind::Hex64, "x", a, 0);
+        addField(NodeKind::Pointer64, "b", a, 8, b);
+        addField(NodeKind::Hex64, "y", b, 0);
+        put64(0, 0x4000);
+        put64(0x4008, 0x8000);
+    }
+
+    void testNewTargetsReadInSameRefresh() {
+        BufferProvider prov(m_mem);
+        PageTable pages = readNow(prov, {0});
+        QCOMPARE(chasePointers(m_tree, m_rootId, 0, prov, pages, nullptr), 2);
+        QVERIFY(pages.contains(0x4000));
+        QVERIFY(pages.contains(0x8000));
+        uint64_t b;
+        std::memcpy(&b, pages.find(0x4000)->constData() + 8, 8);
+        QCOMPARE(b, uint64_t(0x8000));
+    }
+
+    void testUnmovedPointerKeepsTargetSchedule() {
+        BufferProvider prov(m_mem);
+        PageTable prev = readNow(prov, {0, 0x4000, 0x8000});
+        PageTable pages = readNow(prov, {0});
+        QCOMPARE(chasePointers(m_tree, m_rootId, 0, prov, pages, &prev), 0);
+        QCOMPARE(pages.size(), 1);
+    }
+
+    void testMovedPointerRereadsTarget() {
+        BufferProvider before(m_mem);
+        PageTable prev = readNow(before, {0, 0x4000, 0x8000});
+        put64(0, 0x8000);          // a now points where B lives
+        put64(0x8008, 0xC000);
+        BufferProvider after(m_mem);
+        PageTable pages = readNow(after, {0});
+        // 0x8000 is re-read although prev holds it; b is followed from the
+        // fresh bytes to 0xC000
+        QCOMPARE(chasePointers(m_tree, m_rootId, 0, after, pages, &prev), 2);
+        QVERIFY(pages.contains(0x8000));
+        QVERIFY(pages.contains(0xC000));
+        QVERIFY(!pages.contains(0x4000));
+    }
+
+    void testCollapsedPointerNotFollowed() {
+        m_tree.nodes[m_tree.indexOfId(m_ptrA)].collapsed = true;
+        BufferProvider prov(m_mem);
+        PageTable pages = readNow(prov, {0});
+        QCOMPARE(chasePointers(m_tree, m_rootId, 0, prov, pages, nullptr), 0);
+    }
+
+    void testNullPointerNotFollowed() {
+        put64(0, 0);
+        BufferProvider prov(m_mem);
+        PageTable pages = readNow(prov, {0});
+        QCOMPARE(chasePointers(m_tree, m_rootId, 0, prov, pages, nullptr), 0);
+    }
+
+    void testLimits() {
+        BufferProvider prov(m_mem);
+        PageTable pages = readNow(prov, {0});
+        PointerChaseLimits limits;
+        limits.maxDepth = 1;
+        QCOMPARE(chasePointers(m_tree, m_rootId, 0, prov, pages, nullptr, limits), 1);
+        QVERIFY(!pages.contains(0x8000));
+
+        PageTable again = readNow(prov, {0});
+        limits.maxDepth = 99;
+        limits.pageBudget = 1;
+        QCOMPARE(chasePointers(m_tree, m_rootId, 0, prov, again, nullptr, limits), 1);
+    }
+
+    void testAllRootsWhenNoViewRoot() {
+        BufferProvider prov(m_mem);
+        PageTable pages = readNow(prov, {0});
+        QCOMPARE(chasePointers(m_tree, 0, 0, prov, pages, nullptr), 2);
+    }
+};
+
+QTEST_MAIN(TestPointerChase)
+#include "test_pointerchase.moc"
@@ -3,15 +3,151 @@
 #include <QDir>
 #include <QFile>
 #include <cstring>
+#include <vector>
 #include "providers/provider.h"
 #include "providers/buffer_provider.h"
+#include "providers/caching_provider.h"
+#include "providers/mapped_file_provider.h"
+#include "providers/coredump_provider.h"
+#include "providers/region_map.h"
 #include "providers/null_provider.h"
+#include "providers/snapshot_provider.h"
+#include "providers/symbol_index.h"
 
 using namespace rcx;
 
+// A buffer that counts how often it is asked for bytes
+class CountingProvider : public BufferProvider {
+public:
+    using BufferProvider::BufferProvider;
+    mutable int reads = 0;
+    bool read(uint64_t addr, void* buf, int len) const override {
+        ++reads;
+        return BufferProvider::read(addr, buf, len);
+    }
+};
+
+static int64_t s_cacheNow = 0;
+static int64_t cacheClock() { return s_cacheNow; }
+
 class TestProvider : public QObject {
     Q_OBJECT
 
+private:
+    // A minimal ELF64 core: libc's segment (listed first) dumped only up to
+    // 0x800 of 0x2000 bytes, the executable's 0x1000 bytes in full, and
+    // NT_FILE / NT_AUXV notes naming both and the entry point
+    static QByteArray makeCore() {
+        QByteArray f(0x2800, '\0');
+        auto put16 = [&](int at, uint16_t v) { std::memcpy(f.data() + at, &v, 2); };
+        auto put32 = [&](int at, uint32_t v) { std::memcpy(f.data() + at, &v, 4); };
+        auto put64 = [&](int at, uint64_t v) { std::memcpy(f.data() + at, &v, 8); };
+        std::memcpy(f.data(), "\x7f" "ELF\x02\x01\x01", 7);
+        put16(16, 4);       // ET_CORE
+        put16(18, 62);      // x86-64
+        put32(20, 1);
+        put64(32, 64);      // e_phoff
+        put16(52, 64);
+        put16(54, 56);
+        put16(56, 3);
+
+        auto phdr = [&](int i, uint32_t type, uint64_t off, uint64_t vaddr,
+                        uint64_t filesz, uint64_t memsz) {
+            int at = 64 + i * 56;
+            put32(at, type);
+            put64(at + 8, off);
+            put64(at + 16, vaddr);
+            put64(at + 32, filesz);
+            put64(at + 40, memsz);
+        };
+
+        // Notes at 0x100
+        int at = 0x100;
+        auto note = [&](uint32_t type, const QByteArray& desc) {
+            put32(at, 5);
+            put32(at + 4, uint32_t(desc.size()));
+            put32(at + 8, type);
+            std::memcpy(f.data() + at + 12, "CORE", 5);
+            std::memcpy(f.data() + at + 20, desc.constData(), desc.size());
+            at += 20 + ((desc.size() + 3) & ~3);
+        };
+        QByteArray files(2 * 8 + 2 * 24, '\0');
+        uint64_t words[] = {2, 4096, 0x400000, 0x401000, 0, 0x7f0000, 0x7f2000, 0};
+        std::memcpy(files.data(), words, sizeof(words));
+        files += QByteArray("/usr/bin/app\0/lib/libc.so.6\0", 28);
+        note(0x46494c45, files);
+        uint64_t auxv[] = {9, 0x400100, 0, 0};
+        note(6, QByteArray(reinterpret_cast<const char*>(auxv), sizeof(auxv)));
+        phdr(0, 4, 0x100, 0, uint64_t(at - 0x100), 0);
+
+        phdr(1, 1, 0x2000, 0x7f0000, 0x800, 0x2000);
+        phdr(2, 1, 0x1000, 0x400000, 0x1000, 0x1000);
+        for (int i = 0; i < 0x1800; ++i)
+            f[0x1000 + i] = char(i);
+        return f;
+    }
+
+    // A minimal ELF64 shared object: one PT_LOAD at 0, a .symtab with
+    // compute() at 0x1100 (0x40 bytes), table at 0x2000 (0x10 bytes) and an
+    // undefined import, and a .dynsym repeating compute() without a size
+    static QByteArray makeSharedObject() {
+        QByteArray f(0x700, '\0');
+        auto put16 = [&](int at, uint16_t v) { std::memcpy(f.data() + at, &v, 2); };
+        auto put32 = [&](int at, uint32_t v) { std::memcpy(f.data() + at, &v, 4); };
+        auto put64 = [&](int at, uint64_t v) { std::memcpy(f.data() + at, &v, 8); };
+        std::memcpy(f.data(), "\x7f" "ELF\x02\x01\x01", 7);
+        put16(16, 3);       // ET_DYN
+        put16(18, 62);
+        put32(20, 1);
+        put64(32, 64);      // e_phoff
+        put64(40, 0x500);   // e_shoff
+        put16(52, 64);
+        put16(54, 56);
+        put16(56, 1);
+        put16(58, 64);
+        put16(60, 5);
+        put32(64, 1);       // PT_LOAD at vaddr 0
+
+        const char strs[] = "\0compute\0table\0import";
+        std::memcpy(f.data() + 0x200, strs, sizeof(strs));
+        std::memcpy(f.data() + 0x480, strs, sizeof(strs));
+        auto sym = [&](int at, uint32_t name, uint8_t info, uint16_t shndx,
+                       uint64_t value, uint64_t size) {
+            put32(at, name);
+            f[at + 4] = char(info);
+            put16(at + 6, shndx);
+            put64(at + 8, value);
+            put64(at + 16, size);
+        };
+        sym(0x318, 1, 0x12, 1, 0x1100, 0x40);   // GLOBAL FUNC
+        sym(0x330, 9, 0x11, 1, 0x2000, 0x10);   // GLOBAL OBJECT
+        sym(0x348, 15, 0x12, 0, 0, 0);          // undefined
+        sym(0x418, 1, 0x12, 1, 0x1100, 0);
+
+        auto shdr = [&](int i, uint32_t type, uint64_t off, uint64_t size,
+                        uint32_t link, uint64_t entsize) {
+            int at = 0x500 + i * 64;
+            put32(at + 4, type);
+            put64(at + 24, off);
+            put64(at + 32, size);
+            put32(at + 40, link);
+            put64(at + 56, entsize);
+        };
+        shdr(1, 2, 0x300, 4 * 24, 2, 24);       // .symtab
+        shdr(2, 3, 0x200, sizeof(strs), 0, 0);  // .strtab
+        shdr(3, 11, 0x400, 2 * 24, 4, 24);      // .dynsym
+        shdr(4, 3, 0x480, sizeof(strs), 0, 0);  // .dynstr
+        return f;
+    }
+
+    static QString writeTemp(const QString& name, const QByteArray& data) {
+        QString path = QDir::tempPath() + "/" + name;
+        QFile f(path);
+        if (f.open(QIODevice::WriteOnly))
+            f.write(data);
+        return path;
+    }
+
 private slots:
 
     // ---------------------------------------------------------------
@@ -177,6 +313,169 @@ private slots:
         QCOMPARE(result.size(), 0);
     }
 
+    // ---------------------------------------------------------------
+    // BufferProvider -- readBatch (default one-by-one fallback)
+    // ---------------------------------------------------------------
+
+    void buffer_readBatch_perRangeResult() {
+        BufferProvider p(QByteArray("ABCDEFGH", 8));
+        char a[4], b[4], c[2];
+        std::memset(b, 'x', sizeof(b));
+        Provider::ReadRequest reqs[] = {
+            {0, a, 4},
+            {6, b, 4},      // runs past the end
+            {6, c, 2},
+        };
+        QVERIFY(!p.readBatch(reqs, 3));
+        QVERIFY(reqs[0].ok);
+        QVERIFY(!reqs[1].ok);
+        QVERIFY(reqs[2].ok);
+        QCOMPARE(QByteArray(a, 4), QByteArray("ABCD"));
+        QCOMPARE(QByteArray(b, 4), QByteArray(4, '\0'));  // failed ranges read as zeros
+        QCOMPARE(QByteArray(c, 2), QByteArray("GH"));
+    }
+
+    void buffer_readBatch_allOk() {
+        BufferProvider p(QByteArray("ABCDEFGH", 8));
+        char a[2], b[2];
+        Provider::ReadRequest reqs[] = { {2, a, 2}, {4, b, 2} };
+        QVERIFY(p.readBatch(reqs, 2));
+        QCOMPARE(QByteArray(a, 2), QByteArray("CD"));
+        QCOMPARE(QByteArray(b, 2), QByteArray("EF"));
+    }
+
+    // ---------------------------------------------------------------
+    // SnapshotProvider -- page diffing
+    // ---------------------------------------------------------------
+
+    void snapshot_changedRanges_coalescesRuns() {
+        QByteArray oldPage(4096, '\0');
+        QByteArray newPage = oldPage;
+        for (int i = 100; i < 300; i++) newPage[i] = 1;   // one run across blocks
+        newPage[301] = 1;                                 // gap of one byte
+        newPage[4095] = 1;                                // tail of the page
+        SnapshotProvider::PageMap before{{0x1000, oldPage}}, after{{0x1000, newPage}};
+
+        ChangedRanges r = SnapshotProvider::changedRanges(before, after);
+        QCOMPARE(r.size(), 3);
+        QCOMPARE(r.ranges()[0].start, int64_t(0x1000 + 100));
+        QCOMPARE(r.ranges()[0].end,   int64_t(0x1000 + 300));
+        QCOMPARE(r.ranges()[1].start, int64_t(0x1000 + 301));
+        QCOMPARE(r.ranges()[2].end,   int64_t(0x2000));
+
+        QVERIFY(r.intersects(0x1000 + 296, 8));
+        QVERIFY(!r.intersects(0x1000, 100));
+        QVERIFY(!r.intersects(0x1000 + 300, 1));
+        QCOMPARE(r.byteMask(0x1000 + 296, 8), uint8_t(0x2F));  // bytes 0-3 and 5
+    }
+
+    void snapshot_changedRanges_mergesAcrossPages() {
+        QByteArray zero(4096, '\0');
+        QByteArray tail = zero, head = zero;
+        tail[4095] = 1;
+        head[0] = 1;
+        SnapshotProvider::PageMap before{{0, zero}, {4096, zero}};
+        SnapshotProvider::PageMap after{{0, tail}, {4096, head}};
+        ChangedRanges r = SnapshotProvider::changedRanges(before, after);
+        QCOMPARE(r.size(), 1);
+        QCOMPARE(r.ranges()[0].start, int64_t(4095));
+        QCOMPARE(r.ranges()[0].end,   int64_t(4097));
+    }
+
+    void snapshot_changedRanges_skipsMatchingHashes() {
+        QByteArray a(4096, 'a'), b(4096, 'b');
+        SnapshotProvider::PageMap before{{0, a}}, after{{0, b}};
+        QVERIFY(SnapshotProvider::pageHash(a) != SnapshotProvider::pageHash(b));
+        QVERIFY(!SnapshotProvider::changedRanges(before, after).isEmpty());
+        before.setHash(0, 7);
+        after.setHash(0, 7);
+        QVERIFY(SnapshotProvider::changedRanges(before, after).isEmpty());
+    }
+
+    void snapshot_patchPages_leavesSharedPagesAlone() {
+        QByteArray zero(4096, '\0');
+        SnapshotProvider older(nullptr, SnapshotProvider::PageMap{{0x1000, zero}}, 4096);
+        SnapshotProvider newer(nullptr, older.pages(), 4096);
+        QCOMPARE(older.pages().find(0x1000)->constData(),
+                 newer.pages().find(0x1000)->constData());   // one pooled page
+        uint32_t v = 0xAABBCCDD;
+        newer.patchPages(0x1010, &v, 4);
+        QCOMPARE(newer.readU32(0x1010), v);
+        QCOMPARE(older.readU32(0x1010), uint32_t(0));
+    }
+
+    // ---------------------------------------------------------------
+    // PagePool / PageTable
+    // ---------------------------------------------------------------
+
+    void pagePool_reusesReleasedSlots() {
+        const char* first;
+        {
+            PageBuf page = PagePool::instance().acquire();
+            QCOMPARE(page.size(), PagePool::kPageSize);
+            first = page.constData();
+        }
+        int slabs = PagePool::instance().slabCount();
+        PageBuf again = PagePool::instance().acquire();
+        QCOMPARE(again.constData(), first);
+        QCOMPARE(PagePool::instance().slabCount(), slabs);
+    }
+
+    void pageBuf_detachCopiesOnlyShared() {
+        PageBuf a = PageBuf::fromBytes(QByteArray("abc"));
+        const char* slot = a.constData();
+        a.detach();
+        QCOMPARE(a.constData(), slot);      // sole owner: stays put
+        PageBuf b = a;
+        QVERIFY(a.isShared() && b.isShared());
+        b.detach();
+        QVERIFY(b.constData() != slot);
+        QVERIFY(!a.isShared());
+        QCOMPARE(std::memcmp(a.constData(), b.constData(), PagePool::kPageSize), 0);
+        QCOMPARE(a.constData()[3], '\0');  // zero-padded
+    }
+
+    void pageTable_insertFindClear() {
+        PageTable t;
+        for (int i = 0; i < 1000; i++)
+            t.insert(uint64_t(i) * 4096, PagePool::instance().acquire(), uint64_t(i) + 1);
+        QCOMPARE(t.size(), 1000);
+        QVERIFY(t.capacity() >= 2000);
+        for (int i = 0; i < 1000; i++)
+            QCOMPARE(t.hashOf(uint64_t(i) * 4096), uint64_t(i) + 1);
+        QVERIFY(!t.contains(1000 * 4096));
+        QCOMPARE(t.hashOf(1000 * 4096), uint64_t(0));
+
+        int seen = 0;
+        for (auto it = t.constBegin(); it != t.constEnd(); ++it) {
+            QCOMPARE(it.hash(), it.key() / 4096 + 1);
+            seen++;
+        }
+        QCOMPARE(seen, 1000);
+
+        // Replacing keeps the size; clear keeps the storage
+        t.insert(0, PagePool::instance().acquire(), 42);
+        QCOMPARE(t.size(), 1000);
+        QCOMPARE(t.hashOf(0), uint64_t(42));
+        int cap = t.capacity();
+        t.clear();
+        QVERIFY(t.isEmpty());
+        QCOMPARE(t.capacity(), cap);
+        QVERIFY(!t.contains(0));
+    }
+
+    void snapshot_changedRanges_unite() {
+        ChangedRanges a, b;
+        a.append(0, 4);
+        a.append(10, 12);
+        b.append(3, 6);
+        b.append(20, 21);
+        a.unite(b);
+        QCOMPARE(a.size(), 3);
+        QCOMPARE(a.ranges()[0].end, int64_t(6));
+        QCOMPARE(a.ranges()[2].start, int64_t(20));
+    }
+
     // ---------------------------------------------------------------
     // BufferProvider -- isReadable boundary checks
     // ---------------------------------------------------------------
@@ -259,6 +558,360 @@ private slots:
         QFile::remove(path);
     }
 
+    // ---------------------------------------------------------------
+    // MappedFileProvider
+    // ---------------------------------------------------------------
+
+    void mapped_nonexistent() {
+        MappedFileProvider p("/tmp/__rcx_test_nonexistent_file__");
+        QVERIFY(!p.isOpen());
+        QVERIFY(!p.isValid());
+        QVERIFY(!p.isWritable());
+        uint8_t b;
+        QVERIFY(!p.read(0, &b, 1));
+    }
+
+    void mapped_readsFile() {
+        QString path = QDir::tempPath() + "/rcx_test_mapped_provider.bin";
+        QByteArray data(8192, '\0');
+        for (int i = 0; i < data.size(); ++i) data[i] = char(i * 7);
+        {
+            QFile f(path);
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            f.write(data);
+        }
+        {
+            MappedFileProvider p(path, MappedFileProvider::Mode::ReadOnly);
+            QVERIFY(p.isOpen());
+            QCOMPARE(p.size(), 8192);
+            QCOMPARE(p.fileSize(), uint64_t(8192));
+            QCOMPARE(p.name(), QStringLiteral("rcx_test_mapped_provider.bin"));
+            QCOMPARE(p.readBytes(4000, 200), data.mid(4000, 200));
+            QVERIFY(p.isReadable(8190, 2));
+            QVERIFY(!p.isReadable(8190, 3));
+            QVERIFY(!p.isWritable());
+            QVERIFY(!p.writeBytes(0, QByteArray("x")));
+        }
+        QFile::remove(path);
+    }
+
+    void mapped_copyOnWriteLeavesFile() {
+        QString path = QDir::tempPath() + "/rcx_test_mapped_cow.bin";
+        {
+            QFile f(path);
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            f.write(QByteArray(64, '\xAB'));
+        }
+        {
+            MappedFileProvider p(path);
+            QVERIFY(p.isWritable());
+            QVERIFY(p.writeBytes(10, QByteArray("\x01\x02", 2)));
+            QCOMPARE(p.readU16(10), (uint16_t)0x0201);
+            QVERIFY(!p.writeBytes(63, QByteArray("\x01\x02", 2)));
+        }
+        QFile f(path);
+        QVERIFY(f.open(QIODevice::ReadOnly));
+        QCOMPARE(f.readAll(), QByteArray(64, '\xAB'));
+        f.close();
+        QFile::remove(path);
+    }
+
+    void mapped_emptyFileIsNotOpen() {
+        QString path = QDir::tempPath() + "/rcx_test_mapped_empty.bin";
+        {
+            QFile f(path);
+            QVERIFY(f.open(QIODevice::WriteOnly));
+        }
+        MappedFileProvider p(path);
+        QVERIFY(!p.isOpen());
+        QCOMPARE(p.size(), 0);
+        QFile::remove(path);
+    }
+
+    // ---------------------------------------------------------------
+    // CoreDumpProvider
+    // ---------------------------------------------------------------
+
+    void coreDump_parsesSegmentsAndNotes() {
+        QByteArray core = makeCore();
+        CoreDumpProvider::Layout layout;
+        QVERIFY(CoreDumpProvider::parse(reinterpret_cast<const uchar*>(core.constData()),
+                                        uint64_t(core.size()), &layout));
+        QCOMPARE(layout.segments.size(), 2);
+        QCOMPARE(layout.segments[0].vaddr, uint64_t(0x400000));
+        QCOMPARE(layout.segments[1].fileSize, uint64_t(0x800));
+        QCOMPARE(layout.segments[1].memSize, uint64_t(0x2000));
+        QCOMPARE(layout.modules.size(), 2);
+        QCOMPARE(layout.modules[0].name, QStringLiteral("app"));
+        QCOMPARE(layout.modules[1].name, QStringLiteral("libc.so.6"));
+        QCOMPARE(layout.entry, uint64_t(0x400100));
+
+        QByteArray flat(256, '\0');
+        QVERIFY(!CoreDumpProvider::parse(reinterpret_cast<const uchar*>(flat.constData()),
+                                         uint64_t(flat.size()), &layout));
+    }
+
+    void coreDump_truncatedNotes() {
+        // The file ends right after a last note whose 1-byte descriptor is
+        // not padded to 4: the note walk must stop there
+        QByteArray f = makeCore();
+        uint64_t notesLen;
+        std::memcpy(&notesLen, f.constData() + 64 + 32, 8);
+        const int at = 0x100 + int(notesLen);
+        const uint32_t hdr[] = {5, 1, 0x1234};
+        std::memcpy(f.data() + at, hdr, sizeof(hdr));
+        std::memcpy(f.data() + at + 12, "CORE", 5);
+        f[at + 20] = '\x7f';
+        notesLen += 21;
+        std::memcpy(f.data() + 64 + 32, &notesLen, 8);
+        // An exact-size copy, so reading past its end is caught by sanitizers
+        std::vector<uchar> file(f.constData(), f.constData() + at + 21);
+
+        CoreDumpProvider::Layout layout;
+        QVERIFY(CoreDumpProvider::parse(file.data(), uint64_t(file.size()), &layout));
+        QCOMPARE(layout.modules.size(), 2);
+        QCOMPARE(layout.entry, uint64_t(0x400100));
+        QVERIFY(layout.segments.isEmpty());     // both past the truncation
+    }
+
+    void coreDump_readsAtVirtualAddresses() {
+        QString path = writeTemp("rcx_test_core.core", makeCore());
+        {
+            CoreDumpProvider p(path);
+            QVERIFY(p.isOpen());
+            QVERIFY(p.isValid());
+            QCOMPARE(p.kind(), QStringLiteral("CoreDump"));
+            QCOMPARE(p.readU8(0x400010), (uint8_t)0x10);
+            QCOMPARE(p.readU8(0x7f0001), (uint8_t)0x01);     // file offset 0x2001
+            // Dumped part only; nothing between or past the segments
+            QVERIFY(p.isReadable(0x7f07fc, 4));
+            QVERIFY(!p.isReadable(0x7f07fc, 8));
+            QVERIFY(!p.isReadable(0x401000, 1));
+            QVERIFY(!p.isReadable(0x1000, 1));
+
+            QVERIFY(p.writeBytes(0x400020, QByteArray("\xEE", 1)));
+            QCOMPARE(p.readU8(0x400020), (uint8_t)0xEE);
+        }
+        QFile::remove(path);
+    }
+
+    void coreDump_modulesAsSymbols() {
+        QString path = writeTemp("rcx_test_core_syms.core", makeCore());
+        {
+            CoreDumpProvider p(path);
+            QCOMPARE(p.base(), uint64_t(0x400000));
+            QCOMPARE(p.getSymbol(0x7f0010), QStringLiteral("libc.so.6+0x10"));
+            QVERIFY(p.getSymbol(0x7f2000).isEmpty());
+            QVERIFY(p.getSymbol(0x100).isEmpty());
+            QCOMPARE(p.symbolToAddress("LIBC.so.6"), uint64_t(0x7f0000));
+            QCOMPARE(p.symbolToAddress("missing"), uint64_t(0));
+        }
+        QFile::remove(path);
+    }
+
+    void coreDump_rejectsFlatFile() {
+        QString path = writeTemp("rcx_test_not_core.bin", QByteArray(4096, '\x11'));
+        CoreDumpProvider p(path);
+        QVERIFY(!p.isOpen());
+        QCOMPARE(p.size(), 0);
+        QFile::remove(path);
+    }
+
+    // ---------------------------------------------------------------
+    // RegionMap
+    // ---------------------------------------------------------------
+
+    void regionMap_parsesProcMaps() {
+        QByteArray maps =
+            "55d0c3a00000-55d0c3a02000 r--p 00000000 08:02 173521                     /usr/bin/my app\n"
+            "55d0c3a02000-55d0c3a2c000 r-xp 00002000 08:02 173521                     /usr/bin/my app\n"
+            "7f3a1c000000-7f3a1c021000 rw-p 00000000 00:00 0                          [heap]\n"
+            "7f3a1d000000-7f3a1d001000 ---p 00000000 00:00 0 \n"
+            "7f3a1e000000-7f3a1e001000 rw-s 00000000 00:05 42                         /memfd:x (deleted)\n"
+            "garbage line\n";
+        QVector<Provider::Region> r = RegionMap::parseProcMaps(maps);
+        QCOMPARE(r.size(), 5);
+        QCOMPARE(r[0].start, uint64_t(0x55d0c3a00000));
+        QCOMPARE(r[0].size, uint64_t(0x2000));
+        QCOMPARE(r[0].perms, uint32_t(Provider::Region::Read));
+        QCOMPARE(r[0].module, QStringLiteral("my app"));
+        QCOMPARE(r[1].perms, uint32_t(Provider::Region::Read | Provider::Region::Exec));
+        QVERIFY(r[2].module.isEmpty());
+        QCOMPARE(r[3].perms, uint32_t(0));
+        QCOMPARE(r[4].module, QStringLiteral("memfd:x"));
+    }
+
+    void regionMap_lookup() {
+        using R = Provider::Region;
+        RegionMap map({R{0x3000, 0x1000, R::Read, {}},
+                       R{0x1000, 0x1000, R::Read | R::Write, {}},
+                       R{0x2000, 0x1000, R::Read, {}},
+                       R{0x8000, 0x1000, 0, {}}});
+        QCOMPARE(map.size(), 4);
+        QVERIFY(!map.find(0xFFF));
+        QCOMPARE(map.find(0x1800)->start, uint64_t(0x1000));
+        QVERIFY(!map.find(0x4000));
+        // Back-to-back regions cover as one range; gaps and missing
+        // permissions do not
+        QVERIFY(map.covers(0x1800, 0x2000));
+        QVERIFY(!map.covers(0x3800, 0x1000));
+        QVERIFY(!map.covers(0x1800, 0x1000, R::Write));
+        QVERIFY(!map.covers(0x8000, 1));
+        QVERIFY(map.covers(0x9000, 0));
+        QVERIFY(!map.covers(~uint64_t(0), 2));
+    }
+
+    void regionMap_trimsOverlaps() {
+        using R = Provider::Region;
+        RegionMap map({R{0x1000, 0x2000, R::Read, {}}, R{0x2000, 0x2000, R::Read, {}},
+                       R{0x1800, 0x100, R::Read, {}}});
+        QCOMPARE(map.size(), 2);
+        QCOMPARE(map.regions()[1].start, uint64_t(0x3000));
+        QCOMPARE(map.regions()[1].size, uint64_t(0x1000));
+    }
+
+    // ---------------------------------------------------------------
+    // CachingProvider
+    // ---------------------------------------------------------------
+
+    void caching_servesRepeatsFromMemory() {
+        QByteArray data(0x4000, '\0');
+        for (int i = 0; i < data.size(); ++i) data[i] = char(i * 7);
+        auto real = std::make_shared<CountingProvider>(data);
+        s_cacheNow = 0;
+        CachingProvider cache(real, 8, 100, cacheClock);
+
+        // Straddles two pages: one batch, then nothing
+        uint64_t v = 0;
+        QVERIFY(cache.read(0xFFC, &v, 8));
+        uint64_t expect;
+        std::memcpy(&expect, data.constData() + 0xFFC, 8);
+        QCOMPARE(v, expect);
+        int fetched = real->reads;
+        QCOMPARE(cache.cachedPages(), 2);
+        for (int i = 0; i < 10; ++i)
+            QCOMPARE(cache.readU32(0x1000 + i * 4), real->readU32(0x1000 + i * 4));
+        QCOMPARE(real->reads, fetched + 10);    // only the direct comparisons
+
+        // Expired pages are fetched again
+        s_cacheNow = 100;
+        cache.readU8(0x1000);
+        QCOMPARE(real->reads, fetched + 11);
+    }
+
+    void caching_evictsLeastRecentlyUsed() {
+        auto real = std::make_shared<CountingProvider>(QByteArray(0x5000, 'x'));
+        s_cacheNow = 0;
+        CachingProvider cache(real, 2, 1000, cacheClock);
+        cache.readU8(0x0000);
+        cache.readU8(0x1000);
+        cache.readU8(0x0000);       // page 0 is now the most recent
+        cache.readU8(0x2000);       // evicts page 1
+        QCOMPARE(cache.cachedPages(), 2);
+        int before = real->reads;
+        cache.readU8(0x0000);
+        QCOMPARE(real->reads, before);
+        cache.readU8(0x1000);
+        QCOMPARE(real->reads, before + 1);
+    }
+
+    void caching_writeInvalidates() {
+        auto real = std::make_shared<CountingProvider>(QByteArray(0x2000, '\0'));
+        s_cacheNow = 0;
+        CachingProvider cache(real, 8, 1000, cacheClock);
+        QCOMPARE(cache.readU32(0x10), 0u);
+        uint32_t v = 0xAABBCCDD;
+        QVERIFY(cache.write(0x10, &v, 4));
+        QCOMPARE(cache.readU32(0x10), 0xAABBCCDDu);
+
+        // Behind the cache's back: stale until invalidated
+        real->writeBytes(0x10, QByteArray(4, '\x11'));
+        QCOMPARE(cache.readU32(0x10), 0xAABBCCDDu);
+        cache.invalidate();
+        QCOMPARE(cache.readU32(0x10), 0x11111111u);
+    }
+
+    void caching_partialPagesPassThrough() {
+        // The last page is short: reads there are never cached
+        auto real = std::make_shared<CountingProvider>(QByteArray(0x1800, 'y'));
+        s_cacheNow = 0;
+        CachingProvider cache(real, 8, 1000, cacheClock);
+        QCOMPARE(cache.readU8(0x1700), uint8_t('y'));
+        QCOMPARE(cache.cachedPages(), 0);
+        uint8_t b;
+        QVERIFY(!cache.read(0x1800, &b, 1));
+        QCOMPARE(cache.size(), 0x1800);
+        QVERIFY(cache.isReadable(0x17FF, 1));
+        QVERIFY(!cache.isReadable(0x17FF, 2));
+    }
+
+    // ---------------------------------------------------------------
+    // SymbolIndex
+    // ---------------------------------------------------------------
+
+    void symbolIndex_modules() {
+        SymbolIndex index({{"Game.exe", 0x140000000, 0x10000, {}},
+                           {"ntdll.dll", 0x7ff800000000, 0x1F0000, {}},
+                           {"overlap.dll", 0x140008000, 0x1000, {}}});
+        QCOMPARE(index.modules().size(), 2);
+        QCOMPARE(index.symbolize(0x140001234), QStringLiteral("Game.exe+0x1234"));
+        QCOMPARE(index.symbolize(0x7ff800000010), QStringLiteral("ntdll.dll+0x10"));
+        QVERIFY(index.symbolize(0x140010000).isEmpty());
+        QVERIFY(index.symbolize(0x1000).isEmpty());
+        QCOMPARE(index.moduleBase("NTDLL.DLL"), uint64_t(0x7ff800000000));
+        QCOMPARE(index.moduleBase("overlap.dll"), uint64_t(0));
+        QCOMPARE(index.moduleAt(0x14000FFFF)->name, QStringLiteral("Game.exe"));
+    }
+
+    void symbolIndex_parsesElfSymbols() {
+        QByteArray so = makeSharedObject();
+        SymbolIndex::SymbolTable table;
+        QVERIFY(SymbolIndex::parseElfSymbols(reinterpret_cast<const uchar*>(so.constData()),
+                                             uint64_t(so.size()), &table));
+        QCOMPARE(table.linkBase, uint64_t(0));
+        QCOMPARE(table.symbols.size(), 2);
+        QCOMPARE(table.symbols[0].name, QStringLiteral("compute"));
+        QCOMPARE(table.symbols[0].size, uint64_t(0x40));    // the sized copy won
+        QCOMPARE(table.symbols[1].name, QStringLiteral("table"));
+
+        QByteArray flat(0x100, 'x');
+        QVERIFY(!SymbolIndex::parseElfSymbols(reinterpret_cast<const uchar*>(flat.constData()),
+                                              uint64_t(flat.size()), &table));
+    }
+
+    void symbolIndex_resolvesFunctions() {
+        QString path = writeTemp("rcx_test_libfoo.so", makeSharedObject());
+        const uint64_t base = 0x7f0000000000;
+        SymbolIndex index({{"libfoo.so", base, 0x3000, path}}, SymbolIndex::Load::Inline);
+        QCOMPARE(index.symbolize(base + 0x1112), QStringLiteral("libfoo.so!compute+0x12"));
+        QCOMPARE(index.symbolize(base + 0x1100), QStringLiteral("libfoo.so!compute"));
+        QCOMPARE(index.symbolize(base + 0x1140), QStringLiteral("libfoo.so+0x1140"));
+        QCOMPARE(index.symbolize(base + 0x2008), QStringLiteral("libfoo.so!table+0x8"));
+        QVERIFY(index.symbolize(base + 0x3000).isEmpty());
+        QFile::remove(path);
+    }
+
+    void symbolIndex_loadsInBackground() {
+        QString path = writeTemp("rcx_test_libbar.so", makeSharedObject());
+        SymbolIndex index({{"libbar.so", 0x10000, 0x3000, path}});
+        // The first lookup starts the parse and answers without it
+        QCOMPARE(index.symbolize(0x11100), QStringLiteral("libbar.so+0x1100"));
+        QThreadPool::globalInstance()->waitForDone();
+        QCOMPARE(index.symbolize(0x11100), QStringLiteral("libbar.so!compute"));
+        QFile::remove(path);
+    }
+
+    void symbolIndex_sharedPerProcess() {
+        QVector<SymbolIndex::Module> mods{{"a.so", 0x1000, 0x1000, {}}};
+        auto first = SymbolIndex::shared(4242, mods);
+        QCOMPARE(SymbolIndex::shared(4242, mods), first);
+        QVERIFY(SymbolIndex::shared(4243, mods) != first);
+        mods.append({"b.so", 0x4000, 0x1000, {}});
+        auto changed = SymbolIndex::shared(4242, mods);
+        QVERIFY(changed != first);
+        QCOMPARE(changed->modules().size(), 2);
+    }
+
     // ---------------------------------------------------------------
     // Polymorphism -- unique_ptr<Provider> usage
     // ---------------------------------------------------------------
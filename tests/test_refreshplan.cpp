@@ -0,0 +1,113 @@
+#include <QTest>
+#include "refreshplan.h"
+
+using namespace rcx;
+
+// Root at 0x10000: a UInt32 at 0, a UInt64 straddling the first page
+// boundary, and a Hex8 three pages in
+class TestRefreshPlan : public QObject {
+    Q_OBJECT
+
+private:
+    static constexpr int64_t kPage = 4096;
+    NodeTree m_tree;
+
+    int addField(NodeKind kind, uint64_t parentId, int offset) {
+        Node n;
+        n.kind = kind;
+        n.parentId = parentId;
+        n.offset = offset;
+        return m_tree.addNode(n);
+    }
+
+    LineMeta line(int nodeIdx) const {
+        LineMeta lm;
+        lm.nodeIdx = nodeIdx;
+        lm.nodeId = m_tree.nodes[nodeIdx].id;
+        lm.offsetAddr = m_tree.baseAddress + uint64_t(m_tree.computeOffset(nodeIdx));
+        return lm;
+    }
+
+private slots:
+    void init() {
+        m_tree = NodeTree();
+        m_tree.baseAddress = 0x10000;
+        Node root;
+        root.kind = NodeKind::Struct;
+        root.name = "Root";
+        uint64_t rootId = m_tree.nodes[m_tree.addNode(root)].id;
+        addField(NodeKind::UInt32, rootId, 0);
+        addField(NodeKind::UInt64, rootId, int(kPage) - 4);
+        addField(NodeKind::Hex8, rootId, int(kPage) * 3);
+    }
+
+    void testWithoutLayoutCoversMainStruct() {
+        RefreshPlan plan = planRefresh(m_tree, {}, ComposeWindow(), 0, kPage);
+        QCOMPARE(plan.extent, int(kPage) * 3 + 1);
+        QCOMPARE(plan.wanted, (QVector<uint64_t>{0x10000, 0x11000, 0x12000, 0x13000}));
+        QVERIFY(plan.visible.isEmpty());
+    }
+
+    void testLinesGivePagesAndVisibleSubset() {
+        LineMeta header = line(0);
+        header.lineKind = LineKind::Header;     // a struct header shows no bytes
+        QVector<LineMeta> meta{header, line(1), line(2), line(3)};
+        ComposeWindow window;
+        window.add(3, 3);
+        RefreshPlan plan = planRefresh(m_tree, meta, window, 0, kPage);
+        // The gap page at 0x12000 is covered by no line
+        QCOMPARE(plan.wanted, (QVector<uint64_t>{0x10000, 0x11000, 0x13000}));
+        QCOMPARE(plan.visible, QVector<uint64_t>{0x13000});
+
+        // A full window shows everything: no visible subset
+        plan = planRefresh(m_tree, meta, ComposeWindow(), 0, kPage);
+        QVERIFY(plan.visible.isEmpty());
+    }
+
+    void testNullPointerExpansionReadsNothing() {
+        // A Ptr64 at +0x10 expanded onto a null target: its children sit at
+        // base 0, one of them (a nested header) without nullValues set
+        Node ptr;
+        ptr.kind = NodeKind::Pointer64;
+        ptr.parentId = m_tree.nodes[0].id;
+        ptr.offset = 0x10;
+        int ptrIdx = m_tree.addNode(ptr);
+        LineMeta header = line(ptrIdx);
+        header.lineKind = LineKind::Header;
+        header.foldHead = true;
+        header.nodeKind = NodeKind::Pointer64;
+        header.ptrTarget = 0;
+        LineMeta nullField = line(1);
+        nullField.depth = 1;
+        nullField.offsetAddr = 0;
+        nullField.nullValues = true;
+        LineMeta nested = line(2);
+        nested.depth = 1;
+        nested.offsetAddr = 0x2000;
+        LineMeta after = line(3);
+
+        QVector<LineMeta> meta{line(0), header, nullField, nested, after};
+        RefreshPlan plan = planRefresh(m_tree, meta, ComposeWindow(), 0, kPage);
+        QVERIFY(!plan.wanted.contains(0));
+        QVERIFY(!plan.wanted.contains(0x2000));
+        // The pointer's own bytes and the lines after the expansion stay
+        QCOMPARE(plan.wanted, (QVector<uint64_t>{0x10000, 0x13000}));
+    }
+
+    void testMainDataExtent() {
+        QCOMPARE(mainDataExtent(m_tree, 100), int(kPage) * 3 + 1);
+        QCOMPARE(mainDataExtent(NodeTree(), 100), 100);
+        QCOMPARE(mainDataExtent(NodeTree(), 0), 0);
+
+        Node big;
+        big.kind = NodeKind::Array;
+        big.elementKind = NodeKind::UInt64;
+        big.arrayLen = 4000000;
+        NodeTree huge;
+        huge.addNode(big);
+        QCOMPARE(mainDataExtent(huge, 0), 16 * 1024 * 1024);
+    }
+};
+
+QTEST_MAIN(TestRefreshPlan)
+#include "test_refreshplan.moc"
@@ -0,0 +1,163 @@
+#include <QTest>
+#include "refreshscheduler.h"
+
+using namespace rcx;
+
+class TestRefreshScheduler : public QObject {
+    Q_OBJECT
+
+private:
+    static QVector<uint64_t> pages(int n, uint64_t base = 0x10000) {
+        QVector<uint64_t> v;
+        for (int i = 0; i < n; ++i)
+            v.append(base + uint64_t(i) * RefreshScheduler::kPageSize);
+        return v;
+    }
+
+private slots:
+
+    void testNewPagesAlwaysFetched() {
+        RefreshScheduler s;
+        s.setBaseInterval(100);
+        s.setBudget(RefreshScheduler::kPageSize);     // one page per second
+        QVector<uint64_t> wanted = pages(16);
+        QCOMPARE(s.plan(wanted, 0), wanted);
+        // Nothing is due until the base interval has passed
+        QVERIFY(s.plan(wanted, 50).isEmpty());
+        QCOMPARE(s.nextDueMs(50), int64_t(100));
+    }
+
+    void testStaticPagesBackOff() {
+        RefreshScheduler s;
+        s.setBaseInterval(100);
+        const uint64_t page = 0x1000;
+        int64_t now = 0;
+        s.plan({page}, now);
+        int expected = 100;
+        for (int i = 0; i < 10; ++i) {
+            s.record(page, false, now);
+            expected = qMin(expected * 2, s.maxInterval());
+            QCOMPARE(s.intervalOf(page), expected);
+            now += expected;
+            QCOMPARE(s.plan({page}, now), QVector<uint64_t>{page});
+        }
+        QCOMPARE(s.intervalOf(page), 100 * RefreshScheduler::kMaxBackoff);
+    }
+
+    void testHotPagesSpeedUp() {
+        RefreshScheduler s;
+        s.setBaseInterval(1000);
+        const uint64_t hot = 0x1000, cold = 0x2000;
+        s.plan({hot, cold}, 0);
+        for (int i = 0; i < 10; ++i) {
+            s.record(hot, true, 0);
+            s.record(cold, false, 0);
+        }
+        QCOMPARE(s.intervalOf(hot), RefreshScheduler::kMinIntervalMs);
+        QCOMPARE(s.intervalOf(cold), s.maxInterval());
+        QCOMPARE(s.plan({hot, cold}, RefreshScheduler::kMinIntervalMs),
+                 QVector<uint64_t>{hot});
+    }
+
+    void testBudgetLimitsDuePages() {
+        RefreshScheduler s;
+        s.setBaseInterval(100);
+        s.setBudget(4 * RefreshScheduler::kPageSize); // four pages per second
+        QVector<uint64_t> wanted = pages(16);
+        s.plan(wanted, 0);
+        // Only what the bucket holds after one second goes out at once
+        QCOMPARE(s.plan(wanted, 1000).size(), 4);
+        QVERIFY(s.plan(wanted, 1000).isEmpty());
+        QVERIFY(s.nextDueMs(1000) > 1000);
+        QCOMPARE(s.plan(wanted, 1250).size(), 1);
+    }
+
+    void testMostOverdueFirst() {
+        RefreshScheduler s;
+        s.setBaseInterval(100);
+        s.setBudget(RefreshScheduler::kPageSize);
+        const uint64_t a = 0x1000, b = 0x2000;
+        s.plan({a, b}, 0);
+        s.record(a, false, 0);      // due at 200
+        s.record(b, true, 0);       // due at 50
+        QCOMPARE(s.plan({a, b}, 1000), QVector<uint64_t>{b});
+    }
+
+    void testOffscreenPagesWaitForBudget() {
+        RefreshScheduler s;
+        s.setBaseInterval(100);
+        s.setBudget(2 * RefreshScheduler::kPageSize);
+        QVector<uint64_t> wanted = pages(8);
+        QVector<uint64_t> visible = wanted.mid(6);
+        // Visible pages are free the first time; two off-screen pages fit
+        QVector<uint64_t> first = s.plan(wanted, 0, visible);
+        QCOMPARE(first.size(), 4);
+        QVERIFY(first.contains(visible[0]) && first.contains(visible[1]));
+        QVERIFY(s.plan(wanted, 0, visible).isEmpty());
+        QVERIFY(s.nextDueMs(0) > 0);
+    }
+
+    void testOffscreenPagesPollSlower() {
+        RefreshScheduler s;
+        s.setBaseInterval(100);
+        const uint64_t a = 0x1000, b = 0x2000;
+        QCOMPARE(s.plan({a, b}, 0, {a}), (QVector<uint64_t>{a, b}));
+        QCOMPARE(s.plan({a, b}, 100, {a}), QVector<uint64_t>{a});
+        QVERIFY(s.plan({a, b}, 200, {a}) == QVector<uint64_t>{a});
+        QCOMPARE(s.nextDueMs(200), int64_t(300));
+        QCOMPARE(s.plan({a, b}, 400, {a}), (QVector<uint64_t>{a, b}));
+    }
+
+    void testScrolledIntoViewUsesOwnInterval() {
+        RefreshScheduler s;
+        s.setBaseInterval(100);
+        const uint64_t a = 0x1000, b = 0x2000;
+        s.plan({a, b}, 0, {a});
+        QVERIFY(s.plan({a, b}, 150, {a}) == QVector<uint64_t>{a});
+        // b is not due off-screen until 400, but on screen it is overdue
+        QCOMPARE(s.plan({a, b}, 160, {b}), QVector<uint64_t>{b});
+    }
+
+    void testUnwantedPagesForgotten() {
+        RefreshScheduler s;
+        s.setBaseInterval(100);
+        s.plan({0x1000, 0x2000}, 0);
+        s.record(0x1000, false, 0);
+        s.plan({0x2000}, 10);
+        QCOMPARE(s.intervalOf(0x1000), 0);
+        // Coming back counts as a new page
+        QCOMPARE(s.plan({0x1000, 0x2000}, 20), QVector<uint64_t>{0x1000});
+        QCOMPARE(s.intervalOf(0x1000), 100);
+    }
+
+    void testClearResets() {
+        RefreshScheduler s;
+        s.setBaseInterval(100);
+        s.plan(pages(4), 0);
+        s.clear();
+        QCOMPARE(s.intervalOf(0x10000), 0);
+        QCOMPARE(s.plan(pages(4), 1), pages(4));
+    }
+
+    void testForkJoinKeepsWake() {
+        RefreshScheduler s;
+        s.setBaseInterval(100);
+        RefreshScheduler worker = s.fork();
+        QCOMPARE(worker.plan(pages(4), 0), pages(4));
+        s.join(std::move(worker));
+        QCOMPARE(s.intervalOf(0x10000), 100);
+        QCOMPARE(s.nextDueMs(0), int64_t(100));
+
+        // A wake while the worker plans survives the join
+        worker = s.fork();
+        s.wake();
+        QVERIFY(worker.plan(pages(4), 50).isEmpty());
+        s.join(std::move(worker));
+        QCOMPARE(s.nextDueMs(50), int64_t(0));
+        QVERIFY(s.plan(pages(4), 60).isEmpty());
+        QCOMPARE(s.nextDueMs(60), int64_t(100));
+    }
+};
+
+QTEST_MAIN(TestRefreshScheduler)
+#include "test_refreshscheduler.moc"
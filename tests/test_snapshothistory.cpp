@@ -0,0 +1,125 @@
+#include <QTest>
+#include <cstring>
+#include "providers/snapshot_history.h"
+
+using namespace rcx;
+
+class TestSnapshotHistory : public QObject {
+    Q_OBJECT
+
+private:
+    static constexpr int kPage = PagePool::kPageSize;
+
+    // A hashed page table, as a refresh read hands it over
+    static PageTable table(const QVector<QPair<uint64_t, QByteArray>>& pages) {
+        PageTable t;
+        for (const auto& p : pages) {
+            PageBuf buf = PageBuf::fromBytes(p.second);
+            uint64_t h = SnapshotProvider::pageHash(buf);
+            t.insert(p.first, std::move(buf), h);
+        }
+        return t;
+    }
+
+    static QByteArray bytesOf(const PageTable& t, uint64_t addr) {
+        const PageBuf* p = t.find(addr);
+        return p ? QByteArray(p->constData(), p->size()) : QByteArray();
+    }
+
+private slots:
+    void testReconstructsEveryFrame() {
+        SnapshotHistory h;
+        QByteArray a(kPage, 'a'), b(kPage, 'b'), c(kPage, 'c');
+        QVector<PageTable> expected;
+        for (int i = 0; i < 80; ++i) {
+            a[i % kPage] = char(i);                       // a few bytes: runs
+            if (i % 7 == 0) b.fill(char('b' + i));        // whole page
+            QVector<QPair<uint64_t, QByteArray>> pages{{0x1000, a}, {0x2000, b}};
+            if (i >= 40) pages.append({0x3000, c});       // appears mid-group
+            expected.append(table(pages));
+            h.record(expected.last(), i * 100);
+        }
+        QCOMPARE(h.size(), 80);
+        QVERIFY(h.groupCount() > 2);
+        for (int i = 0; i < h.size(); ++i) {
+            PageTable got = h.pagesAt(i);
+            QCOMPARE(got.size(), expected[i].size());
+            for (auto it = expected[i].constBegin(); it != expected[i].constEnd(); ++it)
+                QCOMPARE(bytesOf(got, it.key()), bytesOf(expected[i], it.key()));
+            QCOMPARE(h.timeOf(i), int64_t(i * 100));
+        }
+        QVERIFY(h.pagesAt(80).isEmpty());
+    }
+
+    void testDroppedPagesStayDropped() {
+        SnapshotHistory h;
+        QByteArray a(kPage, 'a'), b(kPage, 'b');
+        h.record(table({{0x1000, a}, {0x2000, b}}), 0);     // keyframe
+        h.record(table({{0x1000, a}}), 1);                  // 0x2000 unmapped
+        h.record(table({{0x2000, b}}), 2);                  // and back, 0x1000 gone
+        QCOMPARE(h.groupCount(), 1);
+
+        PageTable one = h.pagesAt(1);
+        QCOMPARE(one.size(), 1);
+        QVERIFY(one.contains(0x1000));
+        QVERIFY(!one.contains(0x2000));
+        PageTable two = h.pagesAt(2);
+        QCOMPARE(two.size(), 1);
+        QCOMPARE(bytesOf(two, 0x2000), b);
+        QVERIFY(!two.contains(0x1000));
+    }
+
+    void testSmallChangesStoredAsRuns() {
+        SnapshotHistory h;
+        QByteArray page(kPage, '\0');
+        for (int i = 0; i < SnapshotHistory::kKeyframeInterval; ++i) {
+            page[100] = char(i);
+            h.record(table({{0x1000, page}}), i);
+        }
+        QCOMPARE(h.groupCount(), 1);
+        // One keyframe page plus a few bytes per frame, far below a page each
+        QVERIFY(h.bytesUsed() < 3 * kPage);
+    }
+
+    void testIdenticalPagesShared() {
+        SnapshotHistory h;
+        QByteArray same(kPage, 'x');
+        h.record(table({{0x1000, same}, {0x2000, same}}), 0);
+        QCOMPARE(h.bytesUsed() / kPage, int64_t(1));
+
+        PageTable t = h.pagesAt(0);
+        QVERIFY(t.find(0x1000)->constData() == t.find(0x2000)->constData());
+        // A page flipping back to an earlier value reuses the stored copy
+        QByteArray other(kPage, 'y');
+        h.record(table({{0x1000, other}, {0x2000, same}}), 1);
+        h.record(table({{0x1000, same}, {0x2000, same}}), 2);
+        QCOMPARE(h.bytesUsed() / kPage, int64_t(2));
+    }
+
+    void testBudgetDropsOldestGroup() {
+        SnapshotHistory h;
+        h.setBudget(64 * kPage);
+        int dropped = 0;
+        for (int i = 0; i < 200; ++i)
+            dropped += h.record(table({{0x1000, QByteArray(kPage, char(i))}}), i);
+        QVERIFY(dropped > 0);
+        QCOMPARE(h.size(), 200 - dropped);
+        QVERIFY(h.bytesUsed() <= h.budget());
+        // Whole groups go: the oldest frame left is a keyframe
+        QCOMPARE(dropped % SnapshotHistory::kKeyframeInterval, 0);
+        QCOMPARE(h.timeOf(0), int64_t(dropped));
+        QCOMPARE(bytesOf(h.pagesAt(h.size() - 1), 0x1000), QByteArray(kPage, char(199)));
+    }
+
+    void testClear() {
+        SnapshotHistory h;
+        h.record(table({{0x1000, QByteArray(kPage, 'a')}}), 0);
+        h.clear();
+        QVERIFY(h.isEmpty());
+        QCOMPARE(h.bytesUsed(), int64_t(0));
+        QVERIFY(h.pagesAt(0).isEmpty());
+    }
+};
+
+QTEST_MAIN(TestSnapshotHistory)
+#include "test_snapshothistory.moc"